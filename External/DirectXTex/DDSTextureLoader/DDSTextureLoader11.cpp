@@ -144,6 +144,35 @@ namespace
 
     inline HANDLE safe_handle(HANDLE h) noexcept { return (h == INVALID_HANDLE_VALUE) ? nullptr : h; }
 
+    //--------------------------------------------------------------------------------------
+    // Reads large files in bounded pieces since ReadFile takes a 32-bit length
+    //--------------------------------------------------------------------------------------
+    constexpr size_t FILE_READ_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    HRESULT ReadFileChunked(_In_ HANDLE hFile, _Out_writes_bytes_(size) void* buffer, size_t size) noexcept
+    {
+        auto ptr = static_cast<uint8_t*>(buffer);
+        while (size > 0)
+        {
+            const auto bytesToRead = static_cast<DWORD>(std::min<size_t>(size, FILE_READ_CHUNK_SIZE));
+            DWORD bytesRead = 0;
+            if (!ReadFile(hFile, ptr, bytesToRead, &bytesRead, nullptr))
+            {
+                return HRESULT_FROM_WIN32(GetLastError());
+            }
+
+            if (bytesRead != bytesToRead)
+            {
+                return E_FAIL;
+            }
+
+            ptr += bytesRead;
+            size -= bytesRead;
+        }
+
+        return S_OK;
+    }
+
     #if defined(_DEBUG) || defined(PROFILE)
     template<UINT TNameLength>
     inline void SetDebugObjectName(_In_ ID3D11DeviceChild* resource, _In_ const char(&name)[TNameLength]) noexcept
@@ -172,11 +201,6 @@ namespace
 
         *bitSize = 0;
 
-        if (ddsDataSize > UINT32_MAX)
-        {
-            return E_FAIL;
-        }
-
         if (ddsDataSize < DDS_MIN_HEADER_SIZE)
         {
             return E_FAIL;
@@ -255,42 +279,33 @@ namespace
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        // File is too big for 32-bit allocation, so reject read
-        if (fileInfo.EndOfFile.HighPart > 0)
+        // File is too big for the address space of this build, so reject read
+        if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
         {
             return E_FAIL;
         }
 
+        const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
+
         // Need at least enough data to fill the header and magic number to be a valid DDS
-        if (fileInfo.EndOfFile.LowPart < DDS_MIN_HEADER_SIZE)
+        if (len < DDS_MIN_HEADER_SIZE)
         {
             return E_FAIL;
         }
 
         // create enough space for the file data
-        ddsData.reset(new (std::nothrow) uint8_t[fileInfo.EndOfFile.LowPart]);
+        ddsData.reset(new (std::nothrow) uint8_t[len]);
         if (!ddsData)
         {
             return E_OUTOFMEMORY;
         }
 
         // read the data in
-        DWORD bytesRead = 0;
-        if (!ReadFile(hFile.get(),
-            ddsData.get(),
-            fileInfo.EndOfFile.LowPart,
-            &bytesRead,
-            nullptr
-        ))
+        const HRESULT hr = ReadFileChunked(hFile.get(), ddsData.get(), len);
+        if (FAILED(hr))
         {
             ddsData.reset();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead < fileInfo.EndOfFile.LowPart)
-        {
-            ddsData.reset();
-            return E_FAIL;
+            return hr;
         }
 
         // DDS files always start with the same magic number ("DDS ")
@@ -317,7 +332,7 @@ namespace
             (MAKEFOURCC('D', 'X', '1', '0') == hdr->ddspf.fourCC))
         {
             // Must be long enough for both headers and magic value
-            if (fileInfo.EndOfFile.LowPart < DDS_DX10_HEADER_SIZE)
+            if (len < DDS_DX10_HEADER_SIZE)
             {
                 ddsData.reset();
                 return E_FAIL;
@@ -331,7 +346,7 @@ namespace
         auto offset = DDS_MIN_HEADER_SIZE
             + (bDXT10Header ? sizeof(DDS_HEADER_DXT10) : 0u);
         *bitData = ddsData.get() + offset;
-        *bitSize = fileInfo.EndOfFile.LowPart - offset;
+        *bitSize = len - offset;
 
         return S_OK;
     }
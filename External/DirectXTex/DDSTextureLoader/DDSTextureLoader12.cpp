@@ -172,6 +172,52 @@ namespace
     using ScopedHandle = std::unique_ptr<void, handle_closer>;
 
     inline HANDLE safe_handle(HANDLE h) noexcept { return (h == INVALID_HANDLE_VALUE) ? nullptr : h; }
+
+    //--------------------------------------------------------------------------------------
+    // Reads large files in bounded pieces since ReadFile takes a 32-bit length
+    //--------------------------------------------------------------------------------------
+    constexpr size_t FILE_READ_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    HRESULT ReadFileChunked(_In_ HANDLE hFile, _Out_writes_bytes_(size) void* buffer, size_t size) noexcept
+    {
+        auto ptr = static_cast<uint8_t*>(buffer);
+        while (size > 0)
+        {
+            const auto bytesToRead = static_cast<DWORD>(std::min<size_t>(size, FILE_READ_CHUNK_SIZE));
+            DWORD bytesRead = 0;
+            if (!ReadFile(hFile, ptr, bytesToRead, &bytesRead, nullptr))
+            {
+                return HRESULT_FROM_WIN32(GetLastError());
+            }
+
+            if (bytesRead != bytesToRead)
+            {
+                return E_FAIL;
+            }
+
+            ptr += bytesRead;
+            size -= bytesRead;
+        }
+
+        return S_OK;
+    }
+#else
+    HRESULT ReadFileChunked(std::ifstream& inFile, _Out_writes_bytes_(size) void* buffer, size_t size) noexcept
+    {
+        auto ptr = static_cast<char*>(buffer);
+        while (size > 0)
+        {
+            const auto bytesToRead = std::min<size_t>(size, FILE_READ_CHUNK_SIZE);
+            inFile.read(ptr, static_cast<std::streamsize>(bytesToRead));
+            if (!inFile)
+                return E_FAIL;
+
+            ptr += bytesToRead;
+            size -= bytesToRead;
+        }
+
+        return S_OK;
+    }
 #endif
 
     #if !defined(NO_D3D12_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
@@ -218,11 +264,6 @@ namespace
 
         *bitSize = 0;
 
-        if (ddsDataSize > UINT32_MAX)
-        {
-            return E_FAIL;
-        }
-
         if (ddsDataSize < DDS_MIN_HEADER_SIZE)
         {
             return E_FAIL;
@@ -303,46 +344,35 @@ namespace
             return HRESULT_FROM_WIN32(GetLastError());
         }
 
-        // File is too big for 32-bit allocation, so reject read
-        if (fileInfo.EndOfFile.HighPart > 0)
+        // File is too big for the address space of this build, so reject read
+        if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
         {
             return E_FAIL;
         }
 
+        const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
+
         // Need at least enough data to fill the header and magic number to be a valid DDS
-        if (fileInfo.EndOfFile.LowPart < DDS_MIN_HEADER_SIZE)
+        if (len < DDS_MIN_HEADER_SIZE)
         {
             return E_FAIL;
         }
 
         // create enough space for the file data
-        ddsData.reset(new (std::nothrow) uint8_t[fileInfo.EndOfFile.LowPart]);
+        ddsData.reset(new (std::nothrow) uint8_t[len]);
         if (!ddsData)
         {
             return E_OUTOFMEMORY;
         }
 
         // read the data in
-        DWORD bytesRead = 0;
-        if (!ReadFile(hFile.get(),
-            ddsData.get(),
-            fileInfo.EndOfFile.LowPart,
-            &bytesRead,
-            nullptr
-        ))
-        {
-            ddsData.reset();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead < fileInfo.EndOfFile.LowPart)
+        const HRESULT hr = ReadFileChunked(hFile.get(), ddsData.get(), len);
+        if (FAILED(hr))
         {
             ddsData.reset();
-            return E_FAIL;
+            return hr;
         }
 
-        size_t len = fileInfo.EndOfFile.LowPart;
-
     #else // !WIN32
         std::ifstream inFile(std::filesystem::path(fileName), std::ios::in | std::ios::binary | std::ios::ate);
         if (!inFile)
@@ -352,11 +382,16 @@ namespace
         if (!inFile)
             return E_FAIL;
 
+        if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
+            return E_FAIL;
+
+        const auto len = static_cast<size_t>(fileLen);
+
         // Need at least enough data to fill the header and magic number to be a valid DDS
-        if (fileLen < DDS_MIN_HEADER_SIZE)
+        if (len < DDS_MIN_HEADER_SIZE)
             return E_FAIL;
 
-        ddsData.reset(new (std::nothrow) uint8_t[size_t(fileLen)]);
+        ddsData.reset(new (std::nothrow) uint8_t[len]);
         if (!ddsData)
             return E_OUTOFMEMORY;
 
@@ -367,16 +402,14 @@ namespace
             return E_FAIL;
         }
 
-        inFile.read(reinterpret_cast<char*>(ddsData.get()), fileLen);
-        if (!inFile)
+        const HRESULT hr = ReadFileChunked(inFile, ddsData.get(), len);
+        if (FAILED(hr))
         {
             ddsData.reset();
-            return E_FAIL;
+            return hr;
         }
 
         inFile.close();
-
-        size_t len = fileLen;
     #endif
 
         // DDS files always start with the same magic number ("DDS ")
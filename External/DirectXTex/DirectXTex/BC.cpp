@@ -314,6 +314,292 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Cluster fit: orders the points along the principal axis, then tries every split of
+    // that ordering into palette entries and solves the least-squares endpoints for each.
+    // Slower than OptimizeRGB, but finds the best endpoints for the chosen axis ordering.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_ClusterFitIterations = 4;
+
+    void OptimizeRGBClusterFit(
+        _Out_ HDRColorA *pX,
+        _Out_ HDRColorA *pY,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pPoints,
+        uint32_t cSteps,
+        uint32_t flags) noexcept
+    {
+        static const XMVECTORF32 s_Grid = { { { 31.f, 63.f, 31.f, 0.f } } };
+        static const XMVECTORF32 s_GridInv = { { { 1.f / 31.f, 1.f / 63.f, 1.f / 31.f, 0.f } } };
+
+        const XMVECTOR vWeight = (flags & BC_FLAGS_UNIFORM) ? g_XMOne3 : XMVectorSet(g_Luminance.r, g_Luminance.g, g_Luminance.b, 0.f);
+        const XMVECTOR vWeightInv = (flags & BC_FLAGS_UNIFORM) ? g_XMOne3 : XMVectorSet(g_LuminanceInv.r, g_LuminanceInv.g, g_LuminanceInv.b, 0.f);
+
+        XMVECTOR vPoints[NUM_PIXELS_PER_BLOCK];
+        XMVECTOR vCentroid = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            vPoints[i] = XMVectorSet(pPoints[i].r, pPoints[i].g, pPoints[i].b, 0.f);
+            vCentroid = XMVectorAdd(vCentroid, vPoints[i]);
+        }
+        vCentroid = XMVectorScale(vCentroid, 1.f / float(NUM_PIXELS_PER_BLOCK));
+
+        // Covariance rows, then power iteration for the principal axis
+        XMVECTOR vCovR = XMVectorZero();
+        XMVECTOR vCovG = XMVectorZero();
+        XMVECTOR vCovB = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR d = XMVectorSubtract(vPoints[i], vCentroid);
+            vCovR = XMVectorMultiplyAdd(d, XMVectorSplatX(d), vCovR);
+            vCovG = XMVectorMultiplyAdd(d, XMVectorSplatY(d), vCovG);
+            vCovB = XMVectorMultiplyAdd(d, XMVectorSplatZ(d), vCovB);
+        }
+
+        XMVECTOR vAxis = g_XMOne3;
+        for (size_t iIteration = 0; iIteration < 8; ++iIteration)
+        {
+            vAxis = XMVectorMultiplyAdd(vCovR, XMVectorSplatX(vAxis),
+                XMVectorMultiplyAdd(vCovG, XMVectorSplatY(vAxis), XMVectorMultiply(vCovB, XMVectorSplatZ(vAxis))));
+
+            const float fLenSq = XMVectorGetX(XMVector3LengthSq(vAxis));
+            if (fLenSq < FLT_MIN)
+                break;
+            vAxis = XMVector3Normalize(vAxis);
+        }
+
+        if (XMVector3Less(XMVector3LengthSq(vAxis), XMVectorReplicate(FLT_MIN)))
+        {
+            // No dominant direction (single color or nearly so)
+            OptimizeRGB(pX, pY, pPoints, cSteps, flags);
+            return;
+        }
+
+        // Palette weights for endpoint X; endpoint Y gets (1 - weight)
+        const float fHalf = (3 == cSteps) ? 0.5f : (2.0f / 3.0f);
+
+        const XMVECTOR vTotal = XMVectorScale(vCentroid, float(NUM_PIXELS_PER_BLOCK));
+
+        float fBestError = FLT_MAX;
+        XMVECTOR vBestX = XMVectorZero();
+        XMVECTOR vBestY = XMVectorZero();
+
+        size_t auOrder[NUM_PIXELS_PER_BLOCK] = {};
+        size_t auPrevOrder[NUM_PIXELS_PER_BLOCK] = {};
+
+        for (size_t iIteration = 0; iIteration < c_ClusterFitIterations; ++iIteration)
+        {
+            float afDot[NUM_PIXELS_PER_BLOCK];
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+            {
+                afDot[i] = XMVectorGetX(XMVector3Dot(vPoints[i], vAxis));
+                auOrder[i] = i;
+            }
+
+            std::stable_sort(std::begin(auOrder), std::end(auOrder),
+                [&](size_t a, size_t b) noexcept { return afDot[a] > afDot[b]; });
+
+            if (iIteration > 0 && std::equal(std::begin(auOrder), std::end(auOrder), std::begin(auPrevOrder)))
+                break;
+            std::copy(std::begin(auOrder), std::end(auOrder), std::begin(auPrevOrder));
+
+            XMVECTOR vSorted[NUM_PIXELS_PER_BLOCK];
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                vSorted[i] = vPoints[auOrder[i]];
+
+            const float fPrevError = fBestError;
+
+            // c0 points use X, c1 the 'near X' entry, c2 the 'near Y' entry (4 color only), the rest Y
+            const size_t uMaxC2 = (3 == cSteps) ? 0 : NUM_PIXELS_PER_BLOCK;
+
+            XMVECTOR vSum0 = XMVectorZero();
+            for (size_t c0 = 0; c0 <= NUM_PIXELS_PER_BLOCK; ++c0)
+            {
+                XMVECTOR vSum1 = XMVectorZero();
+                for (size_t c1 = 0; c0 + c1 <= NUM_PIXELS_PER_BLOCK; ++c1)
+                {
+                    XMVECTOR vSum2 = XMVectorZero();
+                    for (size_t c2 = 0; c2 <= uMaxC2 && c0 + c1 + c2 <= NUM_PIXELS_PER_BLOCK; ++c2)
+                    {
+                        const float f0 = float(c0);
+                        const float f1 = float(c1);
+                        const float f2 = float(c2);
+                        const float f3 = float(NUM_PIXELS_PER_BLOCK - c0 - c1 - c2);
+
+                        const float fNear = fHalf;
+                        const float fFar = 1.0f - fHalf;
+
+                        const float fAlpha2 = f0 + f1 * fNear * fNear + f2 * fFar * fFar;
+                        const float fBeta2 = f3 + f1 * fFar * fFar + f2 * fNear * fNear;
+                        const float fAlphaBeta = (f1 + f2) * fNear * fFar;
+
+                        const float fDenom = fAlpha2 * fBeta2 - fAlphaBeta * fAlphaBeta;
+                        if (fDenom > FLT_EPSILON)
+                        {
+                            const XMVECTOR vAlphaX = XMVectorMultiplyAdd(vSum1, XMVectorReplicate(fNear),
+                                XMVectorMultiplyAdd(vSum2, XMVectorReplicate(fFar), vSum0));
+                            const XMVECTOR vBetaX = XMVectorSubtract(vTotal, vAlphaX);
+
+                            const float fFactor = 1.0f / fDenom;
+
+                            XMVECTOR a = XMVectorScale(XMVectorSubtract(XMVectorScale(vAlphaX, fBeta2), XMVectorScale(vBetaX, fAlphaBeta)), fFactor);
+                            XMVECTOR b = XMVectorScale(XMVectorSubtract(XMVectorScale(vBetaX, fAlpha2), XMVectorScale(vAlphaX, fAlphaBeta)), fFactor);
+
+                            // Snap to the 5:6:5 grid in unweighted space
+                            a = XMVectorMultiply(XMVectorMultiply(XMVectorRound(XMVectorMultiply(XMVectorSaturate(XMVectorMultiply(a, vWeightInv)), s_Grid)), s_GridInv), vWeight);
+                            b = XMVectorMultiply(XMVectorMultiply(XMVectorRound(XMVectorMultiply(XMVectorSaturate(XMVectorMultiply(b, vWeightInv)), s_Grid)), s_GridInv), vWeight);
+
+                            // Squared error less the constant sum of the squared points
+                            XMVECTOR e = XMVectorMultiply(XMVectorMultiply(a, a), XMVectorReplicate(fAlpha2));
+                            e = XMVectorMultiplyAdd(XMVectorMultiply(b, b), XMVectorReplicate(fBeta2), e);
+                            e = XMVectorMultiplyAdd(XMVectorMultiply(a, b), XMVectorReplicate(2.0f * fAlphaBeta), e);
+                            e = XMVectorNegativeMultiplySubtract(XMVectorAdd(a, a), vAlphaX, e);
+                            e = XMVectorNegativeMultiplySubtract(XMVectorAdd(b, b), vBetaX, e);
+
+                            const float fError = XMVectorGetX(XMVector3Dot(e, g_XMOne3));
+                            if (fError < fBestError)
+                            {
+                                fBestError = fError;
+                                vBestX = a;
+                                vBestY = b;
+                            }
+                        }
+
+                        if (c0 + c1 + c2 < NUM_PIXELS_PER_BLOCK)
+                            vSum2 = XMVectorAdd(vSum2, vSorted[c0 + c1 + c2]);
+                    }
+
+                    if (c0 + c1 < NUM_PIXELS_PER_BLOCK)
+                        vSum1 = XMVectorAdd(vSum1, vSorted[c0 + c1]);
+                }
+
+                if (c0 < NUM_PIXELS_PER_BLOCK)
+                    vSum0 = XMVectorAdd(vSum0, vSorted[c0]);
+            }
+
+            if (!(fBestError < fPrevError))
+                break;
+
+            // Refine the ordering along the axis of the best endpoints
+            vAxis = XMVectorSubtract(vBestX, vBestY);
+            if (XMVector3Less(XMVector3LengthSq(vAxis), XMVectorReplicate(FLT_MIN)))
+                break;
+        }
+
+        if (fBestError == FLT_MAX)
+        {
+            OptimizeRGB(pX, pY, pPoints, cSteps, flags);
+            return;
+        }
+
+        pX->r = XMVectorGetX(vBestX); pX->g = XMVectorGetY(vBestX); pX->b = XMVectorGetZ(vBestX); pX->a = 1.0f;
+        pY->r = XMVectorGetX(vBestY); pY->g = XMVectorGetY(vBestY); pY->b = XMVectorGetZ(vBestY); pY->a = 1.0f;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Single color blocks: for each 8-bit value, the 5 or 6 bit endpoint pair whose 1/3
+    // interpolant (index 2 in four color mode) lands closest to it. This represents flat
+    // colors far more precisely than rounding to a single 5:6:5 endpoint.
+    //-------------------------------------------------------------------------------------
+    struct SingleColorEntry
+    {
+        uint8_t e0;
+        uint8_t e1;
+    };
+
+    struct SingleColorTables
+    {
+        SingleColorEntry c5[256];
+        SingleColorEntry c6[256];
+
+        SingleColorTables() noexcept
+        {
+            Build(c5, 31);
+            Build(c6, 63);
+        }
+
+        static void Build(_Out_writes_(256) SingleColorEntry* table, int maxValue) noexcept
+        {
+            for (int v = 0; v < 256; ++v)
+            {
+                float fBest = FLT_MAX;
+                table[v].e0 = table[v].e1 = 0;
+
+                for (int e0 = 0; e0 <= maxValue; ++e0)
+                {
+                    const float c0 = static_cast<float>(e0) / static_cast<float>(maxValue);
+                    for (int e1 = 0; e1 <= maxValue; ++e1)
+                    {
+                        const float c1 = static_cast<float>(e1) / static_cast<float>(maxValue);
+                        const float fErr = fabsf((c0 + (c1 - c0) * (1.0f / 3.0f)) * 255.0f - static_cast<float>(v));
+                        if (fErr < fBest)
+                        {
+                            fBest = fErr;
+                            table[v].e0 = static_cast<uint8_t>(e0);
+                            table[v].e1 = static_cast<uint8_t>(e1);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    const SingleColorTables& GetSingleColorTables() noexcept
+    {
+        static const SingleColorTables s_tables;
+        return s_tables;
+    }
+
+    inline bool IsSingleColor(_In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA *pColor) noexcept
+    {
+        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (pColor[i].r != pColor[0].r || pColor[i].g != pColor[0].g || pColor[i].b != pColor[0].b)
+                return false;
+        }
+        return true;
+    }
+
+    void EncodeSingleColorBC1(_Out_ D3DX_BC1 *pBC, _In_ const HDRColorA& color) noexcept
+    {
+        const SingleColorTables& tables = GetSingleColorTables();
+
+        auto toByte = [](float f) noexcept -> size_t
+            {
+                f = (f < 0.0f) ? 0.0f : (f > 1.0f) ? 1.0f : f;
+                return static_cast<size_t>(static_cast<int32_t>(f * 255.0f + 0.5f));
+            };
+
+        const SingleColorEntry& r = tables.c5[toByte(color.r)];
+        const SingleColorEntry& g = tables.c6[toByte(color.g)];
+        const SingleColorEntry& b = tables.c5[toByte(color.b)];
+
+        const auto w0 = static_cast<uint16_t>((r.e0 << 11) | (g.e0 << 5) | b.e0);
+        const auto w1 = static_cast<uint16_t>((r.e1 << 11) | (g.e1 << 5) | b.e1);
+
+        if (w0 > w1)
+        {
+            // Index 2 is 1/3 of the way from rgb[0] to rgb[1]
+            pBC->rgb[0] = w0;
+            pBC->rgb[1] = w1;
+            pBC->bitmap = 0xaaaaaaaa;
+        }
+        else if (w0 < w1)
+        {
+            // Swapped endpoints, so index 3 (2/3 of the way from rgb[0]) gives the same color
+            pBC->rgb[0] = w1;
+            pBC->rgb[1] = w0;
+            pBC->bitmap = 0xffffffff;
+        }
+        else
+        {
+            pBC->rgb[0] = w0;
+            pBC->rgb[1] = w1;
+            pBC->bitmap = 0x00000000;
+        }
+    }
+
+
     //-------------------------------------------------------------------------------------
     inline void DecodeBC1(
         _Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor,
@@ -405,6 +691,12 @@ namespace
             uSteps = 4u;
         }
 
+        if ((uSteps == 4) && !(flags & BC_FLAGS_DITHER_RGB) && IsSingleColor(pColor))
+        {
+            EncodeSingleColorBC1(pBC, pColor[0]);
+            return;
+        }
+
         // Quantize block to R56B5, using Floyd Stienberg error diffusion.  This
         // increases the chance that colors will map directly to the quantized
         // axis endpoints.
@@ -493,7 +785,14 @@ namespace
         // Then quantize and sort the endpoints depending on mode.
         HDRColorA ColorA, ColorB, ColorC, ColorD;
 
-        OptimizeRGB(&ColorA, &ColorB, Color, uSteps, flags);
+        if (flags & BC_FLAGS_CLUSTER_FIT)
+        {
+            OptimizeRGBClusterFit(&ColorA, &ColorB, Color, uSteps, flags);
+        }
+        else
+        {
+            OptimizeRGB(&ColorA, &ColorB, Color, uSteps, flags);
+        }
 
         if (flags & BC_FLAGS_UNIFORM)
         {
@@ -45,8 +45,21 @@ namespace DirectX
 
         BC_FLAGS_FORCE_BC7_MODE6 = 0x100000,
         // BC7 should only use mode 6; skip other modes
+
+        BC_FLAGS_BC7_QUALITY_MASK = 0xE00000,
+        // BC7 search level (0-5) stored as level + 1; zero selects the full search
+
+        BC_FLAGS_CLUSTER_FIT = 0x4000000,
+        // Exhaustive cluster-fit endpoint search for BC1-3; wider endpoint search for BC4-5
+
+        BC_FLAGS_BC6H_FAST = 0x8000000,
+        // BC6H refines only the best shape per mode and skips two-region modes for flat blocks
     };
 
+    constexpr uint32_t BC_ENCODER_VERSION = 1;
+    // Identifies the output of the CPU encoders for persisted block caches; bump it whenever
+    // any D3DXEncodeBC* can produce different bytes for the same input and flags
+
     //-------------------------------------------------------------------------------------
     // Structures
     //-------------------------------------------------------------------------------------
@@ -329,6 +342,10 @@ namespace DirectX
     void D3DXDecodeBC6HS(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
     void D3DXDecodeBC7(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMVECTOR *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
 
+    // BC6H decoded straight to half-floats (no float round-trip)
+    void D3DXDecodeBC6HU(_Out_writes_(NUM_PIXELS_PER_BLOCK) PackedVector::XMHALF4 *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
+    void D3DXDecodeBC6HS(_Out_writes_(NUM_PIXELS_PER_BLOCK) PackedVector::XMHALF4 *pColor, _In_reads_(16) const uint8_t *pBC) noexcept;
+
     void D3DXEncodeBC1(_Out_writes_(8) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ float threshold, _In_ uint32_t flags) noexcept;
         // BC1 requires one additional parameter, so it doesn't match signature of BC_ENCODE above
 
@@ -342,4 +359,7 @@ namespace DirectX
     void D3DXEncodeBC6HS(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
     void D3DXEncodeBC7(_Out_writes_(16) uint8_t *pBC, _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ uint32_t flags) noexcept;
 
+    void D3DXEncodeBC7Batch(_Out_writes_(count * 16) uint8_t *pBC, _In_reads_(count * NUM_PIXELS_PER_BLOCK) const XMVECTOR *pColor, _In_ size_t count, _In_ uint32_t flags) noexcept;
+        // Encodes 'count' consecutive blocks; output is identical to calling D3DXEncodeBC7 on each block
+
 } // namespace
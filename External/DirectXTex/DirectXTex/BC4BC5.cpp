@@ -38,6 +38,10 @@ namespace
     // BC4U/BC5U
     struct BC4_UNORM
     {
+        static constexpr int c_MinEndpoint = 0;
+        static constexpr int c_MaxEndpoint = 255;
+        static constexpr float c_Scale = 255.0f;
+
         float R(size_t uOffset) const noexcept
         {
             const size_t uIndex = GetIndex(uOffset);
@@ -94,6 +98,11 @@ namespace
     // BC4S/BC5S
     struct BC4_SNORM
     {
+        // -128 decodes the same as -127, so the search never produces it
+        static constexpr int c_MinEndpoint = -127;
+        static constexpr int c_MaxEndpoint = 127;
+        static constexpr float c_Scale = 127.0f;
+
         float R(size_t uOffset) const noexcept
         {
             const size_t uIndex = GetIndex(uOffset);
@@ -294,85 +303,257 @@ namespace
 
 
     //------------------------------------------------------------------------------
-    inline void FindEndPointsBC5U(
-        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
-        _In_reads_(BLOCK_SIZE) const float theTexelsV[],
-        _Out_ uint8_t &endpointU_0,
-        _Out_ uint8_t &endpointU_1,
-        _Out_ uint8_t &endpointV_0,
-        _Out_ uint8_t &endpointV_1) noexcept
+    inline void FindEndPoints(_Inout_ BC4_UNORM* pBC, _In_reads_(BLOCK_SIZE) const float theTexelsU[]) noexcept
     {
-        //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4U(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4U(theTexelsV, endpointV_0, endpointV_1);
+        FindEndPointsBC4U(theTexelsU, pBC->red_0, pBC->red_1);
     }
 
-    inline void FindEndPointsBC5S(
-        _In_reads_(BLOCK_SIZE) const float theTexelsU[],
-        _In_reads_(BLOCK_SIZE) const float theTexelsV[],
-        _Out_ int8_t &endpointU_0,
-        _Out_ int8_t &endpointU_1,
-        _Out_ int8_t &endpointV_0,
-        _Out_ int8_t &endpointV_1) noexcept
+    inline void FindEndPoints(_Inout_ BC4_SNORM* pBC, _In_reads_(BLOCK_SIZE) const float theTexelsU[]) noexcept
     {
-        //Encoding the U and V channel by BC4 codec separately.
-        FindEndPointsBC4S(theTexelsU, endpointU_0, endpointU_1);
-        FindEndPointsBC4S(theTexelsV, endpointV_0, endpointV_1);
+        FindEndPointsBC4S(theTexelsU, pBC->red_0, pBC->red_1);
     }
 
 
     //------------------------------------------------------------------------------
-    void FindClosestUNORM(
-        _Inout_ BC4_UNORM* pBC,
+    // Index selection and endpoint search, four texels per vector
+    //------------------------------------------------------------------------------
+    template<class BC4>
+    void FindClosest(
+        _Inout_ BC4* pBC,
         _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[]) noexcept
     {
-        float rGradient[8];
+        XMVECTOR rGradient[8];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            rGradient[i] = XMVectorReplicate(pBC->DecodeFromIndex(i));
+        }
+
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i += 4)
+        {
+            const XMVECTOR texels = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&theTexelsU[i]));
+
+            // Strict less-than keeps the lowest index on ties, as the scalar search did
+            XMVECTOR vBestDelta = XMVectorReplicate(100000.f);
+            XMVECTOR vBestIndex = XMVectorZero();
+            for (size_t uIndex = 0; uIndex < 8; ++uIndex)
+            {
+                const XMVECTOR vDelta = XMVectorAbs(XMVectorSubtract(rGradient[uIndex], texels));
+                const XMVECTOR vCloser = XMVectorLess(vDelta, vBestDelta);
+                vBestDelta = XMVectorSelect(vBestDelta, vDelta, vCloser);
+                vBestIndex = XMVectorSelect(vBestIndex, XMVectorReplicate(float(uIndex)), vCloser);
+            }
+
+            XMFLOAT4 bestIndex;
+            XMStoreFloat4(&bestIndex, vBestIndex);
+            pBC->SetIndex(i, static_cast<size_t>(bestIndex.x));
+            pBC->SetIndex(i + 1, static_cast<size_t>(bestIndex.y));
+            pBC->SetIndex(i + 2, static_cast<size_t>(bestIndex.z));
+            pBC->SetIndex(i + 3, static_cast<size_t>(bestIndex.w));
+        }
+    }
+
+    // Sum of squared errors over the block with the best index for every texel
+    template<class BC4>
+    float BlockError(_In_ const BC4& block, _In_reads_(4) const XMVECTOR* texels) noexcept
+    {
+        XMVECTOR rGradient[8];
         for (size_t i = 0; i < 8; ++i)
         {
-            rGradient[i] = pBC->DecodeFromIndex(i);
+            rGradient[i] = XMVectorReplicate(block.DecodeFromIndex(i));
         }
 
-        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        XMVECTOR vTotal = XMVectorZero();
+        for (size_t j = 0; j < 4; ++j)
         {
-            size_t uBestIndex = 0;
-            float fBestDelta = 100000;
-            for (size_t uIndex = 0; uIndex < 8; uIndex++)
+            XMVECTOR vBest = XMVectorReplicate(FLT_MAX);
+            for (size_t uIndex = 0; uIndex < 8; ++uIndex)
             {
-                const float fCurrentDelta = fabsf(rGradient[uIndex] - theTexelsU[i]);
-                if (fCurrentDelta < fBestDelta)
+                const XMVECTOR vDelta = XMVectorSubtract(rGradient[uIndex], texels[j]);
+                vBest = XMVectorMin(vBest, XMVectorMultiply(vDelta, vDelta));
+            }
+            vTotal = XMVectorAdd(vTotal, vBest);
+        }
+
+        return XMVectorGetX(XMVector4Dot(vTotal, g_XMOne));
+    }
+
+    template<class BC4>
+    inline void SetEndPoints(_Inout_ BC4& block, int endpoint_0, int endpoint_1) noexcept
+    {
+        using Endpoint = decltype(block.red_0);
+        block.red_0 = static_cast<Endpoint>(endpoint_0);
+        block.red_1 = static_cast<Endpoint>(endpoint_1);
+    }
+
+    //------------------------------------------------------------------------------
+    // Blocks with one or two distinct values don't need the optimizer. Returns true
+    // if the block was fully encoded.
+    //------------------------------------------------------------------------------
+    template<class BC4>
+    bool EncodeFewValues(
+        _Inout_ BC4* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[]) noexcept
+    {
+        float fValues[2] = { theTexelsU[0], theTexelsU[0] };
+        size_t nValues = 1;
+        for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            if (theTexelsU[i] == fValues[0] || (nValues > 1 && theTexelsU[i] == fValues[1]))
+                continue;
+
+            if (nValues > 1)
+                return false;
+
+            fValues[nValues++] = theTexelsU[i];
+        }
+
+        // Nearest endpoint code for each value, and whether it decodes back exactly
+        int codes[2] = {};
+        bool bExact = true;
+        for (size_t j = 0; j < nValues; ++j)
+        {
+            const float fCode = std::max(float(BC4::c_MinEndpoint), std::min(float(BC4::c_MaxEndpoint), fValues[j] * BC4::c_Scale));
+            codes[j] = static_cast<int>((fCode >= 0.f) ? (fCode + 0.5f) : (fCode - 0.5f));
+
+            BC4 test = {};
+            SetEndPoints(test, codes[j], codes[j]);
+            bExact = bExact && (test.DecodeFromIndex(0) == fValues[j]);
+        }
+
+        if (nValues == 2)
+        {
+            // Two exact levels are stored as the endpoints themselves; otherwise the
+            // optimizer has more room than a neighbourhood search around two values
+            if (!bExact || codes[0] == codes[1])
+                return false;
+
+            SetEndPoints(*pBC, std::max(codes[0], codes[1]), std::min(codes[0], codes[1]));
+            FindClosest(pBC, theTexelsU);
+            return true;
+        }
+
+        if (bExact)
+        {
+            SetEndPoints(*pBC, codes[0], codes[0]);
+            FindClosest(pBC, theTexelsU);
+            return true;
+        }
+
+        // A constant that falls between two codes is matched with the closest interpolant
+        // of nearby endpoint pairs; both orderings are tried so both modes are covered
+        constexpr int c_Radius = 3;
+        const int lo = std::max(BC4::c_MinEndpoint, codes[0] - c_Radius);
+        const int hi = std::min(BC4::c_MaxEndpoint, codes[0] + c_Radius);
+
+        float fBestErr = FLT_MAX;
+        int best0 = codes[0];
+        int best1 = codes[0];
+        for (int e0 = lo; e0 <= hi; ++e0)
+        {
+            for (int e1 = lo; e1 <= hi; ++e1)
+            {
+                BC4 test = {};
+                SetEndPoints(test, e0, e1);
+                for (size_t uIndex = 0; uIndex < 8; ++uIndex)
                 {
-                    uBestIndex = uIndex;
-                    fBestDelta = fCurrentDelta;
+                    const float fErr = fabsf(test.DecodeFromIndex(uIndex) - fValues[0]);
+                    if (fErr < fBestErr)
+                    {
+                        fBestErr = fErr;
+                        best0 = e0;
+                        best1 = e1;
+                    }
                 }
             }
-            pBC->SetIndex(i, uBestIndex);
         }
+
+        SetEndPoints(*pBC, best0, best1);
+        FindClosest(pBC, theTexelsU);
+        return true;
     }
 
-    void FindClosestSNORM(
-        _Inout_ BC4_SNORM* pBC,
+    //------------------------------------------------------------------------------
+    // High-quality mode: tries every endpoint pair within c_Radius codes of the optimizer's
+    // result, in both orderings so both interpolation modes are covered. A full 256 x 256
+    // sweep per block is far too slow at texture sizes, and the optimizer is rarely off by
+    // more than a few codes.
+    //------------------------------------------------------------------------------
+    template<class BC4>
+    void RefineEndPoints(
+        _Inout_ BC4* pBC,
         _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[]) noexcept
     {
-        float rGradient[8];
-        for (size_t i = 0; i < 8; ++i)
+        constexpr int c_Radius = 6;
+
+        XMVECTOR texels[4];
+        for (size_t j = 0; j < 4; ++j)
         {
-            rGradient[i] = pBC->DecodeFromIndex(i);
+            texels[j] = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&theTexelsU[j * 4]));
         }
 
-        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        float fBestErr = BlockError(*pBC, texels);
+        if (fBestErr <= 0.f)
+            return;
+
+        const int start[2][2] =
+        {
+            { pBC->red_0, pBC->red_1 },
+            { pBC->red_1, pBC->red_0 },
+        };
+
+        int best0 = pBC->red_0;
+        int best1 = pBC->red_1;
+        bool bImproved = false;
+
+        for (size_t order = 0; order < 2; ++order)
         {
-            size_t uBestIndex = 0;
-            float fBestDelta = 100000;
-            for (size_t uIndex = 0; uIndex < 8; uIndex++)
+            const int lo0 = std::max(BC4::c_MinEndpoint, start[order][0] - c_Radius);
+            const int hi0 = std::min(BC4::c_MaxEndpoint, start[order][0] + c_Radius);
+            const int lo1 = std::max(BC4::c_MinEndpoint, start[order][1] - c_Radius);
+            const int hi1 = std::min(BC4::c_MaxEndpoint, start[order][1] + c_Radius);
+
+            for (int e0 = lo0; e0 <= hi0; ++e0)
             {
-                const float fCurrentDelta = fabsf(rGradient[uIndex] - theTexelsU[i]);
-                if (fCurrentDelta < fBestDelta)
+                for (int e1 = lo1; e1 <= hi1; ++e1)
                 {
-                    uBestIndex = uIndex;
-                    fBestDelta = fCurrentDelta;
+                    BC4 test = {};
+                    SetEndPoints(test, e0, e1);
+                    const float fErr = BlockError(test, texels);
+                    if (fErr < fBestErr)
+                    {
+                        fBestErr = fErr;
+                        best0 = e0;
+                        best1 = e1;
+                        bImproved = true;
+                    }
                 }
             }
-            pBC->SetIndex(i, uBestIndex);
+        }
+
+        if (bImproved)
+        {
+            SetEndPoints(*pBC, best0, best1);
+            FindClosest(pBC, theTexelsU);
+        }
+    }
+
+
+    //------------------------------------------------------------------------------
+    template<class BC4>
+    void EncodeBC4(
+        _Inout_ BC4* pBC,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const float theTexelsU[],
+        uint32_t flags) noexcept
+    {
+        if (EncodeFewValues(pBC, theTexelsU))
+            return;
+
+        FindEndPoints(pBC, theTexelsU);
+        FindClosest(pBC, theTexelsU);
+
+        if (flags & BC_FLAGS_CLUSTER_FIT)
+        {
+            RefineEndPoints(pBC, theTexelsU);
         }
     }
 }
@@ -418,8 +599,6 @@ void DirectX::D3DXDecodeBC4S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
 
@@ -432,15 +611,12 @@ void DirectX::D3DXEncodeBC4U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4U(theTexelsU, pBC4->red_0, pBC4->red_1);
-    FindClosestUNORM(pBC4, theTexelsU);
+    EncodeBC4(pBC4, theTexelsU, flags);
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
 
@@ -453,8 +629,7 @@ void DirectX::D3DXEncodeBC4S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsU[i] = XMVectorGetX(pColor[i]);
     }
 
-    FindEndPointsBC4S(theTexelsU, pBC4->red_0, pBC4->red_1);
-    FindClosestSNORM(pBC4, theTexelsU);
+    EncodeBC4(pBC4, theTexelsU, flags);
 }
 
 
@@ -496,8 +671,6 @@ void DirectX::D3DXDecodeBC5S(XMVECTOR *pColor, const uint8_t *pBC) noexcept
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_UNORM) == 8, "BC4_UNORM should be 8 bytes");
 
@@ -515,23 +688,14 @@ void DirectX::D3DXEncodeBC5U(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsV[i] = clr.y;
     }
 
-    FindEndPointsBC5U(
-        theTexelsU,
-        theTexelsV,
-        pBCR->red_0,
-        pBCR->red_1,
-        pBCG->red_0,
-        pBCG->red_1);
-
-    FindClosestUNORM(pBCR, theTexelsU);
-    FindClosestUNORM(pBCG, theTexelsV);
+    // Encoding the U and V channel by BC4 codec separately.
+    EncodeBC4(pBCR, theTexelsU, flags);
+    EncodeBC4(pBCG, theTexelsV, flags);
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
-
     assert(pBC && pColor);
     static_assert(sizeof(BC4_SNORM) == 8, "BC4_SNORM should be 8 bytes");
 
@@ -549,14 +713,7 @@ void DirectX::D3DXEncodeBC5S(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flag
         theTexelsV[i] = clr.y;
     }
 
-    FindEndPointsBC5S(
-        theTexelsU,
-        theTexelsV,
-        pBCR->red_0,
-        pBCR->red_1,
-        pBCG->red_0,
-        pBCG->red_1);
-
-    FindClosestSNORM(pBCR, theTexelsU);
-    FindClosestSNORM(pBCG, theTexelsV);
+    // Encoding the U and V channel by BC4 codec separately.
+    EncodeBC4(pBCR, theTexelsU, flags);
+    EncodeBC4(pBCG, theTexelsV, flags);
 }
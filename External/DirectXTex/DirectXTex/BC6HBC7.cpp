@@ -327,6 +327,25 @@ namespace
     const int g_aWeights2[] = { 0, 21, 43, 64 };
     const int g_aWeights3[] = { 0, 9, 18, 27, 37, 46, 55, 64 };
     const int g_aWeights4[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // BC7 search effort per TEX_COMPRESS_BC7_QUALITY_* level. Errors are the sum of squared
+    // 8-bit channel differences over the block, as returned by RoughMSE and Refine.
+    struct BC7Quality
+    {
+        uint8_t uModeMask;      // bit n set if mode n is tried
+        uint8_t uItemsShift;    // number of shapes refined is uShapes >> uItemsShift (at least 1)
+        float fTargetMSE;       // stop searching the block once its error is at or below this
+    };
+
+    constexpr BC7Quality g_aBC7Quality[] =
+    {
+        { 0x62, 6, 256.f },     // 0: modes 1, 5 & 6; best rough shape only
+        { 0xFF, 6, 128.f },     // 1
+        { 0xFF, 5, 64.f },      // 2
+        { 0xFF, 4, 32.f },      // 3
+        { 0xFF, 3, 8.f },       // 4
+        { 0xFF, 2, 0.f },       // 5: full search
+    };
 }
 
 namespace DirectX
@@ -667,7 +686,8 @@ namespace
     {
     public:
         void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) HDRColorA* pOut) const noexcept;
-        void Encode(_In_ bool bSigned, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
+        void Decode(_In_ bool bSigned, _Out_writes_(NUM_PIXELS_PER_BLOCK) XMHALF4* pOut) const noexcept;
+        void Encode(_In_ bool bSigned, _In_ uint32_t flags, _In_reads_(NUM_PIXELS_PER_BLOCK) const HDRColorA* const pIn) noexcept;
 
     private:
     #pragma warning(push)
@@ -732,8 +752,29 @@ namespace
 
         static int Quantize(_In_ int iValue, _In_ int prec, _In_ bool bSigned) noexcept;
         static int Unquantize(_In_ int comp, _In_ uint8_t uBitsPerComp, _In_ bool bSigned) noexcept;
+        static int ComputeUnquantize(_In_ int comp, _In_ uint8_t uBitsPerComp, _In_ bool bSigned) noexcept;
         static int FinishUnquantize(_In_ int comp, _In_ bool bSigned) noexcept;
 
+        // Unquantize results for every endpoint precision up to the widest one that isn't
+        // passed through unchanged (12 bits, mode 13). Unsigned tables are indexed by value,
+        // signed ones by magnitude.
+        static constexpr uint8_t c_UnquantizeTableBits = 12;
+
+        struct UnquantizeTable
+        {
+            uint16_t aUnsigned[(2u << c_UnquantizeTableBits) - 2];
+            uint16_t aSigned[(1u << c_UnquantizeTableBits) - 1];
+
+            UnquantizeTable() noexcept;
+
+            static constexpr size_t UnsignedOffset(size_t uBits) noexcept { return (size_t(1) << uBits) - 2; }
+            static constexpr size_t SignedOffset(size_t uBits) noexcept { return (size_t(1) << (uBits - 1)) - 1; }
+        };
+
+        static const UnquantizeTable& GetUnquantizeTable() noexcept;
+
+        static bool IsFlatBlock(_In_ const EncodeParams* pEP) noexcept;
+
         static bool EndPointsFit(_In_ const EncodeParams* pEP, _In_reads_(BC6H_MAX_REGIONS) const INTEndPntPair aEndPts[]) noexcept;
 
         void GeneratePaletteQuantized(_In_ const EncodeParams* pEP, _In_ const INTEndPntPair& endPts,
@@ -1555,10 +1596,82 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // BC7 palettes are kept in structure-of-arrays form so the error against four palette
+    // entries is computed per vector operation. Every term is a small integer, so the sums
+    // are exact and the selected indices match a one-entry-at-a-time search.
+    struct LDRPalette
+    {
+        XMVECTOR r[BC7_MAX_INDICES / 4];
+        XMVECTOR g[BC7_MAX_INDICES / 4];
+        XMVECTOR b[BC7_MAX_INDICES / 4];
+        XMVECTOR a[BC7_MAX_INDICES / 4];
+    };
+
+    void LoadPalette(
+        _In_reads_(BC7_MAX_INDICES) const LDRColorA aPalette[],
+        uint8_t uIndexPrec,
+        uint8_t uIndexPrec2,
+        _Out_ LDRPalette& pal) noexcept
+    {
+        const size_t uNumIndices = size_t(1) << uIndexPrec;
+        const size_t uNumIndicesA = (uIndexPrec2 == 0) ? uNumIndices : (size_t(1) << uIndexPrec2);
+        assert(uNumIndices <= BC7_MAX_INDICES && uNumIndicesA <= BC7_MAX_INDICES);
+        _Analysis_assume_(uNumIndices <= BC7_MAX_INDICES && uNumIndicesA <= BC7_MAX_INDICES);
+
+        XM_ALIGNED_DATA(16) float fR[BC7_MAX_INDICES] = {};
+        XM_ALIGNED_DATA(16) float fG[BC7_MAX_INDICES] = {};
+        XM_ALIGNED_DATA(16) float fB[BC7_MAX_INDICES] = {};
+        XM_ALIGNED_DATA(16) float fA[BC7_MAX_INDICES] = {};
+
+        for (size_t i = 0; i < uNumIndices; ++i)
+        {
+            fR[i] = float(aPalette[i].r);
+            fG[i] = float(aPalette[i].g);
+            fB[i] = float(aPalette[i].b);
+        }
+
+        for (size_t i = 0; i < uNumIndicesA; ++i)
+        {
+            fA[i] = float(aPalette[i].a);
+        }
+
+        for (size_t j = 0; j < (BC7_MAX_INDICES / 4); ++j)
+        {
+            pal.r[j] = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fR[j * 4]));
+            pal.g[j] = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fG[j * 4]));
+            pal.b[j] = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fB[j * 4]));
+            pal.a[j] = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&fA[j * 4]));
+        }
+    }
+
+    // Picks the first local minimum in index order, which is how the palette search has always
+    // terminated (the palette is monotonic along the endpoint axis)
+    inline float FindBestIndex(
+        _In_reads_(uNumIndices) const float* afErr,
+        size_t uNumIndices,
+        _Out_opt_ size_t* pBestIndex) noexcept
+    {
+        float fBestErr = FLT_MAX;
+        for (size_t i = 0; i < uNumIndices && fBestErr > 0; i++)
+        {
+            const float fErr = afErr[i];
+            if (fErr > fBestErr)	// error increased, so we're done searching
+                break;
+            if (fErr < fBestErr)
+            {
+                fBestErr = fErr;
+                if (pBestIndex)
+                    *pBestIndex = i;
+            }
+        }
+        return fBestErr;
+    }
+
     //-------------------------------------------------------------------------------------
     float ComputeError(
         _Inout_ const LDRColorA& pixel,
-        _In_reads_(1 << uIndexPrec) const LDRColorA aPalette[],
+        _In_ const LDRPalette& pal,
         uint8_t uIndexPrec,
         uint8_t uIndexPrec2,
         _Out_opt_ size_t* pBestIndex = nullptr,
@@ -1567,68 +1680,61 @@ namespace
         const size_t uNumIndices = size_t(1) << uIndexPrec;
         const size_t uNumIndices2 = size_t(1) << uIndexPrec2;
         float fTotalErr = 0;
-        float fBestErr = FLT_MAX;
 
         if (pBestIndex)
             *pBestIndex = 0;
         if (pBestIndex2)
             *pBestIndex2 = 0;
 
-        const XMVECTOR vpixel = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(&pixel));
+        const XMVECTOR vr = XMVectorReplicate(float(pixel.r));
+        const XMVECTOR vg = XMVectorReplicate(float(pixel.g));
+        const XMVECTOR vb = XMVectorReplicate(float(pixel.b));
+        const XMVECTOR va = XMVectorReplicate(float(pixel.a));
+
+        XM_ALIGNED_DATA(16) float afErr[BC7_MAX_INDICES];
 
         if (uIndexPrec2 == 0)
         {
-            for (size_t i = 0; i < uNumIndices && fBestErr > 0; i++)
+            // Compute ErrorMetric
+            for (size_t j = 0; j < (uNumIndices >> 2); ++j)
             {
-                XMVECTOR tpixel = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(&aPalette[i]));
-                // Compute ErrorMetric
-                tpixel = XMVectorSubtract(vpixel, tpixel);
-                const float fErr = XMVectorGetX(XMVector4Dot(tpixel, tpixel));
-                if (fErr > fBestErr)	// error increased, so we're done searching
-                    break;
-                if (fErr < fBestErr)
-                {
-                    fBestErr = fErr;
-                    if (pBestIndex)
-                        *pBestIndex = i;
-                }
+                const XMVECTOR dr = XMVectorSubtract(vr, pal.r[j]);
+                const XMVECTOR dg = XMVectorSubtract(vg, pal.g[j]);
+                const XMVECTOR db = XMVectorSubtract(vb, pal.b[j]);
+                const XMVECTOR da = XMVectorSubtract(va, pal.a[j]);
+                XMVECTOR err = XMVectorMultiply(dr, dr);
+                err = XMVectorAdd(err, XMVectorMultiply(dg, dg));
+                err = XMVectorAdd(err, XMVectorMultiply(db, db));
+                err = XMVectorAdd(err, XMVectorMultiply(da, da));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&afErr[j * 4]), err);
             }
-            fTotalErr += fBestErr;
+
+            fTotalErr += FindBestIndex(afErr, uNumIndices, pBestIndex);
         }
         else
         {
-            for (size_t i = 0; i < uNumIndices && fBestErr > 0; i++)
+            // Compute ErrorMetricRGB
+            for (size_t j = 0; j < (uNumIndices >> 2); ++j)
             {
-                XMVECTOR tpixel = XMLoadUByte4(reinterpret_cast<const XMUBYTE4*>(&aPalette[i]));
-                // Compute ErrorMetricRGB
-                tpixel = XMVectorSubtract(vpixel, tpixel);
-                const float fErr = XMVectorGetX(XMVector3Dot(tpixel, tpixel));
-                if (fErr > fBestErr)	// error increased, so we're done searching
-                    break;
-                if (fErr < fBestErr)
-                {
-                    fBestErr = fErr;
-                    if (pBestIndex)
-                        *pBestIndex = i;
-                }
+                const XMVECTOR dr = XMVectorSubtract(vr, pal.r[j]);
+                const XMVECTOR dg = XMVectorSubtract(vg, pal.g[j]);
+                const XMVECTOR db = XMVectorSubtract(vb, pal.b[j]);
+                XMVECTOR err = XMVectorMultiply(dr, dr);
+                err = XMVectorAdd(err, XMVectorMultiply(dg, dg));
+                err = XMVectorAdd(err, XMVectorMultiply(db, db));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&afErr[j * 4]), err);
             }
-            fTotalErr += fBestErr;
-            fBestErr = FLT_MAX;
-            for (size_t i = 0; i < uNumIndices2 && fBestErr > 0; i++)
+
+            fTotalErr += FindBestIndex(afErr, uNumIndices, pBestIndex);
+
+            // Compute ErrorMetricAlpha
+            for (size_t j = 0; j < (uNumIndices2 >> 2); ++j)
             {
-                // Compute ErrorMetricAlpha
-                const float ea = float(pixel.a) - float(aPalette[i].a);
-                const float fErr = ea*ea;
-                if (fErr > fBestErr)	// error increased, so we're done searching
-                    break;
-                if (fErr < fBestErr)
-                {
-                    fBestErr = fErr;
-                    if (pBestIndex2)
-                        *pBestIndex2 = i;
-                }
+                const XMVECTOR da = XMVectorSubtract(va, pal.a[j]);
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&afErr[j * 4]), XMVectorMultiply(da, da));
             }
-            fTotalErr += fBestErr;
+
+            fTotalErr += FindBestIndex(afErr, uNumIndices2, pBestIndex2);
         }
 
         return fTotalErr;
@@ -1648,6 +1754,23 @@ namespace
         #endif
         }
     }
+
+    constexpr HALF c_HalfZero = 0x0000;
+    constexpr HALF c_HalfOne = 0x3C00;
+
+    void FillWithErrorColors(_Out_writes_(NUM_PIXELS_PER_BLOCK) XMHALF4* pOut) noexcept
+    {
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+        #ifdef _DEBUG
+            // Use Magenta in debug as a highly-visible error color
+            pOut[i] = XMHALF4(c_HalfOne, c_HalfZero, c_HalfOne, c_HalfOne);
+        #else
+            // In production use, default to black
+            pOut[i] = XMHALF4(c_HalfZero, c_HalfZero, c_HalfZero, c_HalfOne);
+        #endif
+        }
+    }
 }
 
 
@@ -1659,6 +1782,24 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
 {
     assert(pOut);
 
+    XMHALF4 aF16[NUM_PIXELS_PER_BLOCK];
+    Decode(bSigned, aF16);
+
+    for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        pOut[i].r = XMConvertHalfToFloat(aF16[i].x);
+        pOut[i].g = XMConvertHalfToFloat(aF16[i].y);
+        pOut[i].b = XMConvertHalfToFloat(aF16[i].z);
+        pOut[i].a = XMConvertHalfToFloat(aF16[i].w);
+    }
+}
+
+// The endpoints are reconstructed as half-floats, so this is the lossless form of the block
+_Use_decl_annotations_
+void D3DX_BC6H::Decode(bool bSigned, XMHALF4* pOut) const noexcept
+{
+    assert(pOut);
+
     size_t uStartBit = 0;
     uint8_t uMode = GetBits(uStartBit, 2u);
     if (uMode != 0x00 && uMode != 0x01)
@@ -1784,10 +1925,7 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
             HALF rgb[3];
             fc.ToF16(rgb, bSigned);
 
-            pOut[i].r = XMConvertHalfToFloat(rgb[0]);
-            pOut[i].g = XMConvertHalfToFloat(rgb[1]);
-            pOut[i].b = XMConvertHalfToFloat(rgb[2]);
-            pOut[i].a = 1.0f;
+            pOut[i] = XMHALF4(rgb[0], rgb[1], rgb[2], c_HalfOne);
         }
     }
     else
@@ -1807,45 +1945,64 @@ void D3DX_BC6H::Decode(bool bSigned, HDRColorA* pOut) const noexcept
         // Per the BC6H format spec, we must return opaque black
         for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
         {
-            pOut[i] = HDRColorA(0.0f, 0.0f, 0.0f, 1.0f);
+            pOut[i] = XMHALF4(c_HalfZero, c_HalfZero, c_HalfZero, c_HalfOne);
         }
     }
 }
 
 
 _Use_decl_annotations_
-void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
+void D3DX_BC6H::Encode(bool bSigned, uint32_t flags, const HDRColorA* const pIn) noexcept
 {
     assert(pIn);
 
     EncodeParams EP(pIn, bSigned);
 
+    // Fast mode refines only the best rough shape of each mode, and skips the two-region
+    // modes entirely when the block's dynamic range is too small for a split to pay off
+    const bool bFast = (flags & BC_FLAGS_BC6H_FAST) != 0;
+    const bool bSkipPartitions = bFast && IsFlatBlock(&EP);
+
+    // RoughMSE only depends on the region layout and index precision, which all two-region
+    // modes (and all one-region modes) share, so the shape ranking is reused across a group
+    float afRoughMSE[BC6H_MAX_SHAPES];
+    uint8_t auShape[BC6H_MAX_SHAPES];
+    int rankedGroup = -1;
+
     for (EP.uMode = 0; EP.uMode < c_NumModes && EP.fBestErr > 0; ++EP.uMode)
     {
-        const uint8_t uShapes = ms_aInfo[EP.uMode].uPartitions ? 32u : 1u;
+        const ModeInfo& info = ms_aInfo[EP.uMode];
+        if (bSkipPartitions && info.uPartitions)
+            continue;
+
+        const uint8_t uShapes = info.uPartitions ? 32u : 1u;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1u, size_t(uShapes >> 2));
-        float afRoughMSE[BC6H_MAX_SHAPES];
-        uint8_t auShape[BC6H_MAX_SHAPES];
+        const size_t uItems = bFast ? 1u : std::max<size_t>(1u, size_t(uShapes >> 2));
 
-        // pick the best uItems shapes and refine these.
-        for (EP.uShape = 0; EP.uShape < uShapes; ++EP.uShape)
+        const int group = (int(info.uPartitions) << 8) | int(info.uIndexPrec);
+        if (group != rankedGroup)
         {
-            size_t uShape = EP.uShape;
-            afRoughMSE[uShape] = RoughMSE(&EP);
-            auShape[uShape] = static_cast<uint8_t>(uShape);
-        }
+            rankedGroup = group;
 
-        // Bubble up the first uItems items
-        for (size_t i = 0; i < uItems; i++)
-        {
-            for (size_t j = i + 1; j < uShapes; j++)
+            // pick the best uItems shapes and refine these.
+            for (EP.uShape = 0; EP.uShape < uShapes; ++EP.uShape)
             {
-                if (afRoughMSE[i] > afRoughMSE[j])
+                size_t uShape = EP.uShape;
+                afRoughMSE[uShape] = RoughMSE(&EP);
+                auShape[uShape] = static_cast<uint8_t>(uShape);
+            }
+
+            // Bubble up the first uItems items
+            for (size_t i = 0; i < uItems; i++)
+            {
+                for (size_t j = i + 1; j < uShapes; j++)
                 {
-                    std::swap(afRoughMSE[i], afRoughMSE[j]);
-                    std::swap(auShape[i], auShape[j]);
+                    if (afRoughMSE[i] > afRoughMSE[j])
+                    {
+                        std::swap(afRoughMSE[i], afRoughMSE[j]);
+                        std::swap(auShape[i], auShape[j]);
+                    }
                 }
             }
         }
@@ -1859,6 +2016,31 @@ void D3DX_BC6H::Encode(bool bSigned, const HDRColorA* const pIn) noexcept
 }
 
 
+_Use_decl_annotations_
+bool D3DX_BC6H::IsFlatBlock(const EncodeParams* pEP) noexcept
+{
+    assert(pEP);
+
+    // Largest per-channel spread, in half-float bit patterns, that still counts as flat.
+    // 0x80 is an eighth of one exponent step, i.e. about a 12% change in intensity.
+    constexpr int c_FlatRange = 0x80;
+
+    INTColor minColor = pEP->aIPixels[0];
+    INTColor maxColor = pEP->aIPixels[0];
+    for (size_t i = 1; i < NUM_PIXELS_PER_BLOCK; ++i)
+    {
+        const INTColor& c = pEP->aIPixels[i];
+        minColor.r = std::min(minColor.r, c.r); maxColor.r = std::max(maxColor.r, c.r);
+        minColor.g = std::min(minColor.g, c.g); maxColor.g = std::max(maxColor.g, c.g);
+        minColor.b = std::min(minColor.b, c.b); maxColor.b = std::max(maxColor.b, c.b);
+    }
+
+    return (maxColor.r - minColor.r) <= c_FlatRange
+        && (maxColor.g - minColor.g) <= c_FlatRange
+        && (maxColor.b - minColor.b) <= c_FlatRange;
+}
+
+
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
 int D3DX_BC6H::Quantize(int iValue, int prec, bool bSigned) noexcept
@@ -1889,8 +2071,53 @@ int D3DX_BC6H::Quantize(int iValue, int prec, bool bSigned) noexcept
 }
 
 
+D3DX_BC6H::UnquantizeTable::UnquantizeTable() noexcept
+{
+    for (uint8_t uBits = 1; uBits <= c_UnquantizeTableBits; ++uBits)
+    {
+        uint16_t* pUnsigned = aUnsigned + UnsignedOffset(uBits);
+        for (int comp = 0; comp < (1 << uBits); ++comp)
+            pUnsigned[comp] = static_cast<uint16_t>(ComputeUnquantize(comp, uBits, false));
+
+        uint16_t* pSigned = aSigned + SignedOffset(uBits);
+        for (int comp = 0; comp < (1 << (uBits - 1)); ++comp)
+            pSigned[comp] = static_cast<uint16_t>(ComputeUnquantize(comp, uBits, true));
+    }
+}
+
+
+const D3DX_BC6H::UnquantizeTable& D3DX_BC6H::GetUnquantizeTable() noexcept
+{
+    static const UnquantizeTable s_table;
+    return s_table;
+}
+
+
 _Use_decl_annotations_
 int D3DX_BC6H::Unquantize(int comp, uint8_t uBitsPerComp, bool bSigned) noexcept
+{
+    if (uBitsPerComp >= 2 && uBitsPerComp <= c_UnquantizeTableBits)
+    {
+        const UnquantizeTable& table = GetUnquantizeTable();
+        if (bSigned)
+        {
+            // Every magnitude from (1 << (uBitsPerComp - 1)) - 1 up saturates to 0x7FFF
+            const int mag = std::min((comp < 0) ? -comp : comp, (1 << (uBitsPerComp - 1)) - 1);
+            const int unq = table.aSigned[UnquantizeTable::SignedOffset(uBitsPerComp) + size_t(mag)];
+            return (comp < 0) ? -unq : unq;
+        }
+        else if (comp >= 0 && comp < (1 << uBitsPerComp))
+        {
+            return table.aUnsigned[UnquantizeTable::UnsignedOffset(uBitsPerComp) + size_t(comp)];
+        }
+    }
+
+    return ComputeUnquantize(comp, uBitsPerComp, bSigned);
+}
+
+
+_Use_decl_annotations_
+int D3DX_BC6H::ComputeUnquantize(int comp, uint8_t uBitsPerComp, bool bSigned) noexcept
 {
     int unq = 0, s = 0;
     if (bSigned)
@@ -2052,21 +2279,26 @@ float D3DX_BC6H::MapColorsQuantized(const EncodeParams* pEP, const INTColor aCol
     INTColor aPalette[BC6H_MAX_INDICES];
     GeneratePaletteQuantized(pEP, endPts, aPalette);
 
+    // Convert the palette once rather than for every pixel it is tested against
+    XMVECTOR vPalette[BC6H_MAX_INDICES];
+    for (size_t j = 0; j < uNumIndices; ++j)
+    {
+        vPalette[j] = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[j]));
+    }
+
     float fTotErr = 0;
     for (size_t i = 0; i < np; ++i)
     {
         const XMVECTOR vcolors = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aColors[i]));
 
         // Compute ErrorMetricRGB
-        XMVECTOR tpal = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[0]));
-        tpal = XMVectorSubtract(vcolors, tpal);
+        XMVECTOR tpal = XMVectorSubtract(vcolors, vPalette[0]);
         float fBestErr = XMVectorGetX(XMVector3Dot(tpal, tpal));
 
         for (int j = 1; j < uNumIndices && fBestErr > 0; ++j)
         {
             // Compute ErrorMetricRGB
-            tpal = XMLoadSInt4(reinterpret_cast<const XMINT4*>(&aPalette[j]));
-            tpal = XMVectorSubtract(vcolors, tpal);
+            tpal = XMVectorSubtract(vcolors, vPalette[j]);
             const float fErr = XMVectorGetX(XMVector3Dot(tpal, tpal));
             if (fErr > fBestErr) break;     // error increased, so we're done searching
             if (fErr < fBestErr) fBestErr = fErr;
@@ -2800,8 +3032,17 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
 
     const bool bHasAlpha = (alphaMask != 0xFF);
 
-    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > 0; ++EP.uMode)
+    const uint32_t uQualityBits = (flags & BC_FLAGS_BC7_QUALITY_MASK) >> 21;
+    const bool bFullSearch = (uQualityBits == 0 || uQualityBits > std::size(g_aBC7Quality) - 1);
+    const BC7Quality& quality = g_aBC7Quality[bFullSearch ? (std::size(g_aBC7Quality) - 1) : (uQualityBits - 1)];
+
+    for (EP.uMode = 0; EP.uMode < 8 && fMSEBest > quality.fTargetMSE; ++EP.uMode)
     {
+        if (!(quality.uModeMask & (1u << EP.uMode)))
+        {
+            continue;
+        }
+
         if (!(flags & BC_FLAGS_USE_3SUBSETS) && (EP.uMode == 0 || EP.uMode == 2))
         {
             // 3 subset modes tend to be used rarely and add significant compression time
@@ -2828,11 +3069,11 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
         const size_t uNumIdxMode = size_t(1) << ms_aInfo[EP.uMode].uIndexModeBits;
         // Number of rough cases to look at. reasonable values of this are 1, uShapes/4, and uShapes
         // uShapes/4 gets nearly all the cases; you can increase that a bit (say by 3 or 4) if you really want to squeeze the last bit out
-        const size_t uItems = std::max<size_t>(1, uShapes >> 2);
+        const size_t uItems = std::max<size_t>(1, uShapes >> quality.uItemsShift);
         float afRoughMSE[BC7_MAX_SHAPES];
         size_t auShape[BC7_MAX_SHAPES];
 
-        for (size_t r = 0; r < uNumRots && fMSEBest > 0; ++r)
+        for (size_t r = 0; r < uNumRots && fMSEBest > quality.fTargetMSE; ++r)
         {
             switch (r)
             {
@@ -2842,7 +3083,7 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
             default: break;
             }
 
-            for (size_t im = 0; im < uNumIdxMode && fMSEBest > 0; ++im)
+            for (size_t im = 0; im < uNumIdxMode && fMSEBest > quality.fTargetMSE; ++im)
             {
                 // pick the best uItems shapes and refine these.
                 for (size_t s = 0; s < uShapes; s++)
@@ -2864,8 +3105,14 @@ void D3DX_BC7::Encode(uint32_t flags, const HDRColorA* const pIn) noexcept
                     }
                 }
 
-                for (size_t i = 0; i < uItems && fMSEBest > 0; i++)
+                for (size_t i = 0; i < uItems && fMSEBest > quality.fTargetMSE; i++)
                 {
+                    if (!bFullSearch && i > 0 && afRoughMSE[i] >= fMSEBest)
+                    {
+                        // Later candidates are ranked worse, so once the rough estimate can't beat what we have, stop refining
+                        break;
+                    }
+
                     const float fMSE = Refine(&EP, auShape[i], r, im);
                     if (fMSE < fMSEBest)
                     {
@@ -3161,10 +3408,13 @@ void D3DX_BC7::AssignIndices(const EncodeParams* pEP, size_t uShape, size_t uInd
     const uint8_t uHighestIndexBit2 = uint8_t(uNumIndices2 >> 1);
     LDRColorA aPalette[BC7_MAX_REGIONS][BC7_MAX_INDICES];
 
+    LDRPalette aPal[BC7_MAX_REGIONS];
+
     // build list of possibles
     for (size_t p = 0; p <= uPartitions; p++)
     {
         GeneratePaletteQuantized(pEP, uIndexMode, endPts[p], aPalette[p]);
+        LoadPalette(aPalette[p], uIndexPrec, uIndexPrec2, aPal[p]);
         afTotErr[p] = 0;
     }
 
@@ -3173,7 +3423,7 @@ void D3DX_BC7::AssignIndices(const EncodeParams* pEP, size_t uShape, size_t uInd
         uint8_t uRegion = g_aPartitionTable[uPartitions][uShape][i];
         assert(uRegion < BC7_MAX_REGIONS);
         _Analysis_assume_(uRegion < BC7_MAX_REGIONS);
-        afTotErr[uRegion] += ComputeError(pEP->aLDRPixels[i], aPalette[uRegion], uIndexPrec, uIndexPrec2, &(aIndices[i]), &(aIndices2[i]));
+        afTotErr[uRegion] += ComputeError(pEP->aLDRPixels[i], aPal[uRegion], uIndexPrec, uIndexPrec2, &(aIndices[i]), &(aIndices2[i]));
     }
 
     // swap endpoints as needed to ensure that the indices at index_positions have a 0 high-order bit
@@ -3472,12 +3722,14 @@ float D3DX_BC7::MapColors(const EncodeParams* pEP, const LDRColorA aColors[], si
     const uint8_t uIndexPrec = uIndexMode ? ms_aInfo[pEP->uMode].uIndexPrec2 : ms_aInfo[pEP->uMode].uIndexPrec;
     const uint8_t uIndexPrec2 = uIndexMode ? ms_aInfo[pEP->uMode].uIndexPrec : ms_aInfo[pEP->uMode].uIndexPrec2;
     LDRColorA aPalette[BC7_MAX_INDICES];
+    LDRPalette pal;
     float fTotalErr = 0;
 
     GeneratePaletteQuantized(pEP, uIndexMode, endPts, aPalette);
+    LoadPalette(aPalette, uIndexPrec, uIndexPrec2, pal);
     for (size_t i = 0; i < np; ++i)
     {
-        fTotalErr += ComputeError(aColors[i], aPalette, uIndexPrec, uIndexPrec2);
+        fTotalErr += ComputeError(aColors[i], pal, uIndexPrec, uIndexPrec2);
         if (fTotalErr > fMinErr)   // check for early exit
         {
             fTotalErr = FLT_MAX;
@@ -3586,11 +3838,15 @@ float D3DX_BC7::RoughMSE(EncodeParams* pEP, size_t uShape, size_t uIndexMode) no
         }
     }
 
+    LDRPalette aPal[BC7_MAX_REGIONS];
+    for (size_t p = 0; p <= uPartitions; p++)
+        LoadPalette(aPalette[p], uIndexPrec, uIndexPrec2, aPal[p]);
+
     float fTotalErr = 0;
     for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; i++)
     {
         const uint8_t uRegion = g_aPartitionTable[uPartitions][uShape][i];
-        fTotalErr += ComputeError(pEP->aLDRPixels[i], aPalette[uRegion], uIndexPrec, uIndexPrec2);
+        fTotalErr += ComputeError(pEP->aLDRPixels[i], aPal[uRegion], uIndexPrec, uIndexPrec2);
     }
 
     return fTotalErr;
@@ -3620,22 +3876,36 @@ void DirectX::D3DXDecodeBC6HS(XMVECTOR *pColor, const uint8_t *pBC) noexcept
     reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(true, reinterpret_cast<HDRColorA*>(pColor));
 }
 
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC6HU(XMHALF4 *pColor, const uint8_t *pBC) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+    reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(false, pColor);
+}
+
+_Use_decl_annotations_
+void DirectX::D3DXDecodeBC6HS(XMHALF4 *pColor, const uint8_t *pBC) noexcept
+{
+    assert(pColor && pBC);
+    static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
+    reinterpret_cast<const D3DX_BC6H*>(pBC)->Decode(true, pColor);
+}
+
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HU(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(false, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 _Use_decl_annotations_
 void DirectX::D3DXEncodeBC6HS(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags) noexcept
 {
-    UNREFERENCED_PARAMETER(flags);
     assert(pBC && pColor);
     static_assert(sizeof(D3DX_BC6H) == 16, "D3DX_BC6H should be 16 bytes");
-    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, reinterpret_cast<const HDRColorA*>(pColor));
+    reinterpret_cast<D3DX_BC6H*>(pBC)->Encode(true, flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
 
 
@@ -3657,3 +3927,25 @@ void DirectX::D3DXEncodeBC7(uint8_t *pBC, const XMVECTOR *pColor, uint32_t flags
     static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
     reinterpret_cast<D3DX_BC7*>(pBC)->Encode(flags, reinterpret_cast<const HDRColorA*>(pColor));
 }
+
+_Use_decl_annotations_
+void DirectX::D3DXEncodeBC7Batch(uint8_t *pBC, const XMVECTOR *pColor, size_t count, uint32_t flags) noexcept
+{
+    assert(pBC && pColor);
+    static_assert(sizeof(D3DX_BC7) == 16, "D3DX_BC7 should be 16 bytes");
+
+    for (size_t j = 0; j < count; ++j)
+    {
+        const XMVECTOR* pBlock = pColor + j * NUM_PIXELS_PER_BLOCK;
+        uint8_t* pDest = pBC + j * sizeof(D3DX_BC7);
+
+        // The encoder is deterministic, so a run of identical blocks (flat fills, padding, etc.) only needs one search
+        if (j > 0 && memcmp(pBlock, pBlock - NUM_PIXELS_PER_BLOCK, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK) == 0)
+        {
+            memcpy(pDest, pDest - sizeof(D3DX_BC7), sizeof(D3DX_BC7));
+            continue;
+        }
+
+        reinterpret_cast<D3DX_BC7*>(pDest)->Encode(flags, reinterpret_cast<const HDRColorA*>(pBlock));
+    }
+}
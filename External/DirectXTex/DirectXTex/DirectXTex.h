@@ -425,6 +425,74 @@ namespace DirectX
 #endif // __cpp_lib_byte
 
 
+    //---------------------------------------------------------------------------------
+    // Pixel memory allocation
+    //   ScratchImage and Blob take their buffers from the calling thread's allocator if one
+    //   is set, otherwise from the process-wide allocator, otherwise from the CRT heap. Each
+    //   buffer is returned to the allocator it came from, so an allocator must outlive every
+    //   buffer it handed out. Returned memory must be at least 16-byte aligned.
+    class DIRECTX_TEX_API MemoryAllocator
+    {
+    public:
+        virtual ~MemoryAllocator() = default;
+
+        virtual void* __cdecl Allocate(_In_ size_t size) noexcept = 0;
+        virtual void __cdecl Free(_In_opt_ void* ptr) noexcept = 0;
+
+    protected:
+        MemoryAllocator() = default;
+        MemoryAllocator(const MemoryAllocator&) = default;
+        MemoryAllocator& operator=(const MemoryAllocator&) = default;
+    };
+
+    DIRECTX_TEX_API MemoryAllocator* __cdecl SetMemoryAllocator(_In_opt_ MemoryAllocator* allocator) noexcept;
+        // Sets the process-wide allocator (nullptr for the CRT heap) and returns the previous one
+
+    DIRECTX_TEX_API MemoryAllocator* __cdecl SetThreadMemoryAllocator(_In_opt_ MemoryAllocator* allocator) noexcept;
+        // Sets an allocator for the calling thread only, which takes precedence over the process-wide one
+
+    struct PoolStats
+    {
+        uint64_t    allocations;        // Allocate calls
+        uint64_t    recycled;           // Allocate calls served from the pool
+        uint64_t    bytesAllocated;     // Bytes handed out (rounded up to the size class)
+        uint64_t    bytesRecycled;      // Bytes handed out from the pool
+        uint64_t    pagesReused;        // 4K pages recycled rather than freshly committed, each one a page fault avoided
+        size_t      bytesRetained;      // Bytes currently held for reuse
+    };
+
+    //---------------------------------------------------------------------------------
+    // Size-class pool allocator
+    //   Requests are rounded up to a size class (four per power of two, 4K minimum), and freed
+    //   buffers are kept for reuse by later requests of the same class until the pool holds
+    //   maxRetained bytes. Install one per worker thread with SetThreadMemoryAllocator to give
+    //   each thread its own arena, or one process-wide with SetMemoryAllocator.
+    class DIRECTX_TEX_API PooledAllocator : public MemoryAllocator
+    {
+    public:
+        explicit PooledAllocator(_In_ size_t maxRetained = 0) noexcept;
+            // maxRetained of 0 uses the default (512 MB)
+
+        ~PooledAllocator() override;
+
+        PooledAllocator(const PooledAllocator&) = delete;
+        PooledAllocator& operator=(const PooledAllocator&) = delete;
+
+        void* __cdecl Allocate(_In_ size_t size) noexcept override;
+        void __cdecl Free(_In_opt_ void* ptr) noexcept override;
+
+        void __cdecl Trim() noexcept;
+            // Releases every retained buffer back to the CRT heap
+
+        PoolStats __cdecl GetStats() const noexcept;
+
+    private:
+        struct Impl;
+
+        Impl* m_impl;
+    };
+
+
     //---------------------------------------------------------------------------------
     // Bitmap image container
     struct Image
@@ -441,9 +509,9 @@ namespace DirectX
     {
     public:
         ScratchImage() noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) {}
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_allocator(nullptr) {}
         ScratchImage(ScratchImage&& moveFrom) noexcept
-            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr) { *this = std::move(moveFrom); }
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_memory(nullptr), m_allocator(nullptr) { *this = std::move(moveFrom); }
         ~ScratchImage() { Release(); }
 
         ScratchImage& __cdecl operator= (ScratchImage&& moveFrom) noexcept;
@@ -466,6 +534,7 @@ namespace DirectX
         void __cdecl Release() noexcept;
 
         bool __cdecl OverrideFormat(_In_ DXGI_FORMAT f) noexcept;
+        void __cdecl OverrideAlphaMode(_In_ TEX_ALPHA_MODE mode) noexcept { m_metadata.SetAlphaMode(mode); }
 
         const TexMetadata& __cdecl GetMetadata() const noexcept { return m_metadata; }
         const Image* __cdecl GetImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice) const noexcept;
@@ -484,6 +553,143 @@ namespace DirectX
         TexMetadata m_metadata;
         Image*      m_image;
         uint8_t*    m_memory;
+        MemoryAllocator* m_allocator;
+    };
+
+    //---------------------------------------------------------------------------------
+    // Image container backed by a memory-mapped file
+    //   When the file needs no conversion, the images point straight into a copy-on-write
+    //   mapping (pixel data is only as aligned as the file layout). Writing through them, e.g.
+    //   with the in-place Convert/PremultiplyAlpha/FlipRotate, copies the touched pages and
+    //   never modifies the file. Otherwise the file is decoded into owned memory and the
+    //   mapping is closed.
+    class DIRECTX_TEX_API MappedImage
+    {
+    public:
+        MappedImage() noexcept
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_pixels(nullptr), m_view(nullptr), m_viewSize(0) {}
+        MappedImage(MappedImage&& moveFrom) noexcept
+            : m_nimages(0), m_size(0), m_metadata{}, m_image(nullptr), m_pixels(nullptr), m_view(nullptr), m_viewSize(0) { *this = std::move(moveFrom); }
+        ~MappedImage() { Release(); }
+
+        MappedImage& __cdecl operator= (MappedImage&& moveFrom) noexcept;
+
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+
+        HRESULT __cdecl InitializeFromDDSFile(_In_z_ const wchar_t* szFile, _In_ DDS_FLAGS flags = DDS_FLAGS_NONE) noexcept;
+
+        void __cdecl Release() noexcept;
+
+        const TexMetadata& __cdecl GetMetadata() const noexcept { return m_metadata; }
+        const Image* __cdecl GetImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice) const noexcept;
+
+        const Image* __cdecl GetImages() const noexcept;
+        size_t __cdecl GetImageCount() const noexcept;
+
+        const uint8_t* __cdecl GetPixels() const noexcept;
+        size_t __cdecl GetPixelsSize() const noexcept;
+
+        bool __cdecl IsMapped() const noexcept { return m_view != nullptr; }
+            // true if the images point into the file mapping rather than owned memory
+
+    private:
+        size_t          m_nimages;
+        size_t          m_size;
+        TexMetadata     m_metadata;
+        Image*          m_image;
+        const uint8_t*  m_pixels;
+        void*           m_view;
+        size_t          m_viewSize;
+        ScratchImage    m_converted;
+    };
+
+    //---------------------------------------------------------------------------------
+    // Incremental DDS reader
+    //   Opens the file once and reads individual subresources on demand into caller-provided
+    //   images, so only the requested mips/items/slices are ever resident. Legacy formats are
+    //   expanded per subresource. ReadImage is safe to call from multiple threads at once.
+    class DIRECTX_TEX_API DDSReader
+    {
+    public:
+        DDSReader() noexcept
+            : m_file(-1), m_fileSize(0), m_metadata{}, m_flags(DDS_FLAGS_NONE), m_convFlags(0), m_nimages(0), m_offsets(nullptr), m_palette(nullptr) {}
+        DDSReader(DDSReader&& moveFrom) noexcept
+            : m_file(-1), m_fileSize(0), m_metadata{}, m_flags(DDS_FLAGS_NONE), m_convFlags(0), m_nimages(0), m_offsets(nullptr), m_palette(nullptr) { *this = std::move(moveFrom); }
+        ~DDSReader() { Close(); }
+
+        DDSReader& __cdecl operator= (DDSReader&& moveFrom) noexcept;
+
+        DDSReader(const DDSReader&) = delete;
+        DDSReader& operator=(const DDSReader&) = delete;
+
+        HRESULT __cdecl Open(_In_z_ const wchar_t* szFile, _In_ DDS_FLAGS flags = DDS_FLAGS_NONE, _Out_opt_ DDSMetaData* ddPixelFormat = nullptr) noexcept;
+
+        void __cdecl Close() noexcept;
+
+        bool __cdecl IsOpen() const noexcept { return m_offsets != nullptr; }
+
+        const TexMetadata& __cdecl GetMetadata() const noexcept { return m_metadata; }
+        size_t __cdecl GetImageCount() const noexcept { return m_nimages; }
+
+        HRESULT __cdecl ReadImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice, _In_ const Image& dest) const noexcept;
+            // dest must match the subresource format and size; its row pitch may be larger than ComputePitch returns
+
+        HRESULT __cdecl ReadMipLevels(_In_ size_t firstMip, _In_ size_t mipLevels, _Out_ ScratchImage& image) const noexcept;
+            // Loads a range of mips for every item/slice; mipLevels of 0 reads through the smallest mip
+
+    private:
+        intptr_t    m_file;
+        uint64_t    m_fileSize;
+        TexMetadata m_metadata;
+        DDS_FLAGS   m_flags;
+        uint32_t    m_convFlags;
+        size_t      m_nimages;
+        uint64_t*   m_offsets;
+        uint32_t*   m_palette;
+    };
+
+    //---------------------------------------------------------------------------------
+    // Incremental DDS writer
+    //   Writes the header from the metadata up front, then accepts subresources in any order,
+    //   each landing at its precomputed file offset. WriteImage is safe to call from multiple
+    //   threads for distinct subresources. Closing before a successful Finalize discards the
+    //   file on Windows (matching SaveToDDSFile's failure behavior).
+    class DIRECTX_TEX_API DDSWriter
+    {
+    public:
+        DDSWriter() noexcept
+            : m_file(-1), m_metadata{}, m_nimages(0), m_offsets(nullptr), m_written(nullptr) {}
+        DDSWriter(DDSWriter&& moveFrom) noexcept
+            : m_file(-1), m_metadata{}, m_nimages(0), m_offsets(nullptr), m_written(nullptr) { *this = std::move(moveFrom); }
+        ~DDSWriter() { Close(); }
+
+        DDSWriter& __cdecl operator= (DDSWriter&& moveFrom) noexcept;
+
+        DDSWriter(const DDSWriter&) = delete;
+        DDSWriter& operator=(const DDSWriter&) = delete;
+
+        HRESULT __cdecl Create(_In_z_ const wchar_t* szFile, _In_ const TexMetadata& metadata, _In_ DDS_FLAGS flags = DDS_FLAGS_NONE) noexcept;
+
+        HRESULT __cdecl WriteImage(_In_ size_t mip, _In_ size_t item, _In_ size_t slice, _In_ const Image& image) noexcept;
+            // image must match the subresource format and size; any row pitch at least as large as ComputePitch's is accepted
+
+        HRESULT __cdecl Finalize() noexcept;
+            // Fails if any subresource was never written, otherwise closes the completed file
+
+        void __cdecl Close() noexcept;
+
+        bool __cdecl IsOpen() const noexcept { return m_offsets != nullptr; }
+
+        const TexMetadata& __cdecl GetMetadata() const noexcept { return m_metadata; }
+        size_t __cdecl GetImageCount() const noexcept { return m_nimages; }
+
+    private:
+        intptr_t    m_file;
+        TexMetadata m_metadata;
+        size_t      m_nimages;
+        uint64_t*   m_offsets;
+        uint8_t*    m_written;
     };
 
     //---------------------------------------------------------------------------------
@@ -491,8 +697,8 @@ namespace DirectX
     class DIRECTX_TEX_API Blob
     {
     public:
-        Blob() noexcept : m_buffer(nullptr), m_size(0) {}
-        Blob(Blob&& moveFrom) noexcept : m_buffer(nullptr), m_size(0) { *this = std::move(moveFrom); }
+        Blob() noexcept : m_buffer(nullptr), m_size(0), m_allocator(nullptr) {}
+        Blob(Blob&& moveFrom) noexcept : m_buffer(nullptr), m_size(0), m_allocator(nullptr) { *this = std::move(moveFrom); }
         ~Blob() { Release(); }
 
         Blob& __cdecl operator= (Blob&& moveFrom) noexcept;
@@ -519,6 +725,7 @@ namespace DirectX
     private:
         uint8_t* m_buffer;
         size_t   m_size;
+        MemoryAllocator* m_allocator;
     };
 
     //---------------------------------------------------------------------------------
@@ -594,6 +801,12 @@ namespace DirectX
         _Out_opt_ DDSMetaData* ddPixelFormat,
         _Out_ ScratchImage& image) noexcept;
 
+    DIRECTX_TEX_API HRESULT __cdecl LoadFromDDSFileMapped(
+        _In_z_ const wchar_t* szFile,
+        _In_ DDS_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata, _Out_ MappedImage& image) noexcept;
+        // Zero-copy when no legacy format conversion is required
+
     DIRECTX_TEX_API HRESULT __cdecl SaveToDDSMemory(
         _In_ const Image& image,
         _In_ DDS_FLAGS flags,
@@ -708,6 +921,55 @@ namespace DirectX
 #endif
 #endif // __cpp_lib_byte
 
+    //---------------------------------------------------------------------------------
+    // Asynchronous batch loading
+    //   File reads overlap with decoding; bytes that have been read but not yet decoded are
+    //   held under a memory budget. The file type is detected from its contents: DDS, HDR,
+    //   then any WIC codec on Windows, otherwise TGA.
+
+    struct BatchLoadOptions
+    {
+        size_t      ioThreads;      // 0 for the default (2)
+        size_t      decodeThreads;  // 0 for one per hardware thread
+        size_t      memoryBudget;   // 0 for the default (256 MiB); a single larger file is still loaded on its own
+        DDS_FLAGS   ddsFlags;
+        TGA_FLAGS   tgaFlags;
+        WIC_FLAGS   wicFlags;       // Windows only
+    };
+
+    using BatchLoadCallback = std::function<void __cdecl(size_t index, HRESULT hr, ScratchImage& image)>;
+        // Invoked on a worker thread (possibly several at once) as each file completes; move from image to keep it
+
+    class DIRECTX_TEX_API BatchLoader
+    {
+    public:
+        BatchLoader() noexcept : m_impl(nullptr) {}
+        BatchLoader(BatchLoader&& moveFrom) noexcept : m_impl(nullptr) { *this = std::move(moveFrom); }
+        ~BatchLoader() { Release(); }
+
+        BatchLoader& __cdecl operator= (BatchLoader&& moveFrom) noexcept;
+
+        BatchLoader(const BatchLoader&) = delete;
+        BatchLoader& operator=(const BatchLoader&) = delete;
+
+        HRESULT __cdecl Initialize(_In_opt_ const BatchLoadOptions* options = nullptr) noexcept;
+            // Starts the worker threads
+
+        HRESULT __cdecl Submit(_In_z_ const wchar_t* szFile, _In_ size_t index, _In_ BatchLoadCallback callback) noexcept;
+        HRESULT __cdecl Submit(_In_reads_(count) const wchar_t* const* files, _In_ size_t count, _In_ BatchLoadCallback callback) noexcept;
+            // Queues files without blocking; index (or the position in files) is passed back to the callback
+
+        void __cdecl Wait() noexcept;
+            // Blocks until every submitted file has been delivered to its callback
+
+        void __cdecl Release() noexcept;
+            // Finishes outstanding work, then stops the worker threads
+
+    private:
+        struct Impl;
+        Impl* m_impl;
+    };
+
     //---------------------------------------------------------------------------------
     // Texture conversion, resizing, mipmap generation, and block compression
 
@@ -727,6 +989,9 @@ namespace DirectX
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ TEX_FR_FLAGS flags, _Out_ ScratchImage& result) noexcept;
         // Flip and/or rotate image
+
+    DIRECTX_TEX_API HRESULT __cdecl FlipRotate(_Inout_ ScratchImage& image, _In_ TEX_FR_FLAGS flags) noexcept;
+        // Flip and/or rotate in place; returns HRESULT_E_NOT_SUPPORTED for 90/270 rotations or non-byte-addressable formats
 #endif
 
     enum TEX_FILTER_FLAGS : uint32_t
@@ -767,7 +1032,9 @@ namespace DirectX
         TEX_FILTER_BOX = 0x400000,
         TEX_FILTER_FANT = 0x400000, // Equiv to Box filtering for mipmap generation
         TEX_FILTER_TRIANGLE = 0x500000,
-        // Filtering mode to use for any required image resizing
+        TEX_FILTER_LANCZOS = 0x600000,
+        TEX_FILTER_KAISER = 0x700000,
+        // Filtering mode to use for any required image resizing (Lanczos and Kaiser are only supported by Resize)
 
         TEX_FILTER_SRGB_IN = 0x1000000,
         TEX_FILTER_SRGB_OUT = 0x2000000,
@@ -781,6 +1048,9 @@ namespace DirectX
 
         TEX_FILTER_FORCE_WIC = 0x20000000,
         // Forces use of the WIC path even when logic would have picked a non-WIC path when both are an option
+
+        TEX_FILTER_PARALLEL = 0x40000000,
+        // Non-WIC conversion and resizing use multithreading; results are identical to the single-threaded path
     };
 
     constexpr uint32_t TEX_FILTER_DITHER_MASK = 0xF0000;
@@ -823,6 +1093,10 @@ namespace DirectX
         _In_ std::function<bool __cdecl(size_t, size_t)> statusCallBack = nullptr);
         // Convert the image to a new format
 
+    DIRECTX_TEX_API HRESULT __cdecl Convert(
+        _Inout_ ScratchImage& image, _In_ DXGI_FORMAT format, _In_ TEX_FILTER_FLAGS filter, _In_ float threshold) noexcept;
+        // Convert in place; returns HRESULT_E_NOT_SUPPORTED unless both formats have the same pitch
+
     DIRECTX_TEX_API HRESULT __cdecl ConvertToSinglePlane(_In_ const Image& srcImage, _Out_ ScratchImage& image) noexcept;
     DIRECTX_TEX_API HRESULT __cdecl ConvertToSinglePlane(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
@@ -875,6 +1149,9 @@ namespace DirectX
         _In_ TEX_PMALPHA_FLAGS flags, _Out_ ScratchImage& result) noexcept;
         // Converts to/from a premultiplied alpha version of the texture
 
+    DIRECTX_TEX_API HRESULT __cdecl PremultiplyAlpha(_Inout_ ScratchImage& image, _In_ TEX_PMALPHA_FLAGS flags) noexcept;
+        // In-place version; updates the alpha mode of the image metadata
+
     enum TEX_COMPRESS_FLAGS : uint32_t
     {
         TEX_COMPRESS_DEFAULT = 0,
@@ -897,6 +1174,22 @@ namespace DirectX
         TEX_COMPRESS_BC7_QUICK = 0x100000,
         // Minimal modes (usually mode 6) for BC7 compression
 
+        TEX_COMPRESS_BC7_QUALITY_0 = 0x200000,
+        TEX_COMPRESS_BC7_QUALITY_1 = 0x400000,
+        TEX_COMPRESS_BC7_QUALITY_2 = 0x600000,
+        TEX_COMPRESS_BC7_QUALITY_3 = 0x800000,
+        TEX_COMPRESS_BC7_QUALITY_4 = 0xA00000,
+        TEX_COMPRESS_BC7_QUALITY_5 = 0xC00000,
+        TEX_COMPRESS_BC7_QUALITY_MASK = 0xE00000,
+        // Graded BC7 search effort from 0 (fastest) to 5 (same as the default full search)
+        // Lower levels try fewer modes and shapes, and stop once a per-block error target is met
+
+        TEX_COMPRESS_BC_HIGH = 0x4000000,
+        // Exhaustive cluster-fit endpoint search for BC1-3 and wider endpoint search for BC4-5 compression; slower, lower error
+
+        TEX_COMPRESS_BC6H_FAST = 0x8000000,
+        // Reduced shape search for BC6H compression; two-region modes are skipped for low dynamic range blocks
+
         TEX_COMPRESS_SRGB_IN = 0x1000000,
         TEX_COMPRESS_SRGB_OUT = 0x2000000,
         TEX_COMPRESS_SRGB = (TEX_COMPRESS_SRGB_IN | TEX_COMPRESS_SRGB_OUT),
@@ -905,16 +1198,72 @@ namespace DirectX
 
         TEX_COMPRESS_PARALLEL = 0x10000000,
         // Compress is free to use multithreading to improve performance (by default it does not use multithreading)
+
+        TEX_COMPRESS_PARALLEL_BLOCKS = 0x20000000,
+        // Schedules individual blocks with OpenMP instead of rows of blocks (implies TEX_COMPRESS_PARALLEL)
     };
 
     constexpr float TEX_ALPHA_WEIGHT_DEFAULT = 1.0f;
         // Default value for alpha weight used for GPU BC7 compression
 
+    struct BlockCacheStats
+    {
+        uint64_t    hits;
+        uint64_t    misses;
+    };
+
+    class DIRECTX_TEX_API BlockCache
+    {
+        // Encoded blocks keyed by a 128-bit hash of the 16 source texels, the BC format, and
+        // the compression settings, so repeated blocks are encoded once across images and,
+        // through a cache file, across runs. Lookups and inserts are lock-free and may come
+        // from any number of threads; once a probe sequence is full new blocks are dropped.
+    public:
+        BlockCache() noexcept : m_impl(nullptr) {}
+        BlockCache(BlockCache&& moveFrom) noexcept : m_impl(nullptr) { *this = std::move(moveFrom); }
+        ~BlockCache() { Release(); }
+
+        BlockCache& __cdecl operator= (BlockCache&& moveFrom) noexcept;
+
+        BlockCache(const BlockCache&) = delete;
+        BlockCache& operator=(const BlockCache&) = delete;
+
+        HRESULT __cdecl Initialize(_In_ size_t maxBlocks = 0) noexcept;
+            // 0 for the default (1M blocks, about 40 MiB)
+
+        HRESULT __cdecl LoadFromFile(_In_z_ const wchar_t* szFile) noexcept;
+        HRESULT __cdecl SaveToFile(_In_z_ const wchar_t* szFile) const noexcept;
+            // Load adds the blocks of a file written by Save to the ones already cached; a file
+            // that fails validation adds nothing, one from another encoder version is rejected
+
+        bool __cdecl Find(_In_ uint64_t keyLo, _In_ uint64_t keyHi, _Out_writes_bytes_(size) uint8_t* pBlock, _In_ size_t size) noexcept;
+        void __cdecl Insert(_In_ uint64_t keyLo, _In_ uint64_t keyHi, _In_reads_bytes_(size) const uint8_t* pBlock, _In_ size_t size) noexcept;
+            // Used by Compress/CompressEx; blocks are at most 16 bytes
+
+        BlockCacheStats __cdecl GetStats() const noexcept;
+            // Find hits and misses since Initialize
+
+        size_t __cdecl GetBlockCount() const noexcept;
+
+        void __cdecl Release() noexcept;
+
+    private:
+        struct Impl;
+        Impl* m_impl;
+    };
+
     struct CompressOptions
     {
         TEX_COMPRESS_FLAGS flags;
         float              threshold;
         float              alphaWeight;
+        float              rdoLambda;
+            // When > 0, BC1, BC3, BC4, BC5, and BC7 blocks are rewritten after encoding to repeat
+            // nearby blocks, trading error for better LZ compression of the file (CPU codecs only)
+        BlockCache*        blockCache;
+            // Optional; blocks found in the cache are copied instead of encoded (CPU codecs only)
+        BlockCacheStats*   blockCacheStats;
+            // Optional; receives the cache hits and misses of this call
     };
 
     DIRECTX_TEX_API HRESULT __cdecl Compress(
@@ -1048,6 +1397,12 @@ namespace DirectX
         _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
             _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
         ScratchImage& result);
+    DIRECTX_TEX_API HRESULT __cdecl TransformImage(
+        _Inout_ ScratchImage& image,
+        _In_ std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels,
+            _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+        _In_ TEX_FILTER_FLAGS flags = TEX_FILTER_DEFAULT);
+        // In-place version; with TEX_FILTER_PARALLEL, pixelFunc is called concurrently for different rows
 
     //---------------------------------------------------------------------------------
     // WIC utility code
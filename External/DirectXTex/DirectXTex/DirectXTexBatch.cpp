@@ -0,0 +1,412 @@
+//-------------------------------------------------------------------------------------
+// DirectXTexBatch.cpp
+//
+// DirectX Texture Library - Asynchronous batch loading
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//-------------------------------------------------------------------------------------
+
+#include "DirectXTexP.h"
+
+#include "DDS.h"
+
+#include <condition_variable>
+#include <deque>
+#include <string>
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+
+namespace
+{
+    constexpr size_t c_DefaultIOThreads = 2;
+    constexpr size_t c_DefaultMemoryBudget = 256 * 1024 * 1024;
+
+    struct PendingFile
+    {
+        std::wstring        path;
+        size_t              index;
+        BatchLoadCallback   callback;
+    };
+
+    struct LoadedFile
+    {
+        PendingFile         file;
+        HRESULT             hr;
+        size_t              reserved;
+        Blob                contents;
+    };
+
+    //-------------------------------------------------------------------------------------
+    // Matches the signatures of the WIC container formats (PNG, JPEG, BMP, GIF, TIFF)
+    //-------------------------------------------------------------------------------------
+    bool IsWICSignature(_In_reads_bytes_(size) const uint8_t* pSource, size_t size) noexcept
+    {
+        if (size >= 4 && pSource[0] == 0x89 && pSource[1] == 'P' && pSource[2] == 'N' && pSource[3] == 'G')
+            return true;
+
+        if (size >= 2 && pSource[0] == 0xFF && pSource[1] == 0xD8)
+            return true;
+
+        if (size >= 2 && pSource[0] == 'B' && pSource[1] == 'M')
+            return true;
+
+        if (size >= 4 && pSource[0] == 'G' && pSource[1] == 'I' && pSource[2] == 'F' && pSource[3] == '8')
+            return true;
+
+        if (size >= 4
+            && ((pSource[0] == 'I' && pSource[1] == 'I' && pSource[2] == '*' && pSource[3] == 0)
+                || (pSource[0] == 'M' && pSource[1] == 'M' && pSource[2] == 0 && pSource[3] == '*')))
+            return true;
+
+        return false;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Picks the codec from the file contents rather than the extension
+    //-------------------------------------------------------------------------------------
+    HRESULT DecodeFromMemory(
+        _In_ const Blob& contents,
+        _In_ const BatchLoadOptions& options,
+        _Out_ ScratchImage& image) noexcept
+    {
+        const uint8_t* pSource = contents.GetConstBufferPointer();
+        const size_t size = contents.GetBufferSize();
+
+        if (size >= sizeof(uint32_t) && *reinterpret_cast<const uint32_t*>(pSource) == DDS_MAGIC)
+            return LoadFromDDSMemory(pSource, size, options.ddsFlags, nullptr, image);
+
+        // Both Radiance signatures ("#?RADIANCE" and "#?RGBE") share this prefix
+        if (size >= 2 && pSource[0] == '#' && pSource[1] == '?')
+            return LoadFromHDRMemory(pSource, size, nullptr, image);
+
+        // A matched signature reports the WIC result rather than retrying the data as TGA
+        if (IsWICSignature(pSource, size))
+        {
+        #ifdef _WIN32
+            return LoadFromWICMemory(pSource, size, options.wicFlags, nullptr, image);
+        #else
+            return HRESULT_E_NOT_SUPPORTED;
+        #endif
+        }
+
+        // TGA has no signature, so it is the last resort
+        return LoadFromTGAMemory(pSource, size, options.tgaFlags, nullptr, image);
+    }
+}
+
+
+//=====================================================================================
+// BatchLoader - Reads on I/O threads, decodes on worker threads
+//=====================================================================================
+
+struct BatchLoader::Impl
+{
+    BatchLoadOptions            options;
+
+    std::mutex                  mutex;
+    std::condition_variable     readCV;     // pending files or shutdown
+    std::condition_variable     decodeCV;   // loaded files or shutdown
+    std::condition_variable     budgetCV;   // bytes in flight were released
+    std::condition_variable     idleCV;     // a file was delivered
+
+    std::deque<PendingFile>     pending;
+    std::deque<LoadedFile>      loaded;
+    size_t                      bytesInFlight = 0;
+    size_t                      outstanding = 0;
+    bool                        shutdown = false;
+
+    std::vector<std::thread>    threads;
+
+    Impl() noexcept : options{} {}
+
+    void ReadLoop() noexcept;
+    void DecodeLoop() noexcept;
+    void Stop() noexcept;
+};
+
+void BatchLoader::Impl::ReadLoop() noexcept
+{
+    for (;;)
+    {
+        LoadedFile item = {};
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            readCV.wait(lock, [this] { return shutdown || !pending.empty(); });
+            if (pending.empty())
+                return;
+
+            item.file = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        intptr_t file = INVALID_FILE;
+        uint64_t fileSize = 0;
+        item.hr = OpenFileForRead(item.file.path.c_str(), file, fileSize);
+        if (SUCCEEDED(item.hr))
+        {
+            if (fileSize > SIZE_MAX)
+            {
+                item.hr = HRESULT_E_FILE_TOO_LARGE;
+            }
+            else if (!fileSize)
+            {
+                item.hr = E_FAIL;
+            }
+        }
+
+        if (SUCCEEDED(item.hr))
+        {
+            // Wait for room in the budget; a file larger than the whole budget goes through alone
+            item.reserved = static_cast<size_t>(fileSize);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                budgetCV.wait(lock, [this, &item]
+                    {
+                        return !bytesInFlight || (bytesInFlight + item.reserved <= options.memoryBudget);
+                    });
+                bytesInFlight += item.reserved;
+            }
+
+            item.hr = item.contents.Initialize(item.reserved);
+            if (SUCCEEDED(item.hr))
+            {
+                item.hr = ReadFileAt(file, 0, item.contents.GetBufferPointer(), item.reserved);
+            }
+        }
+
+        CloseFile(file);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            loaded.emplace_back(std::move(item));
+        }
+        decodeCV.notify_one();
+    }
+}
+
+void BatchLoader::Impl::DecodeLoop() noexcept
+{
+#ifdef _WIN32
+    // WIC needs COM on every thread that decodes
+    const HRESULT hrCOM = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+    for (;;)
+    {
+        LoadedFile item = {};
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            decodeCV.wait(lock, [this] { return shutdown || !loaded.empty(); });
+            if (loaded.empty())
+                break;
+
+            item = std::move(loaded.front());
+            loaded.pop_front();
+        }
+
+        ScratchImage image;
+        HRESULT hr = item.hr;
+        if (SUCCEEDED(hr))
+        {
+            hr = DecodeFromMemory(item.contents, options, image);
+        }
+
+        // The encoded bytes are no longer needed, so hand their share of the budget back
+        item.contents.Release();
+        if (item.reserved)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                bytesInFlight -= item.reserved;
+            }
+            budgetCV.notify_all();
+        }
+
+        if (FAILED(hr))
+        {
+            image.Release();
+        }
+
+        if (item.file.callback)
+        {
+            try
+            {
+                item.file.callback(item.file.index, hr, image);
+            }
+            catch (...)
+            {
+                // Exceptions must not escape the worker thread
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --outstanding;
+        }
+        idleCV.notify_all();
+    }
+
+#ifdef _WIN32
+    if (SUCCEEDED(hrCOM))
+        CoUninitialize();
+#endif
+}
+
+void BatchLoader::Impl::Stop() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shutdown = true;
+    }
+    readCV.notify_all();
+    decodeCV.notify_all();
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    threads.clear();
+}
+
+
+//-------------------------------------------------------------------------------------
+// Public API
+//-------------------------------------------------------------------------------------
+BatchLoader& BatchLoader::operator= (BatchLoader&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_impl = moveFrom.m_impl;
+        moveFrom.m_impl = nullptr;
+    }
+    return *this;
+}
+
+_Use_decl_annotations_
+HRESULT BatchLoader::Initialize(const BatchLoadOptions* options) noexcept
+{
+    Release();
+
+    std::unique_ptr<Impl> impl(new (std::nothrow) Impl);
+    if (!impl)
+        return E_OUTOFMEMORY;
+
+    if (options)
+    {
+        impl->options = *options;
+    }
+
+    if (!impl->options.ioThreads)
+        impl->options.ioThreads = c_DefaultIOThreads;
+
+    if (!impl->options.decodeThreads)
+        impl->options.decodeThreads = GetWorkerCount(SIZE_MAX);
+
+    if (!impl->options.memoryBudget)
+        impl->options.memoryBudget = c_DefaultMemoryBudget;
+
+    try
+    {
+        impl->threads.reserve(impl->options.ioThreads + impl->options.decodeThreads);
+
+        for (size_t j = 0; j < impl->options.ioThreads; ++j)
+        {
+            impl->threads.emplace_back(&Impl::ReadLoop, impl.get());
+        }
+
+        for (size_t j = 0; j < impl->options.decodeThreads; ++j)
+        {
+            impl->threads.emplace_back(&Impl::DecodeLoop, impl.get());
+        }
+    }
+    catch (...)
+    {
+        impl->Stop();
+        return E_OUTOFMEMORY;
+    }
+
+    m_impl = impl.release();
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT BatchLoader::Submit(const wchar_t* szFile, size_t index, BatchLoadCallback callback) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    if (!m_impl)
+        return E_FAIL;
+
+    try
+    {
+        PendingFile file = { szFile, index, std::move(callback) };
+
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        m_impl->pending.emplace_back(std::move(file));
+        ++m_impl->outstanding;
+    }
+    catch (...)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    m_impl->readCV.notify_one();
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT BatchLoader::Submit(const wchar_t* const* files, size_t count, BatchLoadCallback callback) noexcept
+{
+    if (!files || !count)
+        return E_INVALIDARG;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        HRESULT hr;
+        try
+        {
+            hr = Submit(files[index], index, callback);
+        }
+        catch (...)
+        {
+            // Copying the callback failed
+            hr = E_OUTOFMEMORY;
+        }
+
+        if (FAILED(hr))
+            return hr;
+    }
+
+    return S_OK;
+}
+
+void BatchLoader::Wait() noexcept
+{
+    if (!m_impl)
+        return;
+
+    std::unique_lock<std::mutex> lock(m_impl->mutex);
+    m_impl->idleCV.wait(lock, [this] { return !m_impl->outstanding; });
+}
+
+void BatchLoader::Release() noexcept
+{
+    if (!m_impl)
+        return;
+
+    Wait();
+
+    m_impl->Stop();
+
+    delete m_impl;
+    m_impl = nullptr;
+}
@@ -0,0 +1,368 @@
+//-------------------------------------------------------------------------------------
+// DirectXTexBlockCache.cpp
+//
+// DirectX Texture Library - Encoded block cache
+//
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// http://go.microsoft.com/fwlink/?LinkId=248926
+//-------------------------------------------------------------------------------------
+
+#include "DirectXTexP.h"
+
+#include "BC.h"
+
+using namespace DirectX;
+using namespace DirectX::Internal;
+
+namespace
+{
+    constexpr size_t c_DefaultMaxBlocks = 1024 * 1024;
+    constexpr size_t c_MaxProbes = 8;
+    constexpr size_t c_MaxBlockSize = 16;
+
+    constexpr uint32_t BLOCK_CACHE_MAGIC = 0x48434342; // "BCCH"
+    constexpr uint32_t BLOCK_CACHE_VERSION = 3;
+
+    enum ENTRY_STATE : uint32_t
+    {
+        ENTRY_EMPTY = 0,
+        ENTRY_WRITING,
+        ENTRY_READY,
+    };
+
+    // Key and data are written once while the entry is ENTRY_WRITING, then published by the
+    // release store of ENTRY_READY; readers that observe ENTRY_READY can use them without locks
+    struct Entry
+    {
+        std::atomic<uint32_t>   state{ ENTRY_EMPTY };
+        uint32_t                size = 0;
+        uint64_t                keyLo = 0;
+        uint64_t                keyHi = 0;
+        uint8_t                 block[c_MaxBlockSize] = {};
+    };
+
+#pragma pack(push,1)
+    struct CacheFileHeader
+    {
+        uint32_t    magic;
+        uint32_t    version;
+        uint32_t    encoderVersion;     // BC_ENCODER_VERSION of the build that wrote the blocks
+        uint32_t    reserved;
+        uint64_t    count;
+    };
+
+    struct CacheFileRecord
+    {
+        uint64_t    keyLo;
+        uint64_t    keyHi;
+        uint32_t    size;
+        uint32_t    reserved;
+        uint8_t     block[c_MaxBlockSize];
+    };
+#pragma pack(pop)
+
+    static_assert(sizeof(CacheFileHeader) == 24, "Block cache file header size mismatch");
+    static_assert(sizeof(CacheFileRecord) == 40, "Block cache file record size mismatch");
+}
+
+
+//=====================================================================================
+// BlockCache - Fixed-size open addressing table with bounded linear probing
+//=====================================================================================
+
+struct BlockCache::Impl
+{
+    std::unique_ptr<Entry[]>    entries;
+    size_t                      mask = 0;
+
+    std::atomic<uint64_t>       hits{ 0 };
+    std::atomic<uint64_t>       misses{ 0 };
+    std::atomic<size_t>         count{ 0 };
+
+    bool Add(uint64_t keyLo, uint64_t keyHi, _In_reads_bytes_(size) const uint8_t* pBlock, size_t size) noexcept;
+};
+
+_Use_decl_annotations_
+bool BlockCache::Impl::Add(uint64_t keyLo, uint64_t keyHi, const uint8_t* pBlock, size_t size) noexcept
+{
+    for (size_t probe = 0; probe < c_MaxProbes; ++probe)
+    {
+        Entry& entry = entries[(static_cast<size_t>(keyLo) + probe) & mask];
+
+        uint32_t state = entry.state.load(std::memory_order_acquire);
+        if (state == ENTRY_EMPTY
+            && entry.state.compare_exchange_strong(state, ENTRY_WRITING, std::memory_order_acquire))
+        {
+            entry.size = static_cast<uint32_t>(size);
+            entry.keyLo = keyLo;
+            entry.keyHi = keyHi;
+            memcpy(entry.block, pBlock, size);
+            entry.state.store(ENTRY_READY, std::memory_order_release);
+
+            count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Another thread may have just published the same block
+        if (state == ENTRY_READY && entry.keyLo == keyLo && entry.keyHi == keyHi)
+            return false;
+    }
+
+    return false;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Public API
+//-------------------------------------------------------------------------------------
+BlockCache& BlockCache::operator= (BlockCache&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_impl = moveFrom.m_impl;
+        moveFrom.m_impl = nullptr;
+    }
+    return *this;
+}
+
+_Use_decl_annotations_
+HRESULT BlockCache::Initialize(size_t maxBlocks) noexcept
+{
+    Release();
+
+    if (!maxBlocks)
+        maxBlocks = c_DefaultMaxBlocks;
+
+    if (maxBlocks > (SIZE_MAX / 2) / sizeof(Entry))
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+    // Round up to a power of two so a mask can replace the modulo
+    size_t capacity = 1;
+    while (capacity < maxBlocks)
+        capacity <<= 1;
+
+    std::unique_ptr<Impl> impl(new (std::nothrow) Impl);
+    if (!impl)
+        return E_OUTOFMEMORY;
+
+    impl->entries.reset(new (std::nothrow) Entry[capacity]);
+    if (!impl->entries)
+        return E_OUTOFMEMORY;
+
+    impl->mask = capacity - 1;
+
+    m_impl = impl.release();
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT BlockCache::LoadFromFile(const wchar_t* szFile) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    if (!m_impl)
+        return E_FAIL;
+
+    intptr_t file = INVALID_FILE;
+    uint64_t fileSize = 0;
+    HRESULT hr = OpenFileForRead(szFile, file, fileSize);
+    if (FAILED(hr))
+        return hr;
+
+    CacheFileHeader header = {};
+    if (fileSize < sizeof(CacheFileHeader))
+    {
+        hr = HRESULT_E_INVALID_DATA;
+    }
+    else
+    {
+        hr = ReadFileAt(file, 0, &header, sizeof(header));
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        if (header.magic != BLOCK_CACHE_MAGIC
+            || header.count > (fileSize - sizeof(CacheFileHeader)) / sizeof(CacheFileRecord))
+        {
+            hr = HRESULT_E_INVALID_DATA;
+        }
+        else if (header.version != BLOCK_CACHE_VERSION || header.encoderVersion != BC_ENCODER_VERSION)
+        {
+            // Blocks from another encoder revision would not match what encoding produces now
+            hr = HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+
+    // Read in bounded batches so a large cache file doesn't need a second full-size copy
+    constexpr size_t c_RecordsPerRead = 4096;
+    std::unique_ptr<CacheFileRecord[]> records;
+    if (SUCCEEDED(hr) && header.count > 0)
+    {
+        records.reset(new (std::nothrow) CacheFileRecord[c_RecordsPerRead]);
+        if (!records)
+            hr = E_OUTOFMEMORY;
+    }
+
+    // The first pass only validates, so a bad record leaves the cache as it was
+    for (size_t pass = 0; pass < 2 && SUCCEEDED(hr); ++pass)
+    {
+        uint64_t offset = sizeof(CacheFileHeader);
+        for (uint64_t remaining = header.count; remaining > 0; )
+        {
+            const size_t batch = static_cast<size_t>(std::min<uint64_t>(remaining, c_RecordsPerRead));
+
+            hr = ReadFileAt(file, offset, records.get(), batch * sizeof(CacheFileRecord));
+            if (FAILED(hr))
+                break;
+
+            for (size_t j = 0; j < batch; ++j)
+            {
+                const CacheFileRecord& rec = records[j];
+                if (!pass)
+                {
+                    if (!rec.size || rec.size > c_MaxBlockSize)
+                    {
+                        hr = HRESULT_E_INVALID_DATA;
+                        break;
+                    }
+                }
+                else
+                {
+                    std::ignore = m_impl->Add(rec.keyLo, rec.keyHi, rec.block, rec.size);
+                }
+            }
+
+            if (FAILED(hr))
+                break;
+
+            offset += uint64_t(batch) * sizeof(CacheFileRecord);
+            remaining -= batch;
+        }
+    }
+
+    CloseFile(file);
+
+    return hr;
+}
+
+_Use_decl_annotations_
+HRESULT BlockCache::SaveToFile(const wchar_t* szFile) const noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    if (!m_impl)
+        return E_FAIL;
+
+    // Only published entries are written, so saving while other threads insert is safe
+    std::vector<CacheFileRecord> records;
+    try
+    {
+        records.reserve(m_impl->count.load(std::memory_order_relaxed));
+
+        for (size_t j = 0; j <= m_impl->mask; ++j)
+        {
+            const Entry& entry = m_impl->entries[j];
+            if (entry.state.load(std::memory_order_acquire) != ENTRY_READY)
+                continue;
+
+            CacheFileRecord rec = {};
+            rec.keyLo = entry.keyLo;
+            rec.keyHi = entry.keyHi;
+            rec.size = entry.size;
+            memcpy(rec.block, entry.block, c_MaxBlockSize);
+            records.push_back(rec);
+        }
+    }
+    catch (...)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    CacheFileHeader header = {};
+    header.magic = BLOCK_CACHE_MAGIC;
+    header.version = BLOCK_CACHE_VERSION;
+    header.encoderVersion = BC_ENCODER_VERSION;
+    header.count = records.size();
+
+    const uint64_t dataSize = uint64_t(records.size()) * sizeof(CacheFileRecord);
+
+    intptr_t file = INVALID_FILE;
+    HRESULT hr = OpenFileForWrite(szFile, sizeof(CacheFileHeader) + dataSize, file);
+    if (FAILED(hr))
+        return hr;
+
+    hr = WriteFileAt(file, 0, &header, sizeof(header));
+    if (SUCCEEDED(hr) && dataSize > 0)
+    {
+        hr = WriteFileAt(file, sizeof(CacheFileHeader), records.data(), static_cast<size_t>(dataSize));
+    }
+
+    CloseFile(file);
+
+    return hr;
+}
+
+_Use_decl_annotations_
+bool BlockCache::Find(uint64_t keyLo, uint64_t keyHi, uint8_t* pBlock, size_t size) noexcept
+{
+    if (!m_impl || !pBlock)
+        return false;
+
+    for (size_t probe = 0; probe < c_MaxProbes; ++probe)
+    {
+        const Entry& entry = m_impl->entries[(static_cast<size_t>(keyLo) + probe) & m_impl->mask];
+
+        const uint32_t state = entry.state.load(std::memory_order_acquire);
+        if (state == ENTRY_EMPTY)
+            break;
+
+        if (state == ENTRY_READY
+            && entry.keyLo == keyLo && entry.keyHi == keyHi && entry.size == size)
+        {
+            memcpy(pBlock, entry.block, size);
+            m_impl->hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    m_impl->misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+_Use_decl_annotations_
+void BlockCache::Insert(uint64_t keyLo, uint64_t keyHi, const uint8_t* pBlock, size_t size) noexcept
+{
+    if (!m_impl || !pBlock || !size || size > c_MaxBlockSize)
+        return;
+
+    std::ignore = m_impl->Add(keyLo, keyHi, pBlock, size);
+}
+
+BlockCacheStats BlockCache::GetStats() const noexcept
+{
+    BlockCacheStats stats = {};
+    if (m_impl)
+    {
+        stats.hits = m_impl->hits.load(std::memory_order_relaxed);
+        stats.misses = m_impl->misses.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+size_t BlockCache::GetBlockCount() const noexcept
+{
+    return (m_impl) ? m_impl->count.load(std::memory_order_relaxed) : 0;
+}
+
+void BlockCache::Release() noexcept
+{
+    delete m_impl;
+    m_impl = nullptr;
+}
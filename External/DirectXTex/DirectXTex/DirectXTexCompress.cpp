@@ -20,6 +20,7 @@
 
 using namespace DirectX;
 using namespace DirectX::Internal;
+using namespace DirectX::PackedVector;
 
 namespace
 {
@@ -31,7 +32,10 @@ namespace
         static_assert(static_cast<int>(TEX_COMPRESS_UNIFORM) == static_cast<int>(BC_FLAGS_UNIFORM), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_USE_3SUBSETS) == static_cast<int>(BC_FLAGS_USE_3SUBSETS), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
         static_assert(static_cast<int>(TEX_COMPRESS_BC7_QUICK) == static_cast<int>(BC_FLAGS_FORCE_BC7_MODE6), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
-        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6));
+        static_assert(static_cast<int>(TEX_COMPRESS_BC7_QUALITY_MASK) == static_cast<int>(BC_FLAGS_BC7_QUALITY_MASK), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_BC_HIGH) == static_cast<int>(BC_FLAGS_CLUSTER_FIT), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        static_assert(static_cast<int>(TEX_COMPRESS_BC6H_FAST) == static_cast<int>(BC_FLAGS_BC6H_FAST), "TEX_COMPRESS_* flags should match BC_FLAGS_*");
+        return (compress & (BC_FLAGS_DITHER_RGB | BC_FLAGS_DITHER_A | BC_FLAGS_UNIFORM | BC_FLAGS_USE_3SUBSETS | BC_FLAGS_FORCE_BC7_MODE6 | BC_FLAGS_BC7_QUALITY_MASK | BC_FLAGS_CLUSTER_FIT | BC_FLAGS_BC6H_FAST));
     }
 
     constexpr TEX_FILTER_FLAGS GetSRGBFlags(_In_ TEX_COMPRESS_FLAGS compress) noexcept
@@ -68,6 +72,86 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Block cache keys
+    //
+    // Two independent 64-bit hashes over the converted encoder input (the exact float bits
+    // of the 16 texels) preceded by the format, settings, and BC_ENCODER_VERSION; the
+    // encoders are deterministic in these, so a cached block is bit-identical to what this
+    // build would produce.
+    //-------------------------------------------------------------------------------------
+    inline uint64_t MixBits(uint64_t h) noexcept
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    void ComputeBlockKey(
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pBlock,
+        DXGI_FORMAT format,
+        uint32_t bcflags,
+        float threshold,
+        _Out_writes_(2) uint64_t* key) noexcept
+    {
+        uint32_t thresholdBits;
+        memcpy(&thresholdBits, &threshold, sizeof(thresholdBits));
+
+        // Each setting gets its own word so distinct tuples can't cancel out in the seed
+        XM_ALIGNED_DATA(16) uint64_t words[4 + NUM_PIXELS_PER_BLOCK * 2];
+        words[0] = uint64_t(format);
+        words[1] = bcflags;
+        words[2] = thresholdBits;
+        words[3] = BC_ENCODER_VERSION;
+        memcpy(words + 4, pBlock, sizeof(XMVECTOR) * NUM_PIXELS_PER_BLOCK);
+
+        uint64_t lo = 0x9e3779b97f4a7c15ULL;
+        uint64_t hi = 0x632be59bd9b4e019ULL;
+        for (size_t j = 0; j < std::size(words); ++j)
+        {
+            lo = (lo ^ words[j]) * 0x100000001b3ULL;
+            lo = (lo << 31) | (lo >> 33);
+            hi = (hi + words[j]) * 0x9fb21c651e98df25ULL;
+            hi ^= hi >> 29;
+        }
+
+        key[0] = MixBits(lo);
+        key[1] = MixBits(hi ^ lo);
+    }
+
+    void EncodeBlock(
+        _Out_writes_(blocksize) uint8_t* pDest,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pBlock,
+        DXGI_FORMAT format,
+        BC_ENCODE pfEncode,
+        size_t blocksize,
+        uint32_t bcflags,
+        float threshold,
+        BlockCache* cache) noexcept
+    {
+        uint64_t key[2] = {};
+        if (cache)
+        {
+            ComputeBlockKey(pBlock, format, bcflags, threshold, key);
+            if (cache->Find(key[0], key[1], pDest, blocksize))
+                return;
+        }
+
+        if (pfEncode)
+            pfEncode(pDest, pBlock, bcflags);
+        else
+            D3DXEncodeBC1(pDest, pBlock, threshold, bcflags);
+
+        if (cache)
+        {
+            cache->Insert(key[0], key[1], pDest, blocksize);
+        }
+    }
+
+
     //-------------------------------------------------------------------------------------
     HRESULT CompressBC(
         const Image& image,
@@ -75,6 +159,7 @@ namespace
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
+        BlockCache* cache,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
         if (!image.pixels || !result.pixels)
@@ -188,10 +273,7 @@ namespace
 
                 ConvertScanline(temp, 16, result.format, format, cflags | srgb);
 
-                if (pfEncode)
-                    pfEncode(dptr, temp, bcflags);
-                else
-                    D3DXEncodeBC1(dptr, temp, threshold, bcflags);
+                EncodeBlock(dptr, temp, result.format, pfEncode, blocksize, bcflags, threshold, cache);
 
                 sptr += sbpp * 4;
                 dptr += blocksize;
@@ -213,6 +295,7 @@ namespace
         uint32_t bcflags,
         TEX_FILTER_FLAGS srgb,
         float threshold,
+        BlockCache* cache,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
         if (!image.pixels || !result.pixels)
@@ -342,10 +425,7 @@ namespace
 
             ConvertScanline(temp, 16, result.format, format, cflags | srgb);
 
-            if (pfEncode)
-                pfEncode(pDest, temp, bcflags);
-            else
-                D3DXEncodeBC1(pDest, temp, threshold, bcflags);
+            EncodeBlock(pDest, temp, result.format, pfEncode, blocksize, bcflags, threshold, cache);
 
             // Report progress when a new row is reached.
             if (x == 0 && statusCallback)
@@ -373,6 +453,599 @@ namespace
 #endif // _OPENMP
 
 
+    //-------------------------------------------------------------------------------------
+    // Loads the row of blocks starting at scanline y, converts it to the encoder's input
+    // format, and lays it out as 16 pixels per block. Partial blocks replicate edge pixels
+    // the same way CompressBC does.
+    bool LoadBlockStrip(
+        const Image& image,
+        size_t y,
+        DXGI_FORMAT outFormat,
+        TEX_FILTER_FLAGS cflags,
+        _Out_writes_(nbw * NUM_PIXELS_PER_BLOCK) XMVECTOR* pScanlines,
+        _Out_writes_(nbw * NUM_PIXELS_PER_BLOCK) XMVECTOR* pBlocks,
+        size_t nbw) noexcept
+    {
+        static const size_t uSrc[] = { 0, 0, 0, 1 };
+
+        const size_t stride = nbw * 4;
+        const size_t ph = std::min<size_t>(4, image.height - y);
+        assert(ph > 0 && image.width <= stride);
+
+        const uint8_t *pSrc = image.pixels + y * image.rowPitch;
+        for (size_t t = 0; t < ph; ++t)
+        {
+            XMVECTOR* row = pScanlines + t * stride;
+            if (!LoadScanline(row, image.width, pSrc, image.rowPitch, image.format))
+                return false;
+
+            pSrc += image.rowPitch;
+
+            // Columns fill in ascending order, so column 3 reads column 1 after it was replicated
+            const size_t pw = image.width - (nbw - 1) * 4;
+            XMVECTOR* lastBlock = row + (nbw - 1) * 4;
+            for (size_t s = pw; s < 4; ++s)
+            {
+                lastBlock[s] = lastBlock[uSrc[s]];
+            }
+        }
+
+        for (size_t b = 0; b < nbw; ++b)
+        {
+            XMVECTOR* block = pBlocks + b * NUM_PIXELS_PER_BLOCK;
+            for (size_t t = 0; t < 4; ++t)
+            {
+                // Only the first ph rows were loaded, so missing rows must not point past them
+                const XMVECTOR* row = pScanlines + ((t < ph) ? t : std::min(uSrc[t], ph - 1)) * stride + b * 4;
+                block[(t << 2) | 0] = row[0];
+                block[(t << 2) | 1] = row[1];
+                block[(t << 2) | 2] = row[2];
+                block[(t << 2) | 3] = row[3];
+            }
+        }
+
+        ConvertScanline(pBlocks, nbw * NUM_PIXELS_PER_BLOCK, outFormat, image.format, cflags);
+        return true;
+    }
+
+    void EncodeBlockStrip(
+        _Out_writes_(nbw * blocksize) uint8_t* pDest,
+        _In_reads_(nbw * NUM_PIXELS_PER_BLOCK) const XMVECTOR* pBlocks,
+        size_t nbw,
+        DXGI_FORMAT format,
+        BC_ENCODE pfEncode,
+        size_t blocksize,
+        uint32_t bcflags,
+        float threshold,
+        BlockCache* cache) noexcept
+    {
+        if (pfEncode == D3DXEncodeBC7)
+        {
+            if (!cache)
+            {
+                D3DXEncodeBC7Batch(pDest, pBlocks, nbw, bcflags);
+                return;
+            }
+
+            // Hits are copied in place; each run of misses still goes through the batch encoder
+            constexpr size_t c_MaxRun = 64;
+            uint64_t keys[2 * c_MaxRun];
+            for (size_t b = 0; b < nbw; )
+            {
+                size_t start = b;
+                size_t run = 0;
+                while (b < nbw && run < c_MaxRun)
+                {
+                    uint64_t* key = keys + 2 * run;
+                    ComputeBlockKey(pBlocks + b * NUM_PIXELS_PER_BLOCK, format, bcflags, threshold, key);
+                    const bool hit = cache->Find(key[0], key[1], pDest + b * blocksize, blocksize);
+                    ++b;
+
+                    if (!hit)
+                        ++run;
+                    else if (run)
+                        break;
+                    else
+                        start = b;
+                }
+
+                if (run)
+                {
+                    D3DXEncodeBC7Batch(pDest + start * blocksize, pBlocks + start * NUM_PIXELS_PER_BLOCK, run, bcflags);
+                    for (size_t j = 0; j < run; ++j)
+                    {
+                        cache->Insert(keys[2 * j], keys[2 * j + 1], pDest + (start + j) * blocksize, blocksize);
+                    }
+                }
+            }
+            return;
+        }
+
+        for (size_t b = 0; b < nbw; ++b)
+        {
+            EncodeBlock(pDest, pBlocks, format, pfEncode, blocksize, bcflags, threshold, cache);
+
+            pBlocks += NUM_PIXELS_PER_BLOCK;
+            pDest += blocksize;
+        }
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Hands out rows of blocks to worker threads; each strip is loaded and converted once
+    HRESULT CompressBC_Strips(
+        const Image& image,
+        const Image& result,
+        uint32_t bcflags,
+        TEX_FILTER_FLAGS srgb,
+        float threshold,
+        BlockCache* cache,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        if (!image.pixels || !result.pixels)
+            return E_POINTER;
+
+        assert(image.width == result.width);
+        assert(image.height == result.height);
+
+        const size_t sbpp = BitsPerPixel(image.format);
+        if (!sbpp)
+            return E_FAIL;
+
+        if (sbpp < 8)
+        {
+            // We don't support compressing from monochrome (DXGI_FORMAT_R1_UNORM)
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+
+        // Determine BC format encoder
+        BC_ENCODE pfEncode;
+        size_t blocksize;
+        TEX_FILTER_FLAGS cflags;
+        if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        const size_t nbw = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nStrips = std::max<size_t>(1, (image.height + 3) / 4);
+        const size_t workers = GetWorkerCount(nStrips);
+
+        auto scratch = make_AlignedArrayXMVECTOR(uint64_t(workers) * nbw * NUM_PIXELS_PER_BLOCK * 2);
+        if (!scratch)
+            return E_OUTOFMEMORY;
+
+        std::mutex progressLock;
+        size_t progress = 0;
+        bool abort = false;
+        bool fail = false;
+
+        ParallelFor(nStrips, workers, [&](size_t strip, size_t worker) noexcept -> bool
+            {
+                XMVECTOR* pScanlines = scratch.get() + worker * nbw * NUM_PIXELS_PER_BLOCK * 2;
+                XMVECTOR* pBlocks = pScanlines + nbw * NUM_PIXELS_PER_BLOCK;
+
+                if (!LoadBlockStrip(image, strip * 4, result.format, cflags | srgb, pScanlines, pBlocks, nbw))
+                {
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    fail = true;
+                    return false;
+                }
+
+                EncodeBlockStrip(result.pixels + strip * result.rowPitch, pBlocks, nbw, result.format, pfEncode, blocksize, bcflags, threshold, cache);
+
+                if (statusCallback)
+                {
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    progress = std::min<size_t>(progress + 4, image.height);
+                    if (!abort && !statusCallback(progress, image.height))
+                    {
+                        abort = true;
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+        if (abort)
+            return E_ABORT;
+
+        return (fail) ? E_FAIL : S_OK;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Compresses every subresource of a chain as one job, so the strips of small mips and
+    // array slices are spread across the workers instead of running one image at a time
+    HRESULT CompressBC_Chain(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_reads_(nimages) const Image* destImages,
+        size_t nimages,
+        uint32_t bcflags,
+        TEX_FILTER_FLAGS srgb,
+        float threshold,
+        BlockCache* cache,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        if (!srcImages || !destImages || !nimages)
+            return E_INVALIDARG;
+
+        BC_ENCODE pfEncode;
+        size_t blocksize;
+        TEX_FILTER_FLAGS cflags;
+        if (!DetermineEncoderSettings(destImages[0].format, pfEncode, blocksize, cflags))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        // Prefix sums of the strip counts map a flat strip index back to its subresource
+        std::unique_ptr<size_t[]> firstStrip(new (std::nothrow) size_t[nimages + 1]);
+        std::unique_ptr<size_t[]> remaining(new (std::nothrow) size_t[nimages]);
+        if (!firstStrip || !remaining)
+            return E_OUTOFMEMORY;
+
+        size_t maxnbw = 1;
+        firstStrip[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& src = srcImages[index];
+            if (!src.pixels || !destImages[index].pixels)
+                return E_POINTER;
+
+            const size_t sbpp = BitsPerPixel(src.format);
+            if (!sbpp)
+                return E_FAIL;
+
+            if (sbpp < 8)
+            {
+                // We don't support compressing from monochrome (DXGI_FORMAT_R1_UNORM)
+                return HRESULT_E_NOT_SUPPORTED;
+            }
+
+            const size_t nStrips = std::max<size_t>(1, (src.height + 3) / 4);
+            firstStrip[index + 1] = firstStrip[index] + nStrips;
+            remaining[index] = nStrips;
+            maxnbw = std::max<size_t>(maxnbw, (src.width + 3) / 4);
+        }
+
+        const size_t totalStrips = firstStrip[nimages];
+        const size_t workers = GetWorkerCount(totalStrips);
+
+        auto scratch = make_AlignedArrayXMVECTOR(uint64_t(workers) * maxnbw * NUM_PIXELS_PER_BLOCK * 2);
+        if (!scratch)
+            return E_OUTOFMEMORY;
+
+        std::mutex progressLock;
+        size_t imagesDone = 0;
+        bool abort = false;
+        bool fail = false;
+
+        ParallelFor(totalStrips, workers, [&](size_t item, size_t worker) noexcept -> bool
+            {
+                const size_t index = static_cast<size_t>(std::upper_bound(firstStrip.get(), firstStrip.get() + nimages + 1, item) - firstStrip.get()) - 1;
+                assert(index < nimages);
+
+                const Image& src = srcImages[index];
+                const Image& dest = destImages[index];
+                const size_t strip = item - firstStrip[index];
+                const size_t nbw = std::max<size_t>(1, (src.width + 3) / 4);
+
+                // Scratch still holds the worker's previous strip, possibly from another subresource;
+                // LoadBlockStrip only reads rows it loads itself, so 1xN and 1x1 tails stay correct
+                XMVECTOR* pScanlines = scratch.get() + worker * maxnbw * NUM_PIXELS_PER_BLOCK * 2;
+                XMVECTOR* pBlocks = pScanlines + maxnbw * NUM_PIXELS_PER_BLOCK;
+
+                if (!LoadBlockStrip(src, strip * 4, dest.format, cflags | srgb, pScanlines, pBlocks, nbw))
+                {
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    fail = true;
+                    return false;
+                }
+
+                EncodeBlockStrip(dest.pixels + strip * dest.rowPitch, pBlocks, nbw, dest.format, pfEncode, blocksize, bcflags, threshold, cache);
+
+                std::lock_guard<std::mutex> lock(progressLock);
+                if (--remaining[index] == 0)
+                {
+                    ++imagesDone;
+                    if (statusCallback && !abort && !statusCallback(imagesDone, nimages))
+                    {
+                        abort = true;
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+        if (abort)
+            return E_ABORT;
+
+        return (fail) ? E_FAIL : S_OK;
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Rate-distortion optimization
+    //
+    // Runs over already encoded blocks and rewrites some of them, or some of their bytes,
+    // as exact copies of recently emitted blocks so that a general-purpose LZ coder wrapped
+    // around the file finds longer matches. A rewrite is kept when the extra error it adds
+    // is paid for by the bits it saves, as judged by error + lambda * bits. The output is
+    // still a valid block of the same format; nothing changes at load time.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_RDOWindowBlocks = 32;
+    constexpr size_t c_RDOBandBlockRows = 16;
+    constexpr size_t c_RDOParallelMinPixels = 256 * 256;
+    constexpr float c_RDOMatchBits = 24.f; // Rough cost of an LZ match (length + distance)
+    constexpr size_t c_RDOMaxFields = 5;
+
+    struct RDOField
+    {
+        size_t offset;
+        size_t size;
+    };
+
+    struct RDOFormat
+    {
+        BC_DECODE   pfDecode;
+        size_t      blocksize;
+        XMVECTOR    weights;    // Channel mask scaled to the integer range of the format
+        size_t      nfields;
+        RDOField    fields[c_RDOMaxFields];
+    };
+
+    bool GetRDOSettings(_In_ DXGI_FORMAT format, _Out_ RDOFormat& rdo) noexcept
+    {
+        static const XMVECTORF32 s_RGBA = { { { 255.f, 255.f, 255.f, 255.f } } };
+        static const XMVECTORF32 s_RU = { { { 255.f, 0.f, 0.f, 0.f } } };
+        static const XMVECTORF32 s_RS = { { { 127.f, 0.f, 0.f, 0.f } } };
+        static const XMVECTORF32 s_RGU = { { { 255.f, 255.f, 0.f, 0.f } } };
+        static const XMVECTORF32 s_RGS = { { { 127.f, 127.f, 0.f, 0.f } } };
+
+        // Fields are the byte ranges worth repeating on their own, largest first: endpoint
+        // and index runs for the BC1 and BC4 style halves. BC7 bit fields move with the
+        // mode, so only whole blocks are repeated there.
+        static const RDOField s_BC1[] = { { 0, 4 }, { 4, 4 } };
+        static const RDOField s_BC3[] = { { 0, 8 }, { 8, 8 }, { 2, 6 }, { 8, 4 }, { 12, 4 } };
+        static const RDOField s_BC4[] = { { 2, 6 } };
+        static const RDOField s_BC5[] = { { 0, 8 }, { 8, 8 }, { 2, 6 }, { 10, 6 } };
+
+        const RDOField* fields = nullptr;
+        rdo.nfields = 0;
+
+        switch (format)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            rdo.pfDecode = D3DXDecodeBC1;   rdo.blocksize = 8;  rdo.weights = s_RGBA;
+            fields = s_BC1; rdo.nfields = std::size(s_BC1);
+            break;
+
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            rdo.pfDecode = D3DXDecodeBC3;   rdo.blocksize = 16; rdo.weights = s_RGBA;
+            fields = s_BC3; rdo.nfields = std::size(s_BC3);
+            break;
+
+        case DXGI_FORMAT_BC4_UNORM:
+            rdo.pfDecode = D3DXDecodeBC4U;  rdo.blocksize = 8;  rdo.weights = s_RU;
+            fields = s_BC4; rdo.nfields = std::size(s_BC4);
+            break;
+
+        case DXGI_FORMAT_BC4_SNORM:
+            rdo.pfDecode = D3DXDecodeBC4S;  rdo.blocksize = 8;  rdo.weights = s_RS;
+            fields = s_BC4; rdo.nfields = std::size(s_BC4);
+            break;
+
+        case DXGI_FORMAT_BC5_UNORM:
+            rdo.pfDecode = D3DXDecodeBC5U;  rdo.blocksize = 16; rdo.weights = s_RGU;
+            fields = s_BC5; rdo.nfields = std::size(s_BC5);
+            break;
+
+        case DXGI_FORMAT_BC5_SNORM:
+            rdo.pfDecode = D3DXDecodeBC5S;  rdo.blocksize = 16; rdo.weights = s_RGS;
+            fields = s_BC5; rdo.nfields = std::size(s_BC5);
+            break;
+
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            rdo.pfDecode = D3DXDecodeBC7;   rdo.blocksize = 16; rdo.weights = s_RGBA;
+            break;
+
+        default:
+            // BC2 alpha is stored raw and BC6H error doesn't map onto a fixed integer range
+            rdo.pfDecode = nullptr;
+            rdo.blocksize = 0;
+            rdo.weights = g_XMZero;
+            return false;
+        }
+
+        for (size_t j = 0; j < rdo.nfields; ++j)
+        {
+            rdo.fields[j] = fields[j];
+        }
+
+        return true;
+    }
+
+    inline float RDOBlockError(
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pDecoded,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pSource,
+        FXMVECTOR weights) noexcept
+    {
+        XMVECTOR sum = XMVectorZero();
+        for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+        {
+            const XMVECTOR diff = XMVectorMultiply(XMVectorSubtract(pDecoded[i], pSource[i]), weights);
+            sum = XMVectorMultiplyAdd(diff, diff, sum);
+        }
+
+        return XMVectorGetX(XMVector4Dot(sum, g_XMOne));
+    }
+
+    // pBlock is preceded by 'history' blocks of the same band that the LZ window can reach
+    void OptimizeBlockRDO(
+        const RDOFormat& rdo,
+        _Inout_updates_bytes_(rdo.blocksize) uint8_t* pBlock,
+        size_t history,
+        _In_reads_(NUM_PIXELS_PER_BLOCK) const XMVECTOR* pSource,
+        float lambda) noexcept
+    {
+        XM_ALIGNED_DATA(16) XMVECTOR decoded[NUM_PIXELS_PER_BLOCK];
+
+        const size_t blocksize = rdo.blocksize;
+        history = std::min(history, c_RDOWindowBlocks);
+
+        rdo.pfDecode(decoded, pBlock);
+        float error = RDOBlockError(decoded, pSource, rdo.weights);
+        float bits = float(blocksize * 8);
+
+        // Whole-block repeats first; they are the longest match the coder can find
+        const uint8_t* bestMatch = nullptr;
+        float bestCost = error + lambda * bits;
+        for (size_t k = 1; k <= history; ++k)
+        {
+            const uint8_t* pCandidate = pBlock - k * blocksize;
+            rdo.pfDecode(decoded, pCandidate);
+            const float cost = RDOBlockError(decoded, pSource, rdo.weights) + lambda * c_RDOMatchBits;
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestMatch = pCandidate;
+            }
+        }
+
+        if (bestMatch)
+        {
+            memcpy(pBlock, bestMatch, blocksize);
+            return;
+        }
+
+        // Then repeat individual fields, keeping whatever is left of the block
+        uint8_t trial[16] = {};
+        uint32_t matched = 0;
+        for (size_t j = 0; j < rdo.nfields; ++j)
+        {
+            const RDOField& field = rdo.fields[j];
+            const uint32_t mask = ((1u << field.size) - 1u) << field.offset;
+            if (matched & mask)
+                continue;
+
+            const float fieldBits = float(field.size * 8);
+            const float newBits = bits - fieldBits + c_RDOMatchBits;
+
+            const uint8_t* bestField = nullptr;
+            float bestError = error;
+            bestCost = error + lambda * bits;
+            memcpy(trial, pBlock, blocksize);
+            for (size_t k = 1; k <= history; ++k)
+            {
+                const uint8_t* pCandidate = pBlock - k * blocksize + field.offset;
+                if (!memcmp(pCandidate, pBlock + field.offset, field.size))
+                    continue;
+
+                memcpy(trial + field.offset, pCandidate, field.size);
+                rdo.pfDecode(decoded, trial);
+                const float candidateError = RDOBlockError(decoded, pSource, rdo.weights);
+                const float cost = candidateError + lambda * newBits;
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestError = candidateError;
+                    bestField = pCandidate;
+                }
+            }
+
+            if (bestField)
+            {
+                memcpy(pBlock + field.offset, bestField, field.size);
+                error = bestError;
+                bits = newBits;
+                matched |= mask;
+            }
+        }
+    }
+
+    HRESULT OptimizeBC_RDO(
+        const Image& image,
+        const Image& result,
+        TEX_FILTER_FLAGS srgb,
+        float lambda) noexcept
+    {
+        if (!image.pixels || !result.pixels)
+            return E_POINTER;
+
+        assert(image.width == result.width);
+        assert(image.height == result.height);
+
+        RDOFormat rdo;
+        if (!GetRDOSettings(result.format, rdo))
+            return S_OK;
+
+        BC_ENCODE pfEncode;
+        size_t blocksize;
+        TEX_FILTER_FLAGS cflags;
+        if (!DetermineEncoderSettings(result.format, pfEncode, blocksize, cflags))
+            return HRESULT_E_NOT_SUPPORTED;
+
+        assert(blocksize == rdo.blocksize);
+
+        // Each band keeps its own history so the result doesn't depend on the worker count
+        const size_t nbw = std::max<size_t>(1, (image.width + 3) / 4);
+        const size_t nStrips = std::max<size_t>(1, (image.height + 3) / 4);
+        const size_t nBands = (nStrips + c_RDOBandBlockRows - 1) / c_RDOBandBlockRows;
+        const size_t workers = (uint64_t(image.width) * image.height >= c_RDOParallelMinPixels) ? GetWorkerCount(nBands) : 1;
+
+        auto scratch = make_AlignedArrayXMVECTOR(uint64_t(workers) * nbw * NUM_PIXELS_PER_BLOCK * 2);
+        if (!scratch)
+            return E_OUTOFMEMORY;
+
+        const bool ok = ParallelFor(nBands, workers, [&](size_t band, size_t worker) noexcept -> bool
+            {
+                XMVECTOR* pScanlines = scratch.get() + worker * nbw * NUM_PIXELS_PER_BLOCK * 2;
+                XMVECTOR* pBlocks = pScanlines + nbw * NUM_PIXELS_PER_BLOCK;
+
+                const size_t first = band * c_RDOBandBlockRows;
+                const size_t end = std::min(nStrips, first + c_RDOBandBlockRows);
+                size_t history = 0;
+                for (size_t strip = first; strip < end; ++strip)
+                {
+                    // Reference texels must match what the encoder saw, padding of short strips included
+                    if (!LoadBlockStrip(image, strip * 4, result.format, cflags | srgb, pScanlines, pBlocks, nbw))
+                        return false;
+
+                    uint8_t* pDest = result.pixels + strip * result.rowPitch;
+                    for (size_t b = 0; b < nbw; ++b)
+                    {
+                        OptimizeBlockRDO(rdo, pDest, history, pBlocks + b * NUM_PIXELS_PER_BLOCK, lambda);
+                        pDest += blocksize;
+                        ++history;
+                    }
+                }
+                return true;
+            });
+
+        return ok ? S_OK : E_FAIL;
+    }
+
+
+
+    //-------------------------------------------------------------------------------------
+    // Stats are the difference of the cache totals, so other threads sharing the cache at
+    // the same time are counted too
+    inline BlockCacheStats GetBlockCacheStats(const CompressOptions& options) noexcept
+    {
+        return (options.blockCache) ? options.blockCache->GetStats() : BlockCacheStats{};
+    }
+
+    void ReportBlockCacheStats(const CompressOptions& options, const BlockCacheStats& before) noexcept
+    {
+        if (!options.blockCacheStats)
+            return;
+
+        const BlockCacheStats after = GetBlockCacheStats(options);
+        options.blockCacheStats->hits = after.hits - before.hits;
+        options.blockCacheStats->misses = after.misses - before.misses;
+    }
+
+
     //-------------------------------------------------------------------------------------
     DXGI_FORMAT DefaultDecompress(_In_ DXGI_FORMAT format) noexcept
     {
@@ -421,6 +1094,346 @@ namespace
     }
 
 
+    //-------------------------------------------------------------------------------------
+    // Direct block decoders
+    //
+    // For the common BC1-BC5 -> 8-bit RGBA cases each block is resolved to a small palette
+    // of packed pixels and the indices are expanded with integer ops, rather than widening
+    // all 16 texels to XMVECTOR and going through ConvertScanline/StoreScanline. Palette
+    // entries use the same float math as D3DXDecodeBC* and the same biased XMStoreUByteN4
+    // as StoreScanline, so the output is bit-identical to the generic path.
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_DecompressBandBlockRows = 4;
+    constexpr size_t c_DecompressParallelMinPixels = 512 * 512;
+
+    enum DIRECT_DECODE : uint32_t
+    {
+        DIRECT_NONE = 0,
+        DIRECT_BC1,
+        DIRECT_BC2,
+        DIRECT_BC3,
+        DIRECT_BC4,
+        DIRECT_BC5,
+        DIRECT_BC6HU,
+        DIRECT_BC6HS,
+    };
+
+    DIRECT_DECODE GetDirectDecoder(_In_ DXGI_FORMAT cformat, _In_ DXGI_FORMAT format, _Out_ bool& bgr) noexcept
+    {
+        bgr = false;
+
+        if (format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+        {
+            // BC6H texels are half-floats to begin with, so no conversion is involved
+            switch (cformat)
+            {
+            case DXGI_FORMAT_BC6H_UF16: return DIRECT_BC6HU;
+            case DXGI_FORMAT_BC6H_SF16: return DIRECT_BC6HS;
+            default:                    return DIRECT_NONE;
+            }
+        }
+
+        switch (format)
+        {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            break;
+
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            bgr = true;
+            break;
+
+        default:
+            return DIRECT_NONE;
+        }
+
+        // A gamma change between source and destination needs the float path
+        if (IsSRGB(cformat) != IsSRGB(format))
+            return DIRECT_NONE;
+
+        switch (cformat)
+        {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:    return DIRECT_BC1;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:    return DIRECT_BC2;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:    return DIRECT_BC3;
+        case DXGI_FORMAT_BC4_UNORM:         return DIRECT_BC4;
+        case DXGI_FORMAT_BC5_UNORM:         return DIRECT_BC5;
+        default:                            return DIRECT_NONE;
+        }
+    }
+
+    // Same bias StoreScanline applies before XMStoreUByteN4
+    const XMVECTORF32 g_Decode8BitBias = { { { 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f, 0.5f / 255.f } } };
+
+    inline uint32_t PackUNorm8(_In_ FXMVECTOR v) noexcept
+    {
+        XMUBYTEN4 packed;
+        XMStoreUByteN4(&packed, XMVectorAdd(v, g_Decode8BitBias));
+        return packed.v;
+    }
+
+    inline void PackUNorm8(_In_reads_(4) const float* values, _Out_writes_(4) uint8_t* pDest) noexcept
+    {
+        const uint32_t packed = PackUNorm8(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(values)));
+        memcpy(pDest, &packed, sizeof(packed));
+    }
+
+    // Mirrors DecodeBC1 in BC.cpp
+    void GetBC1Palette(_In_ const D3DX_BC1* pBC, bool isbc1, _Out_writes_(4) uint32_t* palette) noexcept
+    {
+        static const XMVECTORF32 s_Scale = { { { 1.f / 31.f, 1.f / 63.f, 1.f / 31.f, 1.f } } };
+
+        XMVECTOR clr0 = XMLoadU565(reinterpret_cast<const XMU565*>(&pBC->rgb[0]));
+        XMVECTOR clr1 = XMLoadU565(reinterpret_cast<const XMU565*>(&pBC->rgb[1]));
+
+        clr0 = XMVectorMultiply(clr0, s_Scale);
+        clr1 = XMVectorMultiply(clr1, s_Scale);
+
+        clr0 = XMVectorSwizzle<2, 1, 0, 3>(clr0);
+        clr1 = XMVectorSwizzle<2, 1, 0, 3>(clr1);
+
+        clr0 = XMVectorSelect(g_XMIdentityR3, clr0, g_XMSelect1110);
+        clr1 = XMVectorSelect(g_XMIdentityR3, clr1, g_XMSelect1110);
+
+        palette[0] = PackUNorm8(clr0);
+        palette[1] = PackUNorm8(clr1);
+
+        if (isbc1 && (pBC->rgb[0] <= pBC->rgb[1]))
+        {
+            palette[2] = PackUNorm8(XMVectorLerp(clr0, clr1, 0.5f));
+            palette[3] = PackUNorm8(XMVectorZero());
+        }
+        else
+        {
+            palette[2] = PackUNorm8(XMVectorLerp(clr0, clr1, 1.f / 3.f));
+            palette[3] = PackUNorm8(XMVectorLerp(clr0, clr1, 2.f / 3.f));
+        }
+    }
+
+    // Mirrors the alpha part of D3DXDecodeBC2
+    const uint8_t* GetBC2AlphaTable() noexcept
+    {
+        static const struct Table
+        {
+            uint8_t alpha[16];
+
+            Table() noexcept
+            {
+                float fAlpha[16];
+                for (size_t i = 0; i < 16; ++i)
+                    fAlpha[i] = static_cast<float>(i) * (1.0f / 15.0f);
+
+                for (size_t i = 0; i < 16; i += 4)
+                    PackUNorm8(&fAlpha[i], &alpha[i]);
+            }
+        } s_table;
+
+        return s_table.alpha;
+    }
+
+    // Mirrors the alpha part of D3DXDecodeBC3
+    void GetBC3AlphaPalette(_In_reads_(2) const uint8_t* endpoints, _Out_writes_(8) uint8_t* palette) noexcept
+    {
+        float fAlpha[8];
+
+        fAlpha[0] = static_cast<float>(endpoints[0]) * (1.0f / 255.0f);
+        fAlpha[1] = static_cast<float>(endpoints[1]) * (1.0f / 255.0f);
+
+        if (endpoints[0] > endpoints[1])
+        {
+            for (size_t i = 1; i < 7; ++i)
+                fAlpha[i + 1] = (fAlpha[0] * float(7u - i) + fAlpha[1] * float(i)) * (1.0f / 7.0f);
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                fAlpha[i + 1] = (fAlpha[0] * float(5u - i) + fAlpha[1] * float(i)) * (1.0f / 5.0f);
+
+            fAlpha[6] = 0.0f;
+            fAlpha[7] = 1.0f;
+        }
+
+        PackUNorm8(&fAlpha[0], &palette[0]);
+        PackUNorm8(&fAlpha[4], &palette[4]);
+    }
+
+    // Mirrors BC4_UNORM::DecodeFromIndex in BC4BC5.cpp, which divides rather than
+    // multiplying by the reciprocal like BC3 does
+    void GetBC4Palette(_In_reads_(2) const uint8_t* endpoints, _Out_writes_(8) uint8_t* palette) noexcept
+    {
+        float fRed[8];
+
+        fRed[0] = float(endpoints[0]) / 255.0f;
+        fRed[1] = float(endpoints[1]) / 255.0f;
+
+        if (endpoints[0] > endpoints[1])
+        {
+            for (size_t i = 1; i < 7; ++i)
+                fRed[i + 1] = (fRed[0] * float(7u - i) + fRed[1] * float(i)) / 7.0f;
+        }
+        else
+        {
+            for (size_t i = 1; i < 5; ++i)
+                fRed[i + 1] = (fRed[0] * float(5u - i) + fRed[1] * float(i)) / 5.0f;
+
+            fRed[6] = 0.0f;
+            fRed[7] = 1.0f;
+        }
+
+        PackUNorm8(&fRed[0], &palette[0]);
+        PackUNorm8(&fRed[4], &palette[4]);
+    }
+
+    // 48 bits of 3-bit indices following the two endpoint bytes
+    inline uint64_t GetBC4Indices(_In_reads_(8) const uint8_t* pBC) noexcept
+    {
+        uint64_t data = 0;
+        for (size_t i = 0; i < 6; ++i)
+            data |= uint64_t(pBC[2 + i]) << (8 * i);
+        return data;
+    }
+
+    inline uint32_t SwapRB(uint32_t t) noexcept
+    {
+        return (t & 0xFF00FF00) | ((t & 0x00FF0000) >> 16) | ((t & 0x000000FF) << 16);
+    }
+
+    void DecodeBlock8(DIRECT_DECODE direct, bool bgr, _In_ const uint8_t* pBC, _Out_writes_(NUM_PIXELS_PER_BLOCK) uint32_t* pixels) noexcept
+    {
+        switch (direct)
+        {
+        case DIRECT_BC1:
+            {
+                auto pBC1 = reinterpret_cast<const D3DX_BC1*>(pBC);
+
+                uint32_t palette[4];
+                GetBC1Palette(pBC1, true, palette);
+
+                uint32_t dw = pBC1->bitmap;
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2)
+                    pixels[i] = palette[dw & 3];
+            }
+            break;
+
+        case DIRECT_BC2:
+            {
+                auto pBC2 = reinterpret_cast<const D3DX_BC2*>(pBC);
+
+                uint32_t palette[4];
+                GetBC1Palette(&pBC2->bc1, false, palette);
+
+                const uint8_t* alpha = GetBC2AlphaTable();
+
+                uint32_t dw = pBC2->bc1.bitmap;
+                uint64_t da = uint64_t(pBC2->bitmap[0]) | (uint64_t(pBC2->bitmap[1]) << 32);
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2, da >>= 4)
+                    pixels[i] = (palette[dw & 3] & 0x00FFFFFF) | (uint32_t(alpha[da & 0xf]) << 24);
+            }
+            break;
+
+        case DIRECT_BC3:
+            {
+                auto pBC3 = reinterpret_cast<const D3DX_BC3*>(pBC);
+
+                uint32_t palette[4];
+                GetBC1Palette(&pBC3->bc1, false, palette);
+
+                uint8_t alpha[8];
+                GetBC3AlphaPalette(pBC3->alpha, alpha);
+
+                uint32_t dw = pBC3->bc1.bitmap;
+                uint64_t da = GetBC4Indices(pBC);
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dw >>= 2, da >>= 3)
+                    pixels[i] = (palette[dw & 3] & 0x00FFFFFF) | (uint32_t(alpha[da & 0x7]) << 24);
+            }
+            break;
+
+        case DIRECT_BC4:
+            {
+                uint8_t red[8];
+                GetBC4Palette(pBC, red);
+
+                // R -> RGB replication as ConvertScanline does; alpha is 1.0
+                uint64_t dr = GetBC4Indices(pBC);
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dr >>= 3)
+                    pixels[i] = (uint32_t(red[dr & 0x7]) * 0x010101u) | 0xFF000000;
+            }
+            break;
+
+        case DIRECT_BC5:
+            {
+                uint8_t red[8];
+                uint8_t green[8];
+                GetBC4Palette(pBC, red);
+                GetBC4Palette(pBC + 8, green);
+
+                // Blue is 0.0 and alpha is 1.0
+                uint64_t dr = GetBC4Indices(pBC);
+                uint64_t dg = GetBC4Indices(pBC + 8);
+                for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i, dr >>= 3, dg >>= 3)
+                    pixels[i] = uint32_t(red[dr & 0x7]) | (uint32_t(green[dg & 0x7]) << 8) | 0xFF000000;
+            }
+            break;
+
+        default:
+            assert(false);
+            return;
+        }
+
+        if (bgr)
+        {
+            for (size_t i = 0; i < NUM_PIXELS_PER_BLOCK; ++i)
+                pixels[i] = SwapRB(pixels[i]);
+        }
+    }
+
+    void DecodeBlockRow(
+        DIRECT_DECODE direct,
+        bool bgr,
+        _In_ const uint8_t* pSource,
+        size_t sbpp,
+        size_t nBlocks,
+        _Out_writes_bytes_(rowPitch * ph) uint8_t* pDest,
+        size_t rowPitch,
+        size_t width,
+        size_t ph) noexcept
+    {
+        assert(ph > 0 && ph <= 4);
+
+        for (size_t bx = 0; bx < nBlocks; ++bx, pSource += sbpp)
+        {
+            const size_t pw = std::min<size_t>(4, width - bx * 4);
+            assert(pw > 0);
+
+            if (direct == DIRECT_BC6HU || direct == DIRECT_BC6HS)
+            {
+                XMHALF4 texels[NUM_PIXELS_PER_BLOCK];
+                if (direct == DIRECT_BC6HU)
+                    D3DXDecodeBC6HU(texels, pSource);
+                else
+                    D3DXDecodeBC6HS(texels, pSource);
+
+                uint8_t* dptr = pDest + bx * 4 * sizeof(XMHALF4);
+                for (size_t y = 0; y < ph; ++y)
+                    memcpy(dptr + rowPitch * y, &texels[y * 4], pw * sizeof(XMHALF4));
+            }
+            else
+            {
+                uint32_t pixels[NUM_PIXELS_PER_BLOCK];
+                DecodeBlock8(direct, bgr, pSource, pixels);
+
+                uint8_t* dptr = pDest + bx * 4 * sizeof(uint32_t);
+                for (size_t y = 0; y < ph; ++y)
+                    memcpy(dptr + rowPitch * y, &pixels[y * 4], pw * sizeof(uint32_t));
+            }
+        }
+    }
+
+
     //-------------------------------------------------------------------------------------
     HRESULT DecompressBC(_In_ const Image& cImage, _In_ const Image& result) noexcept
     {
@@ -485,53 +1498,67 @@ namespace
             return HRESULT_E_NOT_SUPPORTED;
         }
 
-        XM_ALIGNED_DATA(16) XMVECTOR temp[16];
-        const uint8_t *pSrc = cImage.pixels;
+        const size_t nBlocksX = std::min((cImage.width + 3) / 4, (cImage.rowPitch + sbpp - 1) / sbpp);
+        const size_t nBlockRows = (cImage.height + 3) / 4;
+        const size_t nBands = (nBlockRows + c_DecompressBandBlockRows - 1) / c_DecompressBandBlockRows;
+        const size_t workers = (uint64_t(cImage.width) * cImage.height >= c_DecompressParallelMinPixels) ? GetWorkerCount(nBands) : 1;
+
         const size_t rowPitch = result.rowPitch;
-        for (size_t h = 0; h < cImage.height; h += 4)
+
+        bool bgr;
+        const DIRECT_DECODE direct = GetDirectDecoder(cformat, format, bgr);
+        if (direct != DIRECT_NONE)
         {
-            const uint8_t *sptr = pSrc;
-            uint8_t* dptr = pDest;
-            const size_t ph = std::min<size_t>(4, cImage.height - h);
-            size_t w = 0;
-            for (size_t count = 0; (count < cImage.rowPitch) && (w < cImage.width); count += sbpp, w += 4)
-            {
-                pfDecode(temp, sptr);
-                ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
+            ParallelFor(nBands, workers, [&](size_t band, size_t) noexcept -> bool
+                {
+                    const size_t end = std::min(nBlockRows, (band + 1) * c_DecompressBandBlockRows);
+                    for (size_t by = band * c_DecompressBandBlockRows; by < end; ++by)
+                    {
+                        const size_t h = by * 4;
+                        DecodeBlockRow(direct, bgr,
+                            cImage.pixels + cImage.rowPitch * by, sbpp, nBlocksX,
+                            pDest + rowPitch * h, rowPitch,
+                            cImage.width, std::min<size_t>(4, cImage.height - h));
+                    }
+                    return true;
+                });
 
-                const size_t pw = std::min<size_t>(4, cImage.width - w);
-                assert(pw > 0 && ph > 0);
+            return S_OK;
+        }
 
-                if (!StoreScanline(dptr, rowPitch, format, &temp[0], pw))
-                    return E_FAIL;
+        const bool ok = ParallelFor(nBands, workers, [&](size_t band, size_t) noexcept -> bool
+            {
+                XM_ALIGNED_DATA(16) XMVECTOR temp[16];
 
-                if (ph > 1)
+                const size_t end = std::min(nBlockRows, (band + 1) * c_DecompressBandBlockRows);
+                for (size_t by = band * c_DecompressBandBlockRows; by < end; ++by)
                 {
-                    if (!StoreScanline(dptr + rowPitch, rowPitch, format, &temp[4], pw))
-                        return E_FAIL;
-
-                    if (ph > 2)
+                    const size_t h = by * 4;
+                    const uint8_t *sptr = cImage.pixels + cImage.rowPitch * by;
+                    uint8_t* dptr = pDest + rowPitch * h;
+                    const size_t ph = std::min<size_t>(4, cImage.height - h);
+                    for (size_t bx = 0; bx < nBlocksX; ++bx)
                     {
-                        if (!StoreScanline(dptr + rowPitch * 2, rowPitch, format, &temp[8], pw))
-                            return E_FAIL;
+                        pfDecode(temp, sptr);
+                        ConvertScanline(temp, 16, format, cformat, TEX_FILTER_DEFAULT);
 
-                        if (ph > 3)
+                        const size_t pw = std::min<size_t>(4, cImage.width - bx * 4);
+                        assert(pw > 0 && ph > 0);
+
+                        for (size_t y = 0; y < ph; ++y)
                         {
-                            if (!StoreScanline(dptr + rowPitch * 3, rowPitch, format, &temp[12], pw))
-                                return E_FAIL;
+                            if (!StoreScanline(dptr + rowPitch * y, rowPitch, format, &temp[y * 4], pw))
+                                return false;
                         }
+
+                        sptr += sbpp;
+                        dptr += dbpp * 4;
                     }
                 }
+                return true;
+            });
 
-                sptr += sbpp;
-                dptr += dbpp * 4;
-            }
-
-            pSrc += cImage.rowPitch;
-            pDest += rowPitch * 4;
-        }
-
-        return S_OK;
+        return ok ? S_OK : E_FAIL;
     }
 }
 
@@ -675,6 +1702,8 @@ HRESULT DirectX::CompressEx(
         || IsTypeless(srcImage.format) || IsPlanar(srcImage.format) || IsPalettized(srcImage.format))
         return HRESULT_E_NOT_SUPPORTED;
 
+    const BlockCacheStats cacheBefore = GetBlockCacheStats(options);
+
     // Create compressed image
     HRESULT hr = image.Initialize2D(format, srcImage.width, srcImage.height, 1, 1);
     if (FAILED(hr))
@@ -697,17 +1726,26 @@ HRESULT DirectX::CompressEx(
     }
 
     // Compress single image
-    if (options.flags & TEX_COMPRESS_PARALLEL)
+    if (options.flags & TEX_COMPRESS_PARALLEL_BLOCKS)
     {
     #ifndef _OPENMP
         hr = E_NOTIMPL;
     #else
-        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC_Parallel(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, statusCallback);
     #endif // _OPENMP
     }
+    else if (options.flags & TEX_COMPRESS_PARALLEL)
+    {
+        hr = CompressBC_Strips(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, statusCallback);
+    }
     else
     {
-        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, statusCallback);
+        hr = CompressBC(srcImage, *img, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, statusCallback);
+    }
+
+    if (SUCCEEDED(hr) && options.rdoLambda > 0.f)
+    {
+        hr = OptimizeBC_RDO(srcImage, *img, GetSRGBFlags(options.flags), options.rdoLambda);
     }
 
     if (FAILED(hr))
@@ -725,6 +1763,8 @@ HRESULT DirectX::CompressEx(
         }
     }
 
+    ReportBlockCacheStats(options, cacheBefore);
+
     return S_OK;
 }
 
@@ -763,6 +1803,8 @@ HRESULT DirectX::CompressEx(
         return CompressEx(srcImages[0], format, options, cImages, statusCallback);
     }
 
+    const BlockCacheStats cacheBefore = GetBlockCacheStats(options);
+
     TexMetadata mdata2 = metadata;
     mdata2.format = format;
     HRESULT hr = cImages.Initialize(mdata2);
@@ -795,25 +1837,53 @@ HRESULT DirectX::CompressEx(
     {
         assert(dest[index].format == format);
 
-        const Image& src = srcImages[index];
-
-        if (src.width != dest[index].width || src.height != dest[index].height)
+        if (srcImages[index].width != dest[index].width || srcImages[index].height != dest[index].height)
         {
             cImages.Release();
             return E_FAIL;
         }
+    }
+
+    if ((options.flags & TEX_COMPRESS_PARALLEL) && !(options.flags & TEX_COMPRESS_PARALLEL_BLOCKS))
+    {
+        // Compress the whole chain as a single parallel job
+        hr = CompressBC_Chain(srcImages, dest, nimages, GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, statusCallback);
+        for (size_t index = 0; SUCCEEDED(hr) && options.rdoLambda > 0.f && index < nimages; ++index)
+        {
+            hr = OptimizeBC_RDO(srcImages[index], dest[index], GetSRGBFlags(options.flags), options.rdoLambda);
+        }
+
+        if (FAILED(hr))
+        {
+            cImages.Release();
+            return hr;
+        }
+
+        ReportBlockCacheStats(options, cacheBefore);
 
-        if (options.flags & TEX_COMPRESS_PARALLEL)
+        return S_OK;
+    }
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const Image& src = srcImages[index];
+
+        if (options.flags & TEX_COMPRESS_PARALLEL_BLOCKS)
         {
         #ifndef _OPENMP
             hr = E_NOTIMPL;
         #else
-            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            hr = CompressBC_Parallel(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, nullptr);
         #endif // _OPENMP
         }
         else
         {
-            hr = CompressBC(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, nullptr);
+            hr = CompressBC(src, dest[index], GetBCFlags(options.flags), GetSRGBFlags(options.flags), options.threshold, options.blockCache, nullptr);
+        }
+
+        if (SUCCEEDED(hr) && options.rdoLambda > 0.f)
+        {
+            hr = OptimizeBC_RDO(src, dest[index], GetSRGBFlags(options.flags), options.rdoLambda);
         }
 
         if (FAILED(hr))
@@ -841,6 +1911,8 @@ HRESULT DirectX::CompressEx(
         }
     }
 
+    ReportBlockCacheStats(options, cacheBefore);
+
     return S_OK;
 }
 
@@ -4796,6 +4796,228 @@ namespace
     #endif // WIN32
     }
 
+    //-------------------------------------------------------------------------------------
+    // Direct scanline converters for the common RGBA8 / BGRA8 / RGBA16F / RGBA32F pairs.
+    // These skip the intermediate XMVECTOR scanline and the per-format switches, but use
+    // the same DirectXMath load/clamp/store sequence as LoadScanline, ConvertScanline and
+    // StoreScanline, so the output is bit-identical to the general path.
+    //-------------------------------------------------------------------------------------
+    using DirectConvertFunc = void(*)(uint8_t* __restrict pDest, const uint8_t* __restrict pSrc, size_t count);
+
+    // Results of the general path for every 8-bit UNORM input value
+    struct UNorm8Tables
+    {
+        float       toFloat[256];
+        HALF        toHalf[256];
+        uint8_t     toByte[256];
+        bool        byteIdentity;
+
+        UNorm8Tables() noexcept : byteIdentity(true)
+        {
+            for (size_t j = 0; j < 256; ++j)
+            {
+                const auto b = static_cast<uint8_t>(j);
+                const XMUBYTEN4 src(b, b, b, b);
+                const XMVECTOR v = XMLoadUByteN4(&src);
+
+                toFloat[j] = XMVectorGetX(v);
+
+                XMHALF4 h;
+                XMStoreHalf4(&h, XMVectorClamp(v, g_HalfMin, g_HalfMax));
+                toHalf[j] = h.x;
+
+                XMUBYTEN4 d;
+                XMStoreUByteN4(&d, XMVectorAdd(v, g_8BitBias));
+                toByte[j] = d.x;
+
+                if (toByte[j] != b)
+                    byteIdentity = false;
+            }
+        }
+    };
+
+    const UNorm8Tables& GetUNorm8Tables() noexcept
+    {
+        static const UNorm8Tables s_tables;
+        return s_tables;
+    }
+
+    // Float sources
+    struct LoadFloat4
+    {
+        static constexpr size_t c_Size = sizeof(XMFLOAT4);
+        static XMVECTOR Load(const uint8_t* p) noexcept { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p)); }
+    };
+
+    struct LoadHalf4
+    {
+        static constexpr size_t c_Size = sizeof(XMHALF4);
+        static XMVECTOR Load(const uint8_t* p) noexcept { return XMLoadHalf4(reinterpret_cast<const XMHALF4*>(p)); }
+    };
+
+    // ConvertScanline adjustments
+    struct NoFixup
+    {
+        static XMVECTOR Apply(FXMVECTOR v) noexcept { return v; }
+    };
+
+    struct SaturateFixup
+    {
+        // FLOAT -> UNORM
+        static XMVECTOR Apply(FXMVECTOR v) noexcept { return XMVectorSaturate(v); }
+    };
+
+    // Destinations
+    struct StoreFloat4
+    {
+        static constexpr size_t c_Size = sizeof(XMFLOAT4);
+        static void Store(uint8_t* p, FXMVECTOR v) noexcept { XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(p), v); }
+    };
+
+    struct StoreHalf4
+    {
+        static constexpr size_t c_Size = sizeof(XMHALF4);
+        static void Store(uint8_t* p, FXMVECTOR v) noexcept { XMStoreHalf4(reinterpret_cast<XMHALF4*>(p), XMVectorClamp(v, g_HalfMin, g_HalfMax)); }
+    };
+
+    struct StoreRGBA8
+    {
+        static constexpr size_t c_Size = sizeof(XMUBYTEN4);
+        static void Store(uint8_t* p, FXMVECTOR v) noexcept { XMStoreUByteN4(reinterpret_cast<XMUBYTEN4*>(p), XMVectorAdd(v, g_8BitBias)); }
+    };
+
+    struct StoreBGRA8
+    {
+        static constexpr size_t c_Size = sizeof(XMUBYTEN4);
+        static void Store(uint8_t* p, FXMVECTOR v) noexcept { XMStoreUByteN4(reinterpret_cast<XMUBYTEN4*>(p), XMVectorAdd(XMVectorSwizzle<2, 1, 0, 3>(v), g_8BitBias)); }
+    };
+
+    template<class TLoad, class TFixup, class TStore>
+    void ConvertRowFloat(uint8_t* __restrict pDest, const uint8_t* __restrict pSrc, size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            TStore::Store(pDest, TFixup::Apply(TLoad::Load(pSrc)));
+            pSrc += TLoad::c_Size;
+            pDest += TStore::c_Size;
+        }
+    }
+
+    // 8-bit sources; BGR selects B8G8R8A8 input
+    template<bool BGR>
+    void ConvertRowUNorm8ToFloat4(uint8_t* __restrict pDest, const uint8_t* __restrict pSrc, size_t count) noexcept
+    {
+        const float* lut = GetUNorm8Tables().toFloat;
+        auto dPtr = reinterpret_cast<float*>(pDest);
+        for (size_t i = 0; i < count; ++i, pSrc += 4, dPtr += 4)
+        {
+            dPtr[0] = lut[pSrc[BGR ? 2 : 0]];
+            dPtr[1] = lut[pSrc[1]];
+            dPtr[2] = lut[pSrc[BGR ? 0 : 2]];
+            dPtr[3] = lut[pSrc[3]];
+        }
+    }
+
+    template<bool BGR>
+    void ConvertRowUNorm8ToHalf4(uint8_t* __restrict pDest, const uint8_t* __restrict pSrc, size_t count) noexcept
+    {
+        const HALF* lut = GetUNorm8Tables().toHalf;
+        auto dPtr = reinterpret_cast<HALF*>(pDest);
+        for (size_t i = 0; i < count; ++i, pSrc += 4, dPtr += 4)
+        {
+            dPtr[0] = lut[pSrc[BGR ? 2 : 0]];
+            dPtr[1] = lut[pSrc[1]];
+            dPtr[2] = lut[pSrc[BGR ? 0 : 2]];
+            dPtr[3] = lut[pSrc[3]];
+        }
+    }
+
+    void ConvertRowSwapRB8(uint8_t* __restrict pDest, const uint8_t* __restrict pSrc, size_t count) noexcept
+    {
+        const UNorm8Tables& tables = GetUNorm8Tables();
+        if (tables.byteIdentity)
+        {
+            // Round trip through float is exact, so this is just a red/blue swap
+            for (size_t i = 0; i < count; ++i, pSrc += 4, pDest += 4)
+            {
+                uint32_t t;
+                memcpy(&t, pSrc, sizeof(t));
+                t = (t & 0xFF00FF00) | ((t >> 16) & 0xFF) | ((t & 0xFF) << 16);
+                memcpy(pDest, &t, sizeof(t));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i, pSrc += 4, pDest += 4)
+            {
+                pDest[0] = tables.toByte[pSrc[2]];
+                pDest[1] = tables.toByte[pSrc[1]];
+                pDest[2] = tables.toByte[pSrc[0]];
+                pDest[3] = tables.toByte[pSrc[3]];
+            }
+        }
+    }
+
+    DirectConvertFunc GetDirectConverter(
+        _In_ DXGI_FORMAT inFormat,
+        _In_ DXGI_FORMAT outFormat,
+        _In_ TEX_FILTER_FLAGS filter) noexcept
+    {
+        // Any of these change what ConvertScanline/StoreScanline would do
+        if (filter & (TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION | TEX_FILTER_SRGB | TEX_FILTER_FLOAT_X2BIAS
+            | TEX_FILTER_RGB_COPY_RED | TEX_FILTER_RGB_COPY_GREEN | TEX_FILTER_RGB_COPY_BLUE | TEX_FILTER_RGB_COPY_ALPHA))
+            return nullptr;
+
+        switch (inFormat)
+        {
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            switch (outFormat)
+            {
+            case DXGI_FORMAT_R16G16B16A16_FLOAT: return ConvertRowFloat<LoadFloat4, NoFixup, StoreHalf4>;
+            case DXGI_FORMAT_R8G8B8A8_UNORM:     return ConvertRowFloat<LoadFloat4, SaturateFixup, StoreRGBA8>;
+            case DXGI_FORMAT_B8G8R8A8_UNORM:     return ConvertRowFloat<LoadFloat4, SaturateFixup, StoreBGRA8>;
+            default: break;
+            }
+            break;
+
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            switch (outFormat)
+            {
+            case DXGI_FORMAT_R32G32B32A32_FLOAT: return ConvertRowFloat<LoadHalf4, NoFixup, StoreFloat4>;
+            case DXGI_FORMAT_R8G8B8A8_UNORM:     return ConvertRowFloat<LoadHalf4, SaturateFixup, StoreRGBA8>;
+            case DXGI_FORMAT_B8G8R8A8_UNORM:     return ConvertRowFloat<LoadHalf4, SaturateFixup, StoreBGRA8>;
+            default: break;
+            }
+            break;
+
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            switch (outFormat)
+            {
+            case DXGI_FORMAT_R32G32B32A32_FLOAT: return ConvertRowUNorm8ToFloat4<false>;
+            case DXGI_FORMAT_R16G16B16A16_FLOAT: return ConvertRowUNorm8ToHalf4<false>;
+            case DXGI_FORMAT_B8G8R8A8_UNORM:     return ConvertRowSwapRB8;
+            default: break;
+            }
+            break;
+
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            switch (outFormat)
+            {
+            case DXGI_FORMAT_R32G32B32A32_FLOAT: return ConvertRowUNorm8ToFloat4<true>;
+            case DXGI_FORMAT_R16G16B16A16_FLOAT: return ConvertRowUNorm8ToHalf4<true>;
+            case DXGI_FORMAT_R8G8B8A8_UNORM:     return ConvertRowSwapRB8;
+            default: break;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        return nullptr;
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Convert the source image (not using WIC)
     //-------------------------------------------------------------------------------------
@@ -4880,6 +5102,25 @@ namespace
                     pDest += destImage.rowPitch;
                 }
             }
+            else if (auto pfConvert = (pSrc != pDest) ? GetDirectConverter(srcImage.format, destImage.format, filter) : nullptr)
+            {
+                // No dithering, direct conversion
+                for (size_t h = 0; h < srcImage.height; ++h)
+                {
+                    if (statusCallback)
+                    {
+                        if (!statusCallback(h, srcImage.height))
+                        {
+                            return E_ABORT;
+                        }
+                    }
+
+                    pfConvert(pDest, pSrc, width);
+
+                    pSrc += srcImage.rowPitch;
+                    pDest += destImage.rowPitch;
+                }
+            }
             else
             {
                 // No dithering
@@ -4910,6 +5151,321 @@ namespace
         return S_OK;
     }
 
+    //-------------------------------------------------------------------------------------
+    // Multithreaded conversion (TEX_FILTER_PARALLEL)
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_ConvertBandRows = 16;
+
+    // Converts rows [y0, y1) of an image; not used for error diffusion, which carries state between rows
+    bool ConvertRows(
+        _In_ const Image& srcImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ const Image& destImage,
+        _In_ float threshold,
+        size_t z,
+        size_t y0,
+        size_t y1,
+        _Inout_updates_all_(srcImage.width) XMVECTOR* scanline) noexcept
+    {
+        assert(!(filter & TEX_FILTER_DITHER_DIFFUSION));
+
+        const size_t width = srcImage.width;
+        const uint8_t *pSrc = srcImage.pixels + y0 * srcImage.rowPitch;
+        uint8_t *pDest = destImage.pixels + y0 * destImage.rowPitch;
+
+        // The direct converters assume the rows do not alias
+        const DirectConvertFunc pfConvert = (srcImage.pixels != destImage.pixels)
+            ? GetDirectConverter(srcImage.format, destImage.format, filter) : nullptr;
+
+        for (size_t h = y0; h < y1; ++h)
+        {
+            if (pfConvert)
+            {
+                pfConvert(pDest, pSrc, width);
+            }
+            else
+            {
+                if (!LoadScanline(scanline, width, pSrc, srcImage.rowPitch, srcImage.format))
+                    return false;
+
+                ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
+
+                if (filter & TEX_FILTER_DITHER)
+                {
+                    // Ordered dithering only depends on the pixel position
+                    if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold, h, z, nullptr))
+                        return false;
+                }
+                else if (!StoreScanline(pDest, destImage.rowPitch, destImage.format, scanline, width, threshold))
+                {
+                    return false;
+                }
+            }
+
+            pSrc += srcImage.rowPitch;
+            pDest += destImage.rowPitch;
+        }
+
+        return true;
+    }
+
+    // Splits every image into bands of rows and converts them on all workers. Progress is
+    // reported in rows for a single image, otherwise as each image completes.
+    HRESULT ConvertBands_Parallel(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_reads_(nimages) const Image* destImages,
+        _In_reads_(nimages) const size_t* zIndices,
+        size_t nimages,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ float threshold,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        std::unique_ptr<size_t[]> firstBand(new (std::nothrow) size_t[nimages + 1]);
+        std::unique_ptr<size_t[]> remaining(new (std::nothrow) size_t[nimages]);
+        if (!firstBand || !remaining)
+            return E_OUTOFMEMORY;
+
+        size_t maxWidth = 1;
+        firstBand[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            if (!srcImages[index].pixels || !destImages[index].pixels)
+                return E_POINTER;
+
+            const size_t nBands = (srcImages[index].height + c_ConvertBandRows - 1) / c_ConvertBandRows;
+            firstBand[index + 1] = firstBand[index] + nBands;
+            remaining[index] = nBands;
+            maxWidth = std::max(maxWidth, srcImages[index].width);
+        }
+
+        const size_t totalBands = firstBand[nimages];
+        const size_t workers = GetWorkerCount(totalBands);
+
+        auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(maxWidth) * workers);
+        if (!scanlines)
+            return E_OUTOFMEMORY;
+
+        std::mutex progressLock;
+        size_t rowsDone = 0;
+        size_t imagesDone = 0;
+        bool abort = false;
+        bool fail = false;
+
+        ParallelFor(totalBands, workers, [&](size_t item, size_t worker) noexcept -> bool
+            {
+                const size_t index = static_cast<size_t>(std::upper_bound(firstBand.get(), firstBand.get() + nimages + 1, item) - firstBand.get()) - 1;
+                assert(index < nimages);
+
+                const Image& src = srcImages[index];
+                const size_t y0 = (item - firstBand[index]) * c_ConvertBandRows;
+                const size_t y1 = std::min(y0 + c_ConvertBandRows, src.height);
+
+                if (!ConvertRows(src, filter, destImages[index], threshold, zIndices[index], y0, y1, scanlines.get() + worker * maxWidth))
+                {
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    fail = true;
+                    return false;
+                }
+
+                if (statusCallback)
+                {
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    bool more = true;
+                    if (nimages == 1)
+                    {
+                        rowsDone += y1 - y0;
+                        more = abort || statusCallback(rowsDone, src.height);
+                    }
+                    else if (--remaining[index] == 0)
+                    {
+                        ++imagesDone;
+                        more = abort || statusCallback(imagesDone, nimages);
+                    }
+
+                    if (!more)
+                    {
+                        abort = true;
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+        if (abort)
+            return E_ABORT;
+
+        return (fail) ? E_FAIL : S_OK;
+    }
+
+    // Error diffusion is inherently serial from row to row, so rows are loaded and converted in
+    // parallel a band at a time, and then dithered in order. The result matches ConvertCustom.
+    HRESULT ConvertDiffusion_Parallel(
+        _In_ const Image& srcImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ const Image& destImage,
+        _In_ float threshold,
+        size_t z,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        const uint8_t *pSrc = srcImage.pixels;
+        uint8_t *pDest = destImage.pixels;
+        if (!pSrc || !pDest)
+            return E_POINTER;
+
+        const size_t width = srcImage.width;
+        const size_t workers = GetWorkerCount(srcImage.height);
+        const size_t bandRows = c_ConvertBandRows * workers;
+
+        auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(width) * bandRows + width + 2);
+        if (!scanlines)
+            return E_OUTOFMEMORY;
+
+        XMVECTOR* pDiffusionErrors = scanlines.get() + width * bandRows;
+        memset(pDiffusionErrors, 0, sizeof(XMVECTOR)*(width + 2));
+
+        for (size_t y = 0; y < srcImage.height; y += bandRows)
+        {
+            if (statusCallback)
+            {
+                if (!statusCallback(y, srcImage.height))
+                {
+                    return E_ABORT;
+                }
+            }
+
+            const size_t rows = std::min(bandRows, srcImage.height - y);
+
+            const bool ok = ParallelFor(rows, workers, [&](size_t r, size_t) noexcept -> bool
+                {
+                    XMVECTOR* scanline = scanlines.get() + r * width;
+                    if (!LoadScanline(scanline, width, pSrc + (y + r) * srcImage.rowPitch, srcImage.rowPitch, srcImage.format))
+                        return false;
+
+                    ConvertScanline(scanline, width, destImage.format, srcImage.format, filter);
+                    return true;
+                });
+
+            if (!ok)
+                return E_FAIL;
+
+            for (size_t r = 0; r < rows; ++r)
+            {
+                if (!StoreScanlineDither(pDest, destImage.rowPitch, destImage.format, scanlines.get() + r * width, width, threshold, y + r, z, pDiffusionErrors))
+                    return E_FAIL;
+
+                pDest += destImage.rowPitch;
+            }
+        }
+
+        return S_OK;
+    }
+
+    HRESULT ConvertCustom_Parallel(
+        _In_ const Image& srcImage,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ const Image& destImage,
+        _In_ float threshold,
+        size_t z,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        assert(srcImage.width == destImage.width);
+        assert(srcImage.height == destImage.height);
+
+        if (filter & TEX_FILTER_DITHER_DIFFUSION)
+        {
+            return ConvertDiffusion_Parallel(srcImage, filter, destImage, threshold, z, statusCallback);
+        }
+
+        return ConvertBands_Parallel(&srcImage, &destImage, &z, 1, filter, threshold, statusCallback);
+    }
+
+    // Converts all images of a complex texture at once; z is the volume slice used by dithering
+    HRESULT ConvertChain_Parallel(
+        _In_reads_(nimages) const Image* srcImages,
+        _In_reads_(nimages) const Image* destImages,
+        size_t nimages,
+        _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter,
+        _In_ float threshold,
+        const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
+    {
+        std::unique_ptr<size_t[]> zIndices(new (std::nothrow) size_t[nimages]);
+        if (!zIndices)
+            return E_OUTOFMEMORY;
+
+        if (metadata.dimension == TEX_DIMENSION_TEXTURE3D)
+        {
+            size_t index = 0;
+            size_t d = metadata.depth;
+            for (size_t level = 0; level < metadata.mipLevels; ++level)
+            {
+                for (size_t slice = 0; slice < d; ++slice, ++index)
+                {
+                    if (index >= nimages)
+                        return E_FAIL;
+
+                    zIndices[index] = slice;
+                }
+
+                if (d > 1)
+                    d >>= 1;
+            }
+        }
+        else
+        {
+            for (size_t index = 0; index < nimages; ++index)
+                zIndices[index] = 0;
+        }
+
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            const Image& src = srcImages[index];
+            const Image& dst = destImages[index];
+            if (src.format != metadata.format
+                || (src.width > UINT32_MAX) || (src.height > UINT32_MAX)
+                || src.width != dst.width || src.height != dst.height)
+                return E_FAIL;
+        }
+
+        if (filter & TEX_FILTER_DITHER_DIFFUSION)
+        {
+            // Each image is diffused serially, but images are independent of each other
+            std::mutex progressLock;
+            size_t imagesDone = 0;
+            bool abort = false;
+            HRESULT hrFail = S_OK;
+
+            ParallelFor(nimages, GetWorkerCount(nimages), [&](size_t index, size_t) noexcept -> bool
+                {
+                    const HRESULT hr = ConvertCustom(srcImages[index], filter, destImages[index], threshold, zIndices[index], nullptr);
+
+                    std::lock_guard<std::mutex> lock(progressLock);
+                    if (FAILED(hr))
+                    {
+                        hrFail = hr;
+                        return false;
+                    }
+
+                    ++imagesDone;
+                    if (statusCallback && !abort && !statusCallback(imagesDone, nimages))
+                    {
+                        abort = true;
+                        return false;
+                    }
+
+                    return true;
+                });
+
+            if (abort)
+                return E_ABORT;
+
+            return hrFail;
+        }
+
+        return ConvertBands_Parallel(srcImages, destImages, zIndices.get(), nimages, filter, threshold, statusCallback);
+    }
+
     //-------------------------------------------------------------------------------------
     DXGI_FORMAT PlanarToSingle(_In_ DXGI_FORMAT format) noexcept
     {
@@ -5148,6 +5704,10 @@ HRESULT DirectX::ConvertEx(
     {
         hr = ConvertUsingWIC(srcImage, pfGUID, targetGUID, options.filter, options.threshold, *rimage);
     }
+    else if (options.filter & TEX_FILTER_PARALLEL)
+    {
+        hr = ConvertCustom_Parallel(srcImage, options.filter, *rimage, options.threshold, 0, statusCallback);
+    }
     else
     {
         hr = ConvertCustom(srcImage, options.filter, *rimage, options.threshold, 0, statusCallback);
@@ -5258,6 +5818,19 @@ HRESULT DirectX::ConvertEx(
     WICPixelFormatGUID pfGUID, targetGUID;
     const bool usewic = !metadata.IsPMAlpha() && UseWICConversion(options.filter, metadata.format, format, pfGUID, targetGUID);
 
+    if (!usewic && (options.filter & TEX_FILTER_PARALLEL)
+        && (metadata.dimension == TEX_DIMENSION_TEXTURE1D || metadata.dimension == TEX_DIMENSION_TEXTURE2D || metadata.dimension == TEX_DIMENSION_TEXTURE3D))
+    {
+        hr = ConvertChain_Parallel(srcImages, dest, nimages, metadata, options.filter, options.threshold, statusCallback);
+        if (FAILED(hr))
+        {
+            result.Release();
+            return hr;
+        }
+
+        return S_OK;
+    }
+
     switch (metadata.dimension)
     {
     case TEX_DIMENSION_TEXTURE1D:
@@ -5397,6 +5970,103 @@ HRESULT DirectX::ConvertEx(
 }
 
 
+//-------------------------------------------------------------------------------------
+// Convert image (in place)
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::Convert(
+    ScratchImage& image,
+    DXGI_FORMAT format,
+    TEX_FILTER_FLAGS filter,
+    float threshold) noexcept
+{
+    const Image* images = image.GetImages();
+    const size_t nimages = image.GetImageCount();
+    const TexMetadata& metadata = image.GetMetadata();
+
+    if (!images || !nimages || (metadata.format == format) || !IsValid(format))
+        return E_INVALIDARG;
+
+    if (IsCompressed(metadata.format) || IsCompressed(format)
+        || IsPlanar(metadata.format) || IsPlanar(format)
+        || IsPalettized(metadata.format) || IsPalettized(format)
+        || IsTypeless(metadata.format) || IsTypeless(format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if ((metadata.width > UINT32_MAX) || (metadata.height > UINT32_MAX))
+        return E_INVALIDARG;
+
+    // WIC conversions need a separate target, so leave those to the copying version
+    WICPixelFormatGUID pfGUID, targetGUID;
+    if (!metadata.IsPMAlpha() && UseWICConversion(filter, metadata.format, format, pfGUID, targetGUID))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    std::unique_ptr<Image[]> dest(new (std::nothrow) Image[nimages]);
+    if (!dest)
+        return E_OUTOFMEMORY;
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const Image& src = images[index];
+        if (src.format != metadata.format)
+            return E_FAIL;
+
+        size_t rowPitch, slicePitch;
+        HRESULT hr = ComputePitch(format, src.width, src.height, rowPitch, slicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
+
+        if (rowPitch != src.rowPitch || slicePitch != src.slicePitch)
+            return HRESULT_E_NOT_SUPPORTED;
+
+        dest[index] = src;
+        dest[index].format = format;
+    }
+
+    HRESULT hr = S_OK;
+    if (filter & TEX_FILTER_PARALLEL)
+    {
+        hr = ConvertChain_Parallel(images, dest.get(), nimages, metadata, filter, threshold, nullptr);
+    }
+    else if (metadata.dimension == TEX_DIMENSION_TEXTURE3D)
+    {
+        size_t index = 0;
+        size_t d = metadata.depth;
+        for (size_t level = 0; level < metadata.mipLevels && SUCCEEDED(hr); ++level)
+        {
+            for (size_t slice = 0; slice < d && SUCCEEDED(hr); ++slice, ++index)
+            {
+                hr = (index < nimages) ? ConvertCustom(images[index], filter, dest[index], threshold, slice, nullptr) : E_FAIL;
+            }
+
+            if (d > 1)
+                d >>= 1;
+        }
+    }
+    else
+    {
+        for (size_t index = 0; index < nimages && SUCCEEDED(hr); ++index)
+        {
+            hr = ConvertCustom(images[index], filter, dest[index], threshold, 0, nullptr);
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        image.Release();
+        return hr;
+    }
+
+    if (!image.OverrideFormat(format))
+    {
+        image.Release();
+        return E_FAIL;
+    }
+
+    return S_OK;
+}
+
+
 //-------------------------------------------------------------------------------------
 // Convert image from planar to single plane (image)
 //-------------------------------------------------------------------------------------
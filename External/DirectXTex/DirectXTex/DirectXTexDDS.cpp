@@ -1469,6 +1469,94 @@ namespace
         }
     }
 
+    //-------------------------------------------------------------------------------------
+    // Returns the source pitch flags implied by a legacy expansion
+    //-------------------------------------------------------------------------------------
+    CP_FLAGS GetLegacyPitchFlags(uint32_t convFlags) noexcept
+    {
+        if (convFlags & CONV_FLAGS_EXPAND)
+        {
+            if (convFlags & CONV_FLAGS_888)
+                return CP_FLAGS_24BPP;
+            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
+                return CP_FLAGS_16BPP;
+            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
+                return CP_FLAGS_8BPP;
+        }
+
+        return CP_FLAGS_NONE;
+    }
+
+
+    //-------------------------------------------------------------------------------------
+    // Converts or copies rows of a single uncompressed, non-planar subresource
+    //   pDest may equal pSource when no expansion is required (in-place conversion)
+    //-------------------------------------------------------------------------------------
+    _Success_(return) bool ConvertScanlines(
+        _Out_writes_bytes_(dpitch * height) uint8_t* pDest, size_t dpitch,
+        _In_reads_bytes_(spitch * height) const uint8_t* pSrc, size_t spitch,
+        size_t height,
+        DXGI_FORMAT format,
+        uint32_t convFlags,
+        _In_reads_opt_(256) const uint32_t *pal8) noexcept
+    {
+        uint32_t tflags = (convFlags & CONV_FLAGS_NOALPHA) ? TEXP_SCANLINE_SETALPHA : 0u;
+        if (convFlags & CONV_FLAGS_SWIZZLE)
+            tflags |= TEXP_SCANLINE_LEGACY;
+
+        for (size_t h = 0; h < height; ++h)
+        {
+            if (convFlags & CONV_FLAGS_EXPAND)
+            {
+                if (convFlags & CONV_FLAGS_4444)
+                {
+                    if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
+                        pSrc, spitch,
+                        (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
+                        tflags))
+                        return false;
+                }
+                else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
+                {
+                    if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
+                        pSrc, spitch,
+                        (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
+                        tflags))
+                        return false;
+                }
+                else
+                {
+                    const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
+                    if (!LegacyExpandScanline(pDest, dpitch, format,
+                        pSrc, spitch, lformat, pal8,
+                        tflags))
+                        return false;
+                }
+            }
+            else if (convFlags & CONV_FLAGS_SWIZZLE)
+            {
+                SwizzleScanline(pDest, dpitch, pSrc, spitch, format, tflags);
+            }
+            else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
+            {
+                const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
+                if (!LegacyConvertScanline(pDest, dpitch, format,
+                    pSrc, spitch, lformat, tflags))
+                    return false;
+            }
+            else
+            {
+                CopyScanline(pDest, dpitch, pSrc, spitch, format, tflags);
+            }
+
+            pSrc += spitch;
+            pDest += dpitch;
+        }
+
+        return true;
+    }
+
+
     //-------------------------------------------------------------------------------------
     // Converts or copies image data from pPixels into scratch image data
     //-------------------------------------------------------------------------------------
@@ -1487,15 +1575,7 @@ namespace
         if (!size)
             return E_FAIL;
 
-        if (convFlags & CONV_FLAGS_EXPAND)
-        {
-            if (convFlags & CONV_FLAGS_888)
-                cpFlags |= CP_FLAGS_24BPP;
-            else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551 | CONV_FLAGS_4444 | CONV_FLAGS_8332 | CONV_FLAGS_A8P8 | CONV_FLAGS_L16 | CONV_FLAGS_A8L8 | CONV_FLAGS_L6V5U5))
-                cpFlags |= CP_FLAGS_16BPP;
-            else if (convFlags & (CONV_FLAGS_44 | CONV_FLAGS_332 | CONV_FLAGS_PAL8 | CONV_FLAGS_L8))
-                cpFlags |= CP_FLAGS_8BPP;
-        }
+        cpFlags |= GetLegacyPitchFlags(convFlags);
 
         size_t pixelSize, nimages;
         HRESULT hr = DetermineImageArray(metadata, cpFlags, nimages, pixelSize);
@@ -1540,10 +1620,6 @@ namespace
             return E_FAIL;
         }
 
-        uint32_t tflags = (convFlags & CONV_FLAGS_NOALPHA) ? TEXP_SCANLINE_SETALPHA : 0u;
-        if (convFlags & CONV_FLAGS_SWIZZLE)
-            tflags |= TEXP_SCANLINE_LEGACY;
-
         switch (metadata.dimension)
         {
         case TEX_DIMENSION_TEXTURE1D:
@@ -1606,54 +1682,9 @@ namespace
                         }
                         else
                         {
-                            for (size_t h = 0; h < images[index].height; ++h)
-                            {
-                                if (convFlags & CONV_FLAGS_EXPAND)
-                                {
-                                    if (convFlags & CONV_FLAGS_4444)
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else
-                                    {
-                                        const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                        if (!LegacyExpandScanline(pDest, dpitch, metadata.format,
-                                            pSrc, spitch, lformat, pal8,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                }
-                                else if (convFlags & CONV_FLAGS_SWIZZLE)
-                                {
-                                    SwizzleScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-                                else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
-                                {
-                                    const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                    if (!LegacyConvertScanline(pDest, dpitch, metadata.format,
-                                        pSrc, spitch, lformat, tflags))
-                                        return E_FAIL;
-                                }
-                                else
-                                {
-                                    CopyScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-
-                                pSrc += spitch;
-                                pDest += dpitch;
-                            }
+                            if (!ConvertScanlines(pDest, dpitch, pSrc, spitch, images[index].height,
+                                metadata.format, convFlags, pal8))
+                                return E_FAIL;
                         }
                     }
                 }
@@ -1712,54 +1743,9 @@ namespace
                         }
                         else
                         {
-                            for (size_t h = 0; h < images[index].height; ++h)
-                            {
-                                if (convFlags & CONV_FLAGS_EXPAND)
-                                {
-                                    if (convFlags & CONV_FLAGS_4444)
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONF_FLAGS_11ON12) ? WIN11_DXGI_FORMAT_A4B4G4R4_UNORM : DXGI_FORMAT_B4G4R4A4_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else if (convFlags & (CONV_FLAGS_565 | CONV_FLAGS_5551))
-                                    {
-                                        if (!ExpandScanline(pDest, dpitch, DXGI_FORMAT_R8G8B8A8_UNORM,
-                                            pSrc, spitch,
-                                            (convFlags & CONV_FLAGS_565) ? DXGI_FORMAT_B5G6R5_UNORM : DXGI_FORMAT_B5G5R5A1_UNORM,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                    else
-                                    {
-                                        const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                        if (!LegacyExpandScanline(pDest, dpitch, metadata.format,
-                                            pSrc, spitch, lformat, pal8,
-                                            tflags))
-                                            return E_FAIL;
-                                    }
-                                }
-                                else if (convFlags & CONV_FLAGS_SWIZZLE)
-                                {
-                                    SwizzleScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-                                else if (convFlags & (CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
-                                {
-                                    const TEXP_LEGACY_FORMAT lformat = FindLegacyFormat(convFlags);
-                                    if (!LegacyConvertScanline(pDest, dpitch, metadata.format,
-                                        pSrc, spitch, lformat, tflags))
-                                        return E_FAIL;
-                                }
-                                else
-                                {
-                                    CopyScanline(pDest, dpitch, pSrc, spitch, metadata.format, tflags);
-                                }
-
-                                pSrc += spitch;
-                                pDest += dpitch;
-                            }
+                            if (!ConvertScanlines(pDest, dpitch, pSrc, spitch, images[index].height,
+                                metadata.format, convFlags, pal8))
+                                return E_FAIL;
                         }
                     }
 
@@ -1900,13 +1886,13 @@ HRESULT DirectX::GetMetadataFromDDSFileEx(
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid DDS file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
     {
         return HRESULT_E_FILE_TOO_LARGE;
     }
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -1916,14 +1902,14 @@ HRESULT DirectX::GetMetadataFromDDSFileEx(
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    const size_t len = fileLen;
+    const auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the standard header and magic number to be a valid DDS
@@ -2110,11 +2096,11 @@ HRESULT DirectX::LoadFromDDSFileEx(
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid DDS file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -2124,14 +2110,14 @@ HRESULT DirectX::LoadFromDDSFileEx(
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    const size_t len = fileLen;
+    const auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the standard header and magic number to be a valid DDS
@@ -2253,25 +2239,15 @@ HRESULT DirectX::LoadFromDDSFileEx(
         }
 
     #ifdef _WIN32
-        if (!ReadFile(hFile.get(), temp.get(), static_cast<DWORD>(remaining), &bytesRead, nullptr))
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead != remaining)
-        {
-            image.Release();
-            return E_FAIL;
-        }
+        hr = ReadFileChunked(hFile.get(), temp.get(), remaining);
     #else
-        inFile.read(reinterpret_cast<char*>(temp.get()), remaining);
-        if (!inFile)
+        hr = ReadFileChunked(inFile, temp.get(), remaining);
+    #endif
+        if (FAILED(hr))
         {
             image.Release();
-            return E_FAIL;
+            return hr;
         }
-    #endif
 
         CP_FLAGS cflags = CP_FLAGS_NONE;
         if (flags & DDS_FLAGS_LEGACY_DWORD)
@@ -2304,33 +2280,16 @@ HRESULT DirectX::LoadFromDDSFileEx(
             return HRESULT_E_HANDLE_EOF;
         }
 
-        if (image.GetPixelsSize() > UINT32_MAX)
-        {
-            image.Release();
-            return HRESULT_E_ARITHMETIC_OVERFLOW;
-        }
-
     #ifdef _WIN32
-        const auto pixelBytes = static_cast<DWORD>(image.GetPixelsSize());
-        if (!ReadFile(hFile.get(), image.GetPixels(), pixelBytes, &bytesRead, nullptr))
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead != pixelBytes)
-        {
-            image.Release();
-            return E_FAIL;
-        }
+        hr = ReadFileChunked(hFile.get(), image.GetPixels(), image.GetPixelsSize());
     #else
-        inFile.read(reinterpret_cast<char*>(image.GetPixels()), image.GetPixelsSize());
-        if (!inFile)
+        hr = ReadFileChunked(inFile, image.GetPixels(), image.GetPixelsSize());
+    #endif
+        if (FAILED(hr))
         {
             image.Release();
-            return E_FAIL;
+            return hr;
         }
-    #endif
 
         if (convFlags & (CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
         {
@@ -2352,121 +2311,959 @@ HRESULT DirectX::LoadFromDDSFileEx(
 
 
 //-------------------------------------------------------------------------------------
-// Save a DDS file to memory
+// Load a DDS file from disk through a read-only file mapping
 //-------------------------------------------------------------------------------------
 _Use_decl_annotations_
-HRESULT DirectX::SaveToDDSMemory(
-    const Image* images,
-    size_t nimages,
-    const TexMetadata& metadata,
+HRESULT DirectX::LoadFromDDSFileMapped(
+    const wchar_t* szFile,
     DDS_FLAGS flags,
-    Blob& blob) noexcept
+    TexMetadata* metadata,
+    MappedImage& image) noexcept
 {
-    if (!images || (nimages == 0))
+    HRESULT hr = image.InitializeFromDDSFile(szFile, flags);
+    if (FAILED(hr))
+        return hr;
+
+    if (metadata)
+        memcpy(metadata, &image.GetMetadata(), sizeof(TexMetadata));
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT MappedImage::InitializeFromDDSFile(const wchar_t* szFile, DDS_FLAGS flags) noexcept
+{
+    if (!szFile)
         return E_INVALIDARG;
 
-    // Determine memory required
-    size_t required = 0;
-    HRESULT hr = EncodeDDSHeader(metadata, flags, nullptr, 0, required);
+    Release();
+
+    void* pView = nullptr;
+    size_t len = 0;
+    HRESULT hr = MapFileCopyOnWrite(szFile, &pView, len);
     if (FAILED(hr))
         return hr;
 
-    bool fastpath = true;
+    auto pSource = static_cast<const uint8_t*>(pView);
 
-    for (size_t i = 0; i < nimages; ++i)
+    uint32_t convFlags = 0;
+    TexMetadata mdata;
+    hr = DecodeDDSHeader(pSource, len, flags, mdata, nullptr, convFlags);
+    if (FAILED(hr))
     {
-        if (!images[i].pixels)
-            return E_POINTER;
-
-        if (images[i].format != metadata.format)
-            return E_FAIL;
+        UnmapFile(pView, len);
+        return hr;
+    }
 
-        size_t ddsRowPitch, ddsSlicePitch;
-        hr = ComputePitch(metadata.format, images[i].width, images[i].height, ddsRowPitch, ddsSlicePitch, CP_FLAGS_NONE);
+    if ((convFlags & (CONV_FLAGS_EXPAND | CONV_FLAGS_PAL8 | CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10))
+        || (flags & (DDS_FLAGS_LEGACY_DWORD | DDS_FLAGS_BAD_DXTN_TAILS)))
+    {
+        // Needs conversion, so decode straight from the mapping into owned memory (no intermediate copy)
+        hr = LoadFromDDSMemoryEx(pSource, len, flags, &mdata, nullptr, m_converted);
+        UnmapFile(pView, len);
         if (FAILED(hr))
             return hr;
 
-        assert(images[i].rowPitch > 0);
-        assert(images[i].slicePitch > 0);
+        m_metadata = mdata;
+        return S_OK;
+    }
 
-        if ((images[i].rowPitch != ddsRowPitch) || (images[i].slicePitch != ddsSlicePitch))
+    size_t offset = DDS_MIN_HEADER_SIZE;
+    if (convFlags & CONV_FLAGS_DX10)
+        offset += sizeof(DDS_HEADER_DXT10);
+
+    assert(offset <= len);
+    const size_t remaining = len - offset;
+
+    size_t nimages = 0;
+    size_t pixelSize = 0;
+    hr = DetermineImageArray(mdata, CP_FLAGS_NONE, nimages, pixelSize);
+    if (SUCCEEDED(hr) && (flags & DDS_FLAGS_PERMISSIVE))
+    {
+        // See LoadFromDDSMemoryEx for the 'number of cubes' fix-up
+        if ((mdata.miscFlags & TEX_MISC_TEXTURECUBE)
+            && (convFlags & CONV_FLAGS_DX10)
+            && (pixelSize > remaining)
+            && ((mdata.arraySize % 6) == 0))
         {
-            fastpath = false;
+            mdata.arraySize = mdata.arraySize / 6;
+            hr = DetermineImageArray(mdata, CP_FLAGS_NONE, nimages, pixelSize);
         }
+    }
 
-        required += ddsSlicePitch;
+    if (SUCCEEDED(hr) && (pixelSize > remaining))
+    {
+        hr = HRESULT_E_HANDLE_EOF;
     }
 
-    assert(required > 0);
+    if (SUCCEEDED(hr))
+    {
+        m_image = new (std::nothrow) Image[nimages];
+        if (!m_image)
+        {
+            hr = E_OUTOFMEMORY;
+        }
+        else
+        {
+            memset(m_image, 0, sizeof(Image) * nimages);
 
-    blob.Release();
+            // The view is copy-on-write, so in-place operations on these images are safe
+            auto pPixels = static_cast<uint8_t*>(pView) + offset;
+            if (!SetupImageArray(pPixels, pixelSize, mdata, CP_FLAGS_NONE, m_image, nimages))
+                hr = E_FAIL;
+        }
+    }
 
-    hr = blob.Initialize(required);
     if (FAILED(hr))
+    {
+        delete[] m_image;
+        m_image = nullptr;
+        UnmapFile(pView, len);
         return hr;
+    }
 
-    auto pDestination = blob.GetBufferPointer();
-    assert(pDestination);
+    m_nimages = nimages;
+    m_size = pixelSize;
+    m_metadata = mdata;
+    m_pixels = pSource + offset;
+    m_view = pView;
+    m_viewSize = len;
 
-    hr = EncodeDDSHeader(metadata, flags, pDestination, blob.GetBufferSize(), required);
-    if (FAILED(hr))
+    return S_OK;
+}
+
+
+//=====================================================================================
+// DDSReader - Incremental subresource reader
+//=====================================================================================
+
+DDSReader& DDSReader::operator= (DDSReader&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
     {
-        blob.Release();
-        return hr;
+        Close();
+
+        m_file = moveFrom.m_file;
+        m_fileSize = moveFrom.m_fileSize;
+        m_metadata = moveFrom.m_metadata;
+        m_flags = moveFrom.m_flags;
+        m_convFlags = moveFrom.m_convFlags;
+        m_nimages = moveFrom.m_nimages;
+        m_offsets = moveFrom.m_offsets;
+        m_palette = moveFrom.m_palette;
+
+        moveFrom.m_file = INVALID_FILE;
+        moveFrom.m_fileSize = 0;
+        moveFrom.m_nimages = 0;
+        moveFrom.m_offsets = nullptr;
+        moveFrom.m_palette = nullptr;
     }
+    return *this;
+}
 
-    size_t remaining = blob.GetBufferSize() - required;
-    pDestination += required;
+void DDSReader::Close() noexcept
+{
+    CloseFile(m_file);
+    m_file = INVALID_FILE;
+    m_fileSize = 0;
 
-    if (remaining == 0)
+    m_flags = DDS_FLAGS_NONE;
+    m_convFlags = 0;
+    m_nimages = 0;
+
+    if (m_offsets)
     {
-        blob.Release();
-        return E_FAIL;
+        delete[] m_offsets;
+        m_offsets = nullptr;
     }
 
-    switch (static_cast<DDS_RESOURCE_DIMENSION>(metadata.dimension))
+    if (m_palette)
     {
-    case DDS_DIMENSION_TEXTURE1D:
-    case DDS_DIMENSION_TEXTURE2D:
-        {
-            size_t index = 0;
-            for (size_t item = 0; item < metadata.arraySize; ++item)
-            {
-                for (size_t level = 0; level < metadata.mipLevels; ++level)
-                {
-                    if (index >= nimages)
-                    {
-                        blob.Release();
-                        return E_FAIL;
-                    }
+        delete[] m_palette;
+        m_palette = nullptr;
+    }
 
-                    if (fastpath)
-                    {
-                        size_t pixsize = images[index].slicePitch;
-                        memcpy(pDestination, images[index].pixels, pixsize);
+    memset(&m_metadata, 0, sizeof(m_metadata));
+}
 
-                        pDestination += pixsize;
-                        remaining -= pixsize;
-                    }
-                    else
-                    {
-                        size_t ddsRowPitch, ddsSlicePitch;
-                        hr = ComputePitch(metadata.format, images[index].width, images[index].height, ddsRowPitch, ddsSlicePitch, CP_FLAGS_NONE);
-                        if (FAILED(hr))
-                        {
-                            blob.Release();
-                            return hr;
-                        }
+_Use_decl_annotations_
+HRESULT DDSReader::Open(const wchar_t* szFile, DDS_FLAGS flags, DDSMetaData* ddPixelFormat) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
 
-                        const size_t rowPitch = images[index].rowPitch;
+    Close();
 
-                        const uint8_t * __restrict sPtr = images[index].pixels;
-                        uint8_t * __restrict dPtr = pDestination;
+    intptr_t file = INVALID_FILE;
+    uint64_t len = 0;
+    HRESULT hr = OpenFileForRead(szFile, file, len);
+    if (FAILED(hr))
+        return hr;
 
-                        const size_t lines = ComputeScanlines(metadata.format, images[index].height);
-                        const size_t csize = std::min<size_t>(rowPitch, ddsRowPitch);
-                        size_t tremaining = remaining;
-                        for (size_t j = 0; j < lines; ++j)
+    // Need at least enough data to fill the standard header and magic number to be a valid DDS
+    if (len < DDS_MIN_HEADER_SIZE)
+    {
+        CloseFile(file);
+        return E_FAIL;
+    }
+
+    // Read the header in (including extended header if present)
+    uint8_t header[DDS_DX10_HEADER_SIZE] = {};
+    const auto headerLen = static_cast<size_t>(std::min<uint64_t>(len, DDS_DX10_HEADER_SIZE));
+
+    hr = ReadFileAt(file, 0, header, headerLen);
+    if (FAILED(hr))
+    {
+        CloseFile(file);
+        return hr;
+    }
+
+    uint32_t convFlags = 0;
+    TexMetadata mdata;
+    hr = DecodeDDSHeader(header, headerLen, flags, mdata, ddPixelFormat, convFlags);
+    if (FAILED(hr))
+    {
+        CloseFile(file);
+        return hr;
+    }
+
+    uint64_t offset = (convFlags & CONV_FLAGS_DX10) ? DDS_DX10_HEADER_SIZE : DDS_MIN_HEADER_SIZE;
+
+    std::unique_ptr<uint32_t[]> pal8;
+    if (convFlags & CONV_FLAGS_PAL8)
+    {
+        pal8.reset(new (std::nothrow) uint32_t[256]);
+        if (!pal8)
+        {
+            CloseFile(file);
+            return E_OUTOFMEMORY;
+        }
+
+        hr = ReadFileAt(file, offset, pal8.get(), 256 * sizeof(uint32_t));
+        if (FAILED(hr))
+        {
+            CloseFile(file);
+            return hr;
+        }
+
+        offset += (256 * sizeof(uint32_t));
+    }
+
+    if (offset >= len)
+    {
+        CloseFile(file);
+        return E_FAIL;
+    }
+
+    CP_FLAGS cpFlags = GetLegacyPitchFlags(convFlags);
+    if (flags & DDS_FLAGS_LEGACY_DWORD)
+    {
+        cpFlags |= CP_FLAGS_LEGACY_DWORD;
+    }
+    if (flags & DDS_FLAGS_BAD_DXTN_TAILS)
+    {
+        cpFlags |= CP_FLAGS_BAD_DXTN_TAILS;
+    }
+
+    const uint64_t remaining = len - offset;
+
+    size_t nimages = 0;
+    size_t pixelSize = 0;
+    hr = DetermineImageArray(mdata, cpFlags, nimages, pixelSize);
+    if (SUCCEEDED(hr) && (flags & DDS_FLAGS_PERMISSIVE))
+    {
+        // See LoadFromDDSMemoryEx for the 'number of cubes' fix-up
+        if ((mdata.miscFlags & TEX_MISC_TEXTURECUBE)
+            && (convFlags & CONV_FLAGS_DX10)
+            && (pixelSize > remaining)
+            && ((mdata.arraySize % 6) == 0))
+        {
+            mdata.arraySize = mdata.arraySize / 6;
+            hr = DetermineImageArray(mdata, cpFlags, nimages, pixelSize);
+        }
+    }
+
+    if (SUCCEEDED(hr) && (pixelSize > remaining))
+    {
+        hr = HRESULT_E_HANDLE_EOF;
+    }
+
+    std::unique_ptr<uint64_t[]> offsets;
+    if (SUCCEEDED(hr))
+    {
+        offsets.reset(new (std::nothrow) uint64_t[nimages]);
+        if (!offsets)
+            hr = E_OUTOFMEMORY;
+    }
+
+    if (FAILED(hr))
+    {
+        CloseFile(file);
+        return hr;
+    }
+
+    // Subresources are stored in the same order as ScratchImage lays out its images
+    size_t index = 0;
+    switch (mdata.dimension)
+    {
+    case TEX_DIMENSION_TEXTURE1D:
+    case TEX_DIMENSION_TEXTURE2D:
+        for (size_t item = 0; item < mdata.arraySize; ++item)
+        {
+            size_t w = mdata.width;
+            size_t h = mdata.height;
+
+            for (size_t level = 0; level < mdata.mipLevels; ++level, ++index)
+            {
+                size_t rowPitch, slicePitch;
+                hr = ComputePitch(mdata.format, w, h, rowPitch, slicePitch, cpFlags);
+                if (FAILED(hr))
+                    break;
+
+                offsets[index] = offset;
+                offset += slicePitch;
+
+                if (h > 1)
+                    h >>= 1;
+
+                if (w > 1)
+                    w >>= 1;
+            }
+
+            if (FAILED(hr))
+                break;
+        }
+        break;
+
+    case TEX_DIMENSION_TEXTURE3D:
+        {
+            size_t w = mdata.width;
+            size_t h = mdata.height;
+            size_t d = mdata.depth;
+
+            for (size_t level = 0; level < mdata.mipLevels; ++level)
+            {
+                size_t rowPitch, slicePitch;
+                hr = ComputePitch(mdata.format, w, h, rowPitch, slicePitch, cpFlags);
+                if (FAILED(hr))
+                    break;
+
+                for (size_t slice = 0; slice < d; ++slice, ++index)
+                {
+                    offsets[index] = offset;
+                    offset += slicePitch;
+                }
+
+                if (h > 1)
+                    h >>= 1;
+
+                if (w > 1)
+                    w >>= 1;
+
+                if (d > 1)
+                    d >>= 1;
+            }
+        }
+        break;
+
+    default:
+        hr = E_FAIL;
+        break;
+    }
+
+    if (SUCCEEDED(hr) && (index != nimages))
+    {
+        hr = E_UNEXPECTED;
+    }
+
+    if (FAILED(hr))
+    {
+        CloseFile(file);
+        return hr;
+    }
+
+    m_file = file;
+    m_fileSize = len;
+    m_metadata = mdata;
+    m_flags = flags;
+    m_convFlags = convFlags;
+    m_nimages = nimages;
+    m_offsets = offsets.release();
+    m_palette = pal8.release();
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DDSReader::ReadImage(size_t mip, size_t item, size_t slice, const Image& dest) const noexcept
+{
+    if (!m_offsets)
+        return E_FAIL;
+
+    if (!dest.pixels)
+        return E_POINTER;
+
+    if (mip >= m_metadata.mipLevels)
+        return E_INVALIDARG;
+
+    const size_t index = m_metadata.ComputeIndex(mip, item, slice);
+    if (index >= m_nimages)
+        return E_INVALIDARG;
+
+    const DXGI_FORMAT format = m_metadata.format;
+    const size_t width = std::max<size_t>(1, m_metadata.width >> mip);
+    const size_t height = std::max<size_t>(1, m_metadata.height >> mip);
+
+    if (dest.format != format || dest.width != width || dest.height != height)
+        return E_INVALIDARG;
+
+    size_t rowPitch, slicePitch;
+    HRESULT hr = ComputePitch(format, width, height, rowPitch, slicePitch, CP_FLAGS_NONE);
+    if (FAILED(hr))
+        return hr;
+
+    const size_t count = ComputeScanlines(format, height);
+    if (!count)
+        return E_UNEXPECTED;
+
+    if (dest.rowPitch < rowPitch || dest.slicePitch < (dest.rowPitch * count))
+        return E_INVALIDARG;
+
+    CP_FLAGS cpFlags = GetLegacyPitchFlags(m_convFlags);
+    if (m_flags & DDS_FLAGS_LEGACY_DWORD)
+    {
+        cpFlags |= CP_FLAGS_LEGACY_DWORD;
+    }
+    if (m_flags & DDS_FLAGS_BAD_DXTN_TAILS)
+    {
+        cpFlags |= CP_FLAGS_BAD_DXTN_TAILS;
+    }
+
+    const bool compressed = IsCompressed(format);
+    if (compressed && (m_flags & DDS_FLAGS_BAD_DXTN_TAILS) && (width < 4 || height < 4))
+    {
+        // Tail mips are replaced by the leading blocks of the last mip large enough to hold full
+        // blocks, the same way CopyImage does it for LoadFromDDSFile
+        size_t goodMip = mip;
+        while (goodMip > 0)
+        {
+            --goodMip;
+            if ((std::max<size_t>(1, m_metadata.width >> goodMip) >= 4)
+                && (std::max<size_t>(1, m_metadata.height >> goodMip) >= 4))
+                break;
+        }
+
+        size_t goodRowPitch, goodSlicePitch;
+        hr = ComputePitch(format,
+            std::max<size_t>(1, m_metadata.width >> goodMip), std::max<size_t>(1, m_metadata.height >> goodMip),
+            goodRowPitch, goodSlicePitch, cpFlags);
+        if (FAILED(hr))
+            return hr;
+
+        const uint64_t goodOffset = m_offsets[m_metadata.ComputeIndex(goodMip,
+            (m_metadata.dimension == TEX_DIMENSION_TEXTURE3D) ? 0 : item,
+            (m_metadata.dimension == TEX_DIMENSION_TEXTURE3D) ? slice : 0)];
+
+        const size_t csize = std::min<size_t>(dest.slicePitch, goodSlicePitch);
+        if (goodOffset + csize > m_fileSize)
+            return HRESULT_E_HANDLE_EOF;
+
+        return ReadFileAt(m_file, goodOffset, dest.pixels, csize);
+    }
+
+    size_t srcRowPitch, srcSlicePitch;
+    hr = ComputePitch(format, width, height, srcRowPitch, srcSlicePitch, cpFlags);
+    if (FAILED(hr))
+        return hr;
+
+    const uint64_t offset = m_offsets[index];
+
+    if (offset + srcSlicePitch > m_fileSize)
+        return HRESULT_E_HANDLE_EOF;
+
+    if (!(m_convFlags & CONV_FLAGS_EXPAND) && (dest.rowPitch == srcRowPitch))
+    {
+        // Same layout as the file, so read straight into the destination
+        hr = ReadFileAt(m_file, offset, dest.pixels, srcSlicePitch);
+        if (FAILED(hr))
+            return hr;
+
+        if (!compressed && !IsPlanar(format)
+            && (m_convFlags & (CONV_FLAGS_SWIZZLE | CONV_FLAGS_NOALPHA | CONV_FLAGS_L8U8V8 | CONV_FLAGS_WUV10)))
+        {
+            if (!ConvertScanlines(dest.pixels, dest.rowPitch, dest.pixels, dest.rowPitch, height,
+                format, m_convFlags, nullptr))
+                return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[srcSlicePitch]);
+    if (!temp)
+        return E_OUTOFMEMORY;
+
+    hr = ReadFileAt(m_file, offset, temp.get(), srcSlicePitch);
+    if (FAILED(hr))
+        return hr;
+
+    if (compressed || IsPlanar(format))
+    {
+        const uint8_t* pSrc = temp.get();
+        uint8_t* pDest = dest.pixels;
+        const size_t csize = std::min<size_t>(dest.rowPitch, srcRowPitch);
+        for (size_t h = 0; h < count; ++h)
+        {
+            memcpy(pDest, pSrc, csize);
+            pSrc += srcRowPitch;
+            pDest += dest.rowPitch;
+        }
+    }
+    else if (!ConvertScanlines(dest.pixels, dest.rowPitch, temp.get(), srcRowPitch, height,
+        format, m_convFlags, m_palette))
+    {
+        return E_FAIL;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DDSReader::ReadMipLevels(size_t firstMip, size_t mipLevels, ScratchImage& image) const noexcept
+{
+    image.Release();
+
+    if (!m_offsets)
+        return E_FAIL;
+
+    if (firstMip >= m_metadata.mipLevels)
+        return E_INVALIDARG;
+
+    if (!mipLevels)
+    {
+        mipLevels = m_metadata.mipLevels - firstMip;
+    }
+    else if (mipLevels > (m_metadata.mipLevels - firstMip))
+    {
+        return E_INVALIDARG;
+    }
+
+    TexMetadata mdata = m_metadata;
+    mdata.width = std::max<size_t>(1, m_metadata.width >> firstMip);
+    mdata.height = std::max<size_t>(1, m_metadata.height >> firstMip);
+    if (mdata.dimension == TEX_DIMENSION_TEXTURE3D)
+    {
+        mdata.depth = std::max<size_t>(1, m_metadata.depth >> firstMip);
+    }
+    mdata.mipLevels = mipLevels;
+
+    HRESULT hr = image.Initialize(mdata);
+    if (FAILED(hr))
+        return hr;
+
+    for (size_t level = 0; level < mipLevels; ++level)
+    {
+        const size_t depth = (mdata.dimension == TEX_DIMENSION_TEXTURE3D) ? std::max<size_t>(1, mdata.depth >> level) : 1;
+        const size_t items = (mdata.dimension == TEX_DIMENSION_TEXTURE3D) ? 1 : mdata.arraySize;
+
+        for (size_t item = 0; item < items; ++item)
+        {
+            for (size_t slice = 0; slice < depth; ++slice)
+            {
+                const Image* img = image.GetImage(level, item, slice);
+                if (!img)
+                {
+                    image.Release();
+                    return E_UNEXPECTED;
+                }
+
+                hr = ReadImage(firstMip + level, item, slice, *img);
+                if (FAILED(hr))
+                {
+                    image.Release();
+                    return hr;
+                }
+            }
+        }
+    }
+
+    return S_OK;
+}
+
+
+//=====================================================================================
+// DDSWriter - Incremental subresource writer
+//=====================================================================================
+
+DDSWriter& DDSWriter::operator= (DDSWriter&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Close();
+
+        m_file = moveFrom.m_file;
+        m_metadata = moveFrom.m_metadata;
+        m_nimages = moveFrom.m_nimages;
+        m_offsets = moveFrom.m_offsets;
+        m_written = moveFrom.m_written;
+
+        moveFrom.m_file = INVALID_FILE;
+        moveFrom.m_nimages = 0;
+        moveFrom.m_offsets = nullptr;
+        moveFrom.m_written = nullptr;
+    }
+    return *this;
+}
+
+void DDSWriter::Close() noexcept
+{
+#ifdef _WIN32
+    if (m_file != INVALID_FILE)
+    {
+        // Never finalized, so don't leave a partial file behind
+        FILE_DISPOSITION_INFO info = {};
+        info.DeleteFile = TRUE;
+        std::ignore = SetFileInformationByHandle(reinterpret_cast<HANDLE>(m_file), FileDispositionInfo, &info, sizeof(info));
+    }
+#endif
+
+    CloseFile(m_file);
+    m_file = INVALID_FILE;
+
+    m_nimages = 0;
+
+    if (m_offsets)
+    {
+        delete[] m_offsets;
+        m_offsets = nullptr;
+    }
+
+    if (m_written)
+    {
+        delete[] m_written;
+        m_written = nullptr;
+    }
+
+    memset(&m_metadata, 0, sizeof(m_metadata));
+}
+
+_Use_decl_annotations_
+HRESULT DDSWriter::Create(const wchar_t* szFile, const TexMetadata& metadata, DDS_FLAGS flags) noexcept
+{
+    if (!szFile)
+        return E_INVALIDARG;
+
+    Close();
+
+    if ((metadata.dimension == TEX_DIMENSION_TEXTURE3D) && (metadata.arraySize != 1))
+        return E_INVALIDARG;
+
+    // Create DDS Header
+    uint8_t header[DDS_DX10_HEADER_SIZE];
+    size_t required;
+    HRESULT hr = EncodeDDSHeader(metadata, flags, header, DDS_DX10_HEADER_SIZE, required);
+    if (FAILED(hr))
+        return hr;
+
+    size_t nimages = 0;
+    size_t pixelSize = 0;
+    hr = DetermineImageArray(metadata, CP_FLAGS_NONE, nimages, pixelSize);
+    if (FAILED(hr))
+        return hr;
+
+    std::unique_ptr<uint64_t[]> offsets(new (std::nothrow) uint64_t[nimages]);
+    std::unique_ptr<uint8_t[]> written(new (std::nothrow) uint8_t[nimages]);
+    if (!offsets || !written)
+        return E_OUTOFMEMORY;
+
+    memset(written.get(), 0, nimages);
+
+    // Subresources are stored in the same order as ScratchImage lays out its images
+    uint64_t offset = required;
+    size_t index = 0;
+    switch (metadata.dimension)
+    {
+    case TEX_DIMENSION_TEXTURE1D:
+    case TEX_DIMENSION_TEXTURE2D:
+        for (size_t item = 0; item < metadata.arraySize && SUCCEEDED(hr); ++item)
+        {
+            for (size_t level = 0; level < metadata.mipLevels; ++level, ++index)
+            {
+                size_t rowPitch, slicePitch;
+                hr = ComputePitch(metadata.format,
+                    std::max<size_t>(1, metadata.width >> level),
+                    std::max<size_t>(1, metadata.height >> level),
+                    rowPitch, slicePitch, CP_FLAGS_NONE);
+                if (FAILED(hr))
+                    break;
+
+                offsets[index] = offset;
+                offset += slicePitch;
+            }
+        }
+        break;
+
+    case TEX_DIMENSION_TEXTURE3D:
+        {
+            size_t d = metadata.depth;
+            for (size_t level = 0; level < metadata.mipLevels; ++level)
+            {
+                size_t rowPitch, slicePitch;
+                hr = ComputePitch(metadata.format,
+                    std::max<size_t>(1, metadata.width >> level),
+                    std::max<size_t>(1, metadata.height >> level),
+                    rowPitch, slicePitch, CP_FLAGS_NONE);
+                if (FAILED(hr))
+                    break;
+
+                for (size_t slice = 0; slice < d; ++slice, ++index)
+                {
+                    offsets[index] = offset;
+                    offset += slicePitch;
+                }
+
+                if (d > 1)
+                    d >>= 1;
+            }
+        }
+        break;
+
+    default:
+        hr = E_FAIL;
+        break;
+    }
+
+    if (FAILED(hr))
+        return hr;
+
+    if (index != nimages)
+        return E_UNEXPECTED;
+
+    // Size the file up front so subresources can be written in any order
+    intptr_t file = INVALID_FILE;
+    hr = OpenFileForWrite(szFile, offset, file);
+    if (FAILED(hr))
+        return hr;
+
+    m_file = file;
+    m_metadata = metadata;
+    m_nimages = nimages;
+    m_offsets = offsets.release();
+    m_written = written.release();
+
+    hr = WriteFileAt(m_file, 0, header, required);
+    if (FAILED(hr))
+    {
+        Close();
+        return hr;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DDSWriter::WriteImage(size_t mip, size_t item, size_t slice, const Image& image) noexcept
+{
+    if (!m_offsets)
+        return E_FAIL;
+
+    if (!image.pixels)
+        return E_POINTER;
+
+    if (mip >= m_metadata.mipLevels)
+        return E_INVALIDARG;
+
+    const size_t index = m_metadata.ComputeIndex(mip, item, slice);
+    if (index >= m_nimages)
+        return E_INVALIDARG;
+
+    if (image.format != m_metadata.format
+        || image.width != std::max<size_t>(1, m_metadata.width >> mip)
+        || image.height != std::max<size_t>(1, m_metadata.height >> mip))
+        return E_INVALIDARG;
+
+    size_t ddsRowPitch, ddsSlicePitch;
+    HRESULT hr = ComputePitch(m_metadata.format, image.width, image.height, ddsRowPitch, ddsSlicePitch, CP_FLAGS_NONE);
+    if (FAILED(hr))
+        return hr;
+
+    const size_t rowPitch = image.rowPitch;
+    if (rowPitch < ddsRowPitch)
+    {
+        // DDS uses 1-byte alignment, so if this is happening then the input pitch isn't actually a full line of data
+        return E_FAIL;
+    }
+
+    if (rowPitch == ddsRowPitch)
+    {
+        hr = WriteFileAt(m_file, m_offsets[index], image.pixels, ddsSlicePitch);
+    }
+    else
+    {
+        // Pack the rows so the subresource still goes out as a single positional write
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[ddsSlicePitch]);
+        if (!temp)
+            return E_OUTOFMEMORY;
+
+        const uint8_t * __restrict sPtr = image.pixels;
+        uint8_t * __restrict dPtr = temp.get();
+
+        const size_t lines = ComputeScanlines(m_metadata.format, image.height);
+        for (size_t j = 0; j < lines; ++j)
+        {
+            memcpy(dPtr, sPtr, ddsRowPitch);
+            sPtr += rowPitch;
+            dPtr += ddsRowPitch;
+        }
+
+        hr = WriteFileAt(m_file, m_offsets[index], temp.get(), ddsSlicePitch);
+    }
+
+    if (FAILED(hr))
+        return hr;
+
+    // Each subresource owns its own flag, so concurrent writers never touch the same byte
+    m_written[index] = 1;
+
+    return S_OK;
+}
+
+HRESULT DDSWriter::Finalize() noexcept
+{
+    if (!m_offsets)
+        return E_FAIL;
+
+    for (size_t index = 0; index < m_nimages; ++index)
+    {
+        if (!m_written[index])
+            return E_FAIL;
+    }
+
+    CloseFile(m_file);
+    m_file = INVALID_FILE;
+
+    Close();
+
+    return S_OK;
+}
+
+
+//-------------------------------------------------------------------------------------
+// Save a DDS file to memory
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::SaveToDDSMemory(
+    const Image* images,
+    size_t nimages,
+    const TexMetadata& metadata,
+    DDS_FLAGS flags,
+    Blob& blob) noexcept
+{
+    if (!images || (nimages == 0))
+        return E_INVALIDARG;
+
+    // Determine memory required
+    size_t required = 0;
+    HRESULT hr = EncodeDDSHeader(metadata, flags, nullptr, 0, required);
+    if (FAILED(hr))
+        return hr;
+
+    bool fastpath = true;
+
+    for (size_t i = 0; i < nimages; ++i)
+    {
+        if (!images[i].pixels)
+            return E_POINTER;
+
+        if (images[i].format != metadata.format)
+            return E_FAIL;
+
+        size_t ddsRowPitch, ddsSlicePitch;
+        hr = ComputePitch(metadata.format, images[i].width, images[i].height, ddsRowPitch, ddsSlicePitch, CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
+
+        assert(images[i].rowPitch > 0);
+        assert(images[i].slicePitch > 0);
+
+        if ((images[i].rowPitch != ddsRowPitch) || (images[i].slicePitch != ddsSlicePitch))
+        {
+            fastpath = false;
+        }
+
+        required += ddsSlicePitch;
+    }
+
+    assert(required > 0);
+
+    blob.Release();
+
+    hr = blob.Initialize(required);
+    if (FAILED(hr))
+        return hr;
+
+    auto pDestination = blob.GetBufferPointer();
+    assert(pDestination);
+
+    hr = EncodeDDSHeader(metadata, flags, pDestination, blob.GetBufferSize(), required);
+    if (FAILED(hr))
+    {
+        blob.Release();
+        return hr;
+    }
+
+    size_t remaining = blob.GetBufferSize() - required;
+    pDestination += required;
+
+    if (remaining == 0)
+    {
+        blob.Release();
+        return E_FAIL;
+    }
+
+    switch (static_cast<DDS_RESOURCE_DIMENSION>(metadata.dimension))
+    {
+    case DDS_DIMENSION_TEXTURE1D:
+    case DDS_DIMENSION_TEXTURE2D:
+        {
+            size_t index = 0;
+            for (size_t item = 0; item < metadata.arraySize; ++item)
+            {
+                for (size_t level = 0; level < metadata.mipLevels; ++level)
+                {
+                    if (index >= nimages)
+                    {
+                        blob.Release();
+                        return E_FAIL;
+                    }
+
+                    if (fastpath)
+                    {
+                        size_t pixsize = images[index].slicePitch;
+                        memcpy(pDestination, images[index].pixels, pixsize);
+
+                        pDestination += pixsize;
+                        remaining -= pixsize;
+                    }
+                    else
+                    {
+                        size_t ddsRowPitch, ddsSlicePitch;
+                        hr = ComputePitch(metadata.format, images[index].width, images[index].height, ddsRowPitch, ddsSlicePitch, CP_FLAGS_NONE);
+                        if (FAILED(hr))
+                        {
+                            blob.Release();
+                            return hr;
+                        }
+
+                        const size_t rowPitch = images[index].rowPitch;
+
+                        const uint8_t * __restrict sPtr = images[index].pixels;
+                        uint8_t * __restrict dPtr = pDestination;
+
+                        const size_t lines = ComputeScanlines(metadata.format, images[index].height);
+                        const size_t csize = std::min<size_t>(rowPitch, ddsRowPitch);
+                        size_t tremaining = remaining;
+                        for (size_t j = 0; j < lines; ++j)
                         {
                             if (tremaining < csize)
                             {
@@ -2653,23 +3450,15 @@ HRESULT DirectX::SaveToDDSFile(
                     if (FAILED(hr))
                         return hr;
 
-                    if ((images[index].slicePitch == ddsSlicePitch) && (ddsSlicePitch <= UINT32_MAX))
+                    if (images[index].slicePitch == ddsSlicePitch)
                     {
                     #ifdef _WIN32
-                        if (!WriteFile(hFile.get(), images[index].pixels, static_cast<DWORD>(ddsSlicePitch), &bytesWritten, nullptr))
-                        {
-                            return HRESULT_FROM_WIN32(GetLastError());
-                        }
-
-                        if (bytesWritten != ddsSlicePitch)
-                        {
-                            return E_FAIL;
-                        }
+                        hr = WriteFileChunked(hFile.get(), images[index].pixels, ddsSlicePitch);
                     #else
-                        outFile.write(reinterpret_cast<char*>(images[index].pixels), static_cast<std::streamsize>(ddsSlicePitch));
-                        if (!outFile)
-                            return E_FAIL;
+                        hr = WriteFileChunked(outFile, images[index].pixels, ddsSlicePitch);
                     #endif
+                        if (FAILED(hr))
+                            return hr;
                     }
                     else
                     {
@@ -2738,23 +3527,15 @@ HRESULT DirectX::SaveToDDSFile(
                     if (FAILED(hr))
                         return hr;
 
-                    if ((images[index].slicePitch == ddsSlicePitch) && (ddsSlicePitch <= UINT32_MAX))
+                    if (images[index].slicePitch == ddsSlicePitch)
                     {
                     #ifdef _WIN32
-                        if (!WriteFile(hFile.get(), images[index].pixels, static_cast<DWORD>(ddsSlicePitch), &bytesWritten, nullptr))
-                        {
-                            return HRESULT_FROM_WIN32(GetLastError());
-                        }
-
-                        if (bytesWritten != ddsSlicePitch)
-                        {
-                            return E_FAIL;
-                        }
+                        hr = WriteFileChunked(hFile.get(), images[index].pixels, ddsSlicePitch);
                     #else
-                        outFile.write(reinterpret_cast<char*>(images[index].pixels), static_cast<std::streamsize>(ddsSlicePitch));
-                        if (!outFile)
-                            return E_FAIL;
+                        hr = WriteFileChunked(outFile, images[index].pixels, ddsSlicePitch);
                     #endif
+                        if (FAILED(hr))
+                            return hr;
                     }
                     else
                     {
@@ -2854,6 +3635,15 @@ namespace DirectX
         return LoadFromDDSFileEx(reinterpret_cast<const unsigned short*>(szFile), flags, metadata, ddPixelFormat, image);
     }
 
+    HRESULT __cdecl LoadFromDDSFileMapped(
+        _In_z_ const __wchar_t* szFile,
+        _In_ DDS_FLAGS flags,
+        _Out_opt_ TexMetadata* metadata,
+        _Out_ MappedImage& image) noexcept
+    {
+        return LoadFromDDSFileMapped(reinterpret_cast<const unsigned short*>(szFile), flags, metadata, image);
+    }
+
     HRESULT __cdecl SaveToDDSFile(
         _In_ const Image& image,
         _In_ DDS_FLAGS flags,
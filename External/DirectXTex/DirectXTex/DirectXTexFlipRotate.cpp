@@ -172,6 +172,54 @@ namespace
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    // Mirror an image in place by swapping whole rows and/or pixels
+    //-------------------------------------------------------------------------------------
+    HRESULT MirrorInPlace(
+        const Image& image,
+        size_t bytesPerPixel,
+        bool flipH,
+        bool flipV) noexcept
+    {
+        if (!image.pixels)
+            return E_POINTER;
+
+        const size_t rowBytes = image.width * bytesPerPixel;
+        if (rowBytes > image.rowPitch)
+            return E_FAIL;
+
+        if (flipV)
+        {
+            uint8_t* pTop = image.pixels;
+            uint8_t* pBottom = image.pixels + (image.height - 1) * image.rowPitch;
+            for (size_t h = 0; h < image.height / 2; ++h)
+            {
+                std::swap_ranges(pTop, pTop + rowBytes, pBottom);
+                pTop += image.rowPitch;
+                pBottom -= image.rowPitch;
+            }
+        }
+
+        if (flipH)
+        {
+            uint8_t* pRow = image.pixels;
+            for (size_t h = 0; h < image.height; ++h)
+            {
+                uint8_t* pLeft = pRow;
+                uint8_t* pRight = pRow + rowBytes - bytesPerPixel;
+                for (size_t w = 0; w < image.width / 2; ++w)
+                {
+                    std::swap_ranges(pLeft, pLeft + bytesPerPixel, pRight);
+                    pLeft += bytesPerPixel;
+                    pRight -= bytesPerPixel;
+                }
+                pRow += image.rowPitch;
+            }
+        }
+
+        return S_OK;
+    }
 }
 
 
@@ -409,3 +457,67 @@ HRESULT DirectX::FlipRotate(
 
     return S_OK;
 }
+
+
+//-------------------------------------------------------------------------------------
+// Flip/rotate image (in place)
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::FlipRotate(
+    ScratchImage& image,
+    TEX_FR_FLAGS flags) noexcept
+{
+    const Image* images = image.GetImages();
+    const size_t nimages = image.GetImageCount();
+    if (!images || !nimages)
+        return E_INVALIDARG;
+
+    const TexMetadata& metadata = image.GetMetadata();
+
+    const int rotateMode = static_cast<int>(flags & (TEX_FR_ROTATE0 | TEX_FR_ROTATE90 | TEX_FR_ROTATE180 | TEX_FR_ROTATE270));
+
+    switch (rotateMode)
+    {
+    case 0:
+    case TEX_FR_ROTATE180:
+        break;
+
+    case TEX_FR_ROTATE90:
+    case TEX_FR_ROTATE270:
+        // Changes the image dimensions, so needs a new image
+        return HRESULT_E_NOT_SUPPORTED;
+
+    default:
+        return E_INVALIDARG;
+    }
+
+    // Only formats with whole-byte pixels can be mirrored by moving bytes around
+    const size_t bpp = BitsPerPixel(metadata.format);
+    if (IsCompressed(metadata.format)
+        || IsPlanar(metadata.format)
+        || IsPalettized(metadata.format)
+        || IsPacked(metadata.format)
+        || !bpp || (bpp % 8) != 0)
+        return HRESULT_E_NOT_SUPPORTED;
+
+    // A 180 degree rotation is the same as flipping both ways
+    const bool rotate180 = (rotateMode == TEX_FR_ROTATE180);
+    const bool flipH = ((flags & TEX_FR_FLIP_HORIZONTAL) != 0) != rotate180;
+    const bool flipV = ((flags & TEX_FR_FLIP_VERTICAL) != 0) != rotate180;
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const Image& img = images[index];
+        if (img.format != metadata.format)
+            return E_FAIL;
+
+        const HRESULT hr = MirrorInPlace(img, bpp / 8, flipH, flipV);
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+    }
+
+    return S_OK;
+}
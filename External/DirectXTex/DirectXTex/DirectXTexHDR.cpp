@@ -33,6 +33,7 @@
 //#define WRITE_OLD_COLORS
 
 using namespace DirectX;
+using namespace DirectX::Internal;
 
 #ifndef _WIN32
 #include <cstdarg>
@@ -43,6 +44,15 @@ using namespace DirectX;
 
 namespace
 {
+    // Scanlines per work item when decoding or encoding in parallel
+    constexpr size_t c_HDRBandRows = 16;
+
+    // Smaller images are processed on the calling thread
+    constexpr size_t c_HDRParallelMinPixels = 512 * 512;
+
+    // Scanlines encoded per write when saving large images to disk
+    constexpr size_t c_HDRWriteBatchRows = 256;
+
     const char g_Signature[] = "#?RADIANCE";
         // This is the official header signature for the .HDR (RGBE) file format.
 
@@ -300,7 +310,8 @@ namespace
         }
 
         uint64_t sizeBytes = uint64_t(width) * uint64_t(height) * sizeof(float) * 4;
-        if (sizeBytes > UINT32_MAX)
+        // Only the address space limits the payload; file I/O is chunked and 64-bit
+        if (sizeBytes > SIZE_MAX)
         {
             return HRESULT_E_ARITHMETIC_OVERFLOW;
         }
@@ -322,44 +333,54 @@ namespace
         return S_OK;
     }
 
+    //-------------------------------------------------------------------------------------
+    // Packs one linear color into RGBE. The shared exponent is read from the float bits of
+    // the largest channel, so the scale is an exact power of two and the result matches
+    // frexpf(max) * 256 / max.
+    //-------------------------------------------------------------------------------------
+    inline void StoreRGBE(_Out_writes_(4) uint8_t* pDestination, FXMVECTOR color) noexcept
+    {
+        // Negative and NaN channels become zero
+        const XMVECTOR v = XMVectorMax(color, XMVectorZero());
+
+        const XMVECTOR vmax = XMVectorMax(XMVectorMax(XMVectorSplatX(v), XMVectorSplatY(v)), XMVectorSplatZ(v));
+        const float maxc = XMVectorGetX(vmax);
+
+        if (maxc > 1e-32f)
+        {
+            uint32_t bits;
+            memcpy(&bits, &maxc, sizeof(bits));
+            const uint32_t e = (bits >> 23) & 0xff; // frexpf exponent + 126
+
+            // 2^(8 - frexpf exponent) maps the largest channel into [128, 256)
+            const uint32_t scaleBits = (261u - e) << 23;
+            float scale;
+            memcpy(&scale, &scaleBits, sizeof(scale));
+
+            XMVECTOR rgb = XMVectorTruncate(XMVectorMultiply(v, XMVectorReplicate(scale)));
+            rgb = XMVectorSelect(XMVectorReplicate(float((e + 2) & 0xff)), rgb, g_XMSelect1110);
+
+            PackedVector::XMStoreUByte4(reinterpret_cast<PackedVector::XMUBYTE4*>(pDestination), rgb);
+        }
+        else
+        {
+            pDestination[0] = pDestination[1] = pDestination[2] = pDestination[3] = 0;
+        }
+    }
+
     //-------------------------------------------------------------------------------------
     // FloatToRGBE
     //-------------------------------------------------------------------------------------
     inline void FloatToRGBE(_Out_writes_(width*4) uint8_t* pDestination, _In_reads_(width*fpp) const float* pSource, size_t width, _In_range_(3, 4) int fpp) noexcept
     {
-        auto ePtr = pSource + width * size_t(fpp);
-
         for (size_t j = 0; j < width; ++j)
         {
-            if (pSource + 2 >= ePtr) break;
-            const float r = pSource[0] >= 0.f ? pSource[0] : 0.f;
-            const float g = pSource[1] >= 0.f ? pSource[1] : 0.f;
-            const float b = pSource[2] >= 0.f ? pSource[2] : 0.f;
+            const XMVECTOR v = (fpp == 4)
+                ? XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pSource))
+                : XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(pSource));
             pSource += fpp;
 
-            const float max_xy = (r > g) ? r : g;
-            float max_xyz = (max_xy > b) ? max_xy : b;
-
-            if (max_xyz > 1e-32f)
-            {
-                int e;
-                max_xyz = frexpf(max_xyz, &e) * 256.f / max_xyz;
-                e += 128;
-
-                const uint8_t red = uint8_t(r * max_xyz);
-                const uint8_t green = uint8_t(g * max_xyz);
-                const uint8_t blue = uint8_t(b * max_xyz);
-
-                pDestination[0] = red;
-                pDestination[1] = green;
-                pDestination[2] = blue;
-                pDestination[3] = (red || green || blue) ? uint8_t(e & 0xff) : 0u;
-            }
-            else
-            {
-                pDestination[0] = pDestination[1] = pDestination[2] = pDestination[3] = 0;
-            }
-
+            StoreRGBE(pDestination, v);
             pDestination += 4;
         }
     }
@@ -369,41 +390,177 @@ namespace
     //-------------------------------------------------------------------------------------
     inline void HalfToRGBE(_Out_writes_(width * 4) uint8_t* pDestination, _In_reads_(width* fpp) const uint16_t* pSource, size_t width, _In_range_(3, 4) int fpp) noexcept
     {
-        auto ePtr = pSource + width * size_t(fpp);
-
         for (size_t j = 0; j < width; ++j)
         {
-            if (pSource + 2 >= ePtr) break;
-            float r = PackedVector::XMConvertHalfToFloat(pSource[0]); r = (r >= 0.f) ? r : 0.f;
-            float g = PackedVector::XMConvertHalfToFloat(pSource[1]); g = (g >= 0.f) ? g : 0.f;
-            float b = PackedVector::XMConvertHalfToFloat(pSource[2]); b = (b >= 0.f) ? b : 0.f;
+            const XMVECTOR v = (fpp == 4)
+                ? PackedVector::XMLoadHalf4(reinterpret_cast<const PackedVector::XMHALF4*>(pSource))
+                : XMVectorSet(PackedVector::XMConvertHalfToFloat(pSource[0]),
+                    PackedVector::XMConvertHalfToFloat(pSource[1]),
+                    PackedVector::XMConvertHalfToFloat(pSource[2]), 0.f);
             pSource += fpp;
 
-            const float max_xy = (r > g) ? r : g;
-            float max_xyz = (max_xy > b) ? max_xy : b;
+            StoreRGBE(pDestination, v);
+            pDestination += 4;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Expands planar RGBE bytes (see DecodeScanline) into linear RGBA floats
+    //-------------------------------------------------------------------------------------
+    inline void RGBEToFloat(
+        _Out_writes_(width * 4) float* pDestination,
+        _In_reads_(width * 4) const uint8_t* pSource,
+        size_t width,
+        float invExposure,
+        _In_reads_(256) const float* scales) noexcept
+    {
+        const uint8_t* red = pSource;
+        const uint8_t* green = pSource + width;
+        const uint8_t* blue = pSource + width * 2;
+        const uint8_t* exponent = pSource + width * 3;
+
+        const XMVECTOR vexposure = XMVectorReplicate(invExposure);
+
+        for (size_t j = 0; j < width; ++j)
+        {
+            XMVECTOR v = XMVectorSet(float(red[j]), float(green[j]), float(blue[j]), 0.f);
+            v = XMVectorMultiply(XMVectorAdd(v, g_XMOneHalf), XMVectorReplicate(scales[exponent[j]]));
+            v = XMVectorMultiply(vexposure, v);
+            v = XMVectorSelect(g_XMOne, v, g_XMSelect1110);
+
+            XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pDestination), v);
+            pDestination += 4;
+        }
+    }
+
+    //-------------------------------------------------------------------------------------
+    // Decodes one scanline (adaptive RLE, standard RLE, or flat) into four byte planes
+    // R, G, B, E of 'width' each. Without a destination it only validates the scanline,
+    // which is how the loader finds where each scanline starts.
+    //-------------------------------------------------------------------------------------
+    HRESULT DecodeScanline(
+        _In_reads_bytes_(size) const uint8_t* pSource,
+        size_t size,
+        size_t width,
+        _Out_writes_opt_(width * 4) uint8_t* pDestination,
+        _Out_ size_t& consumed) noexcept
+    {
+        consumed = 0;
+
+        const uint8_t* sourcePtr = pSource;
+        size_t pixelLen = size;
+
+        if (pixelLen < 4)
+            return E_FAIL;
+
+        uint8_t inColor[4];
+        memcpy(inColor, sourcePtr, 4);
+        sourcePtr += 4;
+        pixelLen -= 4;
+
+        if (inColor[0] == 2 && inColor[1] == 2 && inColor[2] < 128)
+        {
+            // Adaptive Run Length Encoding (RLE)
+            if (size_t((size_t(inColor[2]) << 8) + inColor[3]) != width)
+                return E_FAIL;
 
-            if (max_xyz > 1e-32f)
+            for (size_t channel = 0; channel < 4; ++channel)
             {
-                int e;
-                max_xyz = frexpf(max_xyz, &e) * 256.f / max_xyz;
-                e += 128;
-
-                const uint8_t red = uint8_t(r * max_xyz);
-                const uint8_t green = uint8_t(g * max_xyz);
-                const uint8_t blue = uint8_t(b * max_xyz);
-
-                pDestination[0] = red;
-                pDestination[1] = green;
-                pDestination[2] = blue;
-                pDestination[3] = (red || green || blue) ? uint8_t(e & 0xff) : 0u;
+                uint8_t* plane = (pDestination) ? (pDestination + channel * width) : nullptr;
+                for (size_t pixelCount = 0; pixelCount < width;)
+                {
+                    if (pixelLen < 2)
+                        return E_FAIL;
+
+                    size_t runLen = *sourcePtr;
+                    if (runLen > 128)
+                    {
+                        runLen &= 127;
+                        if (pixelCount + runLen > width)
+                            return E_FAIL;
+
+                        if (plane)
+                            memset(plane + pixelCount, sourcePtr[1], runLen);
+
+                        sourcePtr += 2;
+                        pixelLen -= 2;
+                    }
+                    else
+                    {
+                        if ((pixelLen < runLen + 1) || ((pixelCount + runLen) > width))
+                            return E_FAIL;
+
+                        if (plane)
+                            memcpy(plane + pixelCount, sourcePtr + 1, runLen);
+
+                        sourcePtr += runLen + 1;
+                        pixelLen -= runLen + 1;
+                    }
+
+                    pixelCount += runLen;
+                }
             }
-            else
+        }
+        else
+        {
+            uint8_t prevColor[4];
+            memcpy(prevColor, inColor, 4);
+
+            int bitShift = 0;
+            for (size_t pixelCount = 0; pixelCount < width;)
             {
-                pDestination[0] = pDestination[1] = pDestination[2] = pDestination[3] = 0;
-            }
+                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
+                {
+                    if (bitShift > 24)
+                        return E_FAIL;
 
-            pDestination += 4;
+                    // "Standard" Run Length Encoding
+                    const size_t spanLen = size_t(inColor[3]) << bitShift;
+                    if (spanLen + pixelCount > width)
+                        return E_FAIL;
+
+                    if (pDestination)
+                    {
+                        for (size_t channel = 0; channel < 4; ++channel)
+                        {
+                            memset(pDestination + channel * width + pixelCount, prevColor[channel], spanLen);
+                        }
+                    }
+
+                    pixelCount += spanLen;
+                    bitShift += 8;
+                }
+                else
+                {
+                    // Uncompressed
+                    memcpy(prevColor, inColor, 4);
+
+                    if (pDestination)
+                    {
+                        for (size_t channel = 0; channel < 4; ++channel)
+                        {
+                            pDestination[channel * width + pixelCount] = inColor[channel];
+                        }
+                    }
+
+                    bitShift = 0;
+                    ++pixelCount;
+                }
+
+                if (pixelCount >= width)
+                    break;
+
+                if (pixelLen < 4)
+                    return E_FAIL;
+
+                memcpy(inColor, sourcePtr, 4);
+                sourcePtr += 4;
+                pixelLen -= 4;
+            }
         }
+
+        consumed = size - pixelLen;
+        return S_OK;
     }
 
     //-------------------------------------------------------------------------------------
@@ -589,6 +746,78 @@ namespace
         return encSize;
     #endif
     }
+
+    //-------------------------------------------------------------------------------------
+    // Encodes scanlines [y0, y1) back to back into pDestination, which must hold
+    // (y1 - y0) * width * 4 bytes. Rows are encoded in parallel into fixed slots and then
+    // packed in order; a row never encodes larger than its slot, so packing is a forward move.
+    //-------------------------------------------------------------------------------------
+    HRESULT EncodeScanlines(
+        const Image& image,
+        _In_range_(3, 4) int fpp,
+        size_t y0,
+        size_t y1,
+        _Out_writes_bytes_((y1 - y0) * image.width * 4) uint8_t* pDestination,
+        _Out_ size_t& encoded) noexcept
+    {
+        encoded = 0;
+
+        const size_t rowPitch = image.width * 4;
+        const size_t rows = y1 - y0;
+
+        const size_t nBands = (rows + c_HDRBandRows - 1) / c_HDRBandRows;
+        const size_t workers = (uint64_t(image.width) * rows >= c_HDRParallelMinPixels) ? GetWorkerCount(nBands) : 1;
+
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * workers]);
+        std::unique_ptr<size_t[]> encSizes(new (std::nothrow) size_t[rows]);
+        if (!temp || !encSizes)
+            return E_OUTOFMEMORY;
+
+        ParallelFor(nBands, workers, [&](size_t band, size_t worker) noexcept -> bool
+            {
+                auto rgbe = temp.get() + rowPitch * worker;
+
+                const size_t end = std::min(rows, (band + 1) * c_HDRBandRows);
+                for (size_t row = band * c_HDRBandRows; row < end; ++row)
+                {
+                    const uint8_t* sPtr = image.pixels + image.rowPitch * (y0 + row);
+                    if (image.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
+                    {
+                        HalfToRGBE(rgbe, reinterpret_cast<const uint16_t*>(sPtr), image.width, fpp);
+                    }
+                    else
+                    {
+                        FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
+                    }
+
+                    auto enc = pDestination + rowPitch * row;
+                    size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
+                    if (!encSize)
+                    {
+                        memcpy(enc, rgbe, rowPitch);
+                        encSize = rowPitch;
+                    }
+
+                    encSizes[row] = encSize;
+                }
+
+                return true;
+            });
+
+        auto dPtr = pDestination;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            const uint8_t* enc = pDestination + rowPitch * row;
+            if (dPtr != enc)
+            {
+                memmove(dPtr, enc, encSizes[row]);
+            }
+            dPtr += encSizes[row];
+        }
+
+        encoded = size_t(dPtr - pDestination);
+        return S_OK;
+    }
 }
 
 
@@ -633,13 +862,13 @@ HRESULT DirectX::GetMetadataFromHDRFile(const wchar_t* szFile, TexMetadata& meta
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid HDR file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
     {
         return HRESULT_E_FILE_TOO_LARGE;
     }
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -649,14 +878,14 @@ HRESULT DirectX::GetMetadataFromHDRFile(const wchar_t* szFile, TexMetadata& meta
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    const size_t len = fileLen;
+    const auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the standard header to be a valid HDR
@@ -670,7 +899,7 @@ HRESULT DirectX::GetMetadataFromHDRFile(const wchar_t* szFile, TexMetadata& meta
 
 #ifdef _WIN32
     DWORD bytesRead = 0;
-    if (!ReadFile(hFile.get(), header, std::min<DWORD>(sizeof(header), fileInfo.EndOfFile.LowPart), &bytesRead, nullptr))
+    if (!ReadFile(hFile.get(), header, static_cast<DWORD>(std::min<size_t>(sizeof(header), len)), &bytesRead, nullptr))
     {
         return HRESULT_FROM_WIN32(GetLastError());
     }
@@ -715,15 +944,13 @@ HRESULT DirectX::LoadFromHDRMemory(const uint8_t* pSource, size_t size, TexMetad
     if (remaining == 0)
         return E_FAIL;
 
-    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1, CP_FLAGS_LIMIT_4GB);
+    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1);
     if (FAILED(hr))
         return hr;
 
     // Copy pixels
     auto sourcePtr = static_cast<const uint8_t*>(pSource) + offset;
 
-    size_t pixelLen = remaining;
-
     const Image* img = image.GetImage(0, 0, 0);
     if (!img)
     {
@@ -731,173 +958,74 @@ HRESULT DirectX::LoadFromHDRMemory(const uint8_t* pSource, size_t size, TexMetad
         return E_POINTER;
     }
 
-    auto destPtr = img->pixels;
-
 #ifdef _DEBUG
     memset(img->pixels, 0xFF, img->rowPitch * img->height);
 #endif
 
+    // Scanlines are variable-length, so a serial prepass finds where each one starts
+    std::unique_ptr<size_t[]> scanOffsets(new (std::nothrow) size_t[mdata.height]);
+    if (!scanOffsets)
+    {
+        image.Release();
+        return E_OUTOFMEMORY;
+    }
+
+    size_t pixelOffset = 0;
     for (size_t scan = 0; scan < mdata.height; ++scan)
     {
-        if (pixelLen < 4)
+        scanOffsets[scan] = pixelOffset;
+
+        size_t consumed;
+        hr = DecodeScanline(sourcePtr + pixelOffset, remaining - pixelOffset, mdata.width, nullptr, consumed);
+        if (FAILED(hr))
         {
             image.Release();
-            return E_FAIL;
+            return hr;
         }
 
-        uint8_t inColor[4];
-        memcpy(inColor, sourcePtr, 4);
-        sourcePtr += 4;
-        pixelLen -= 4;
-
-        auto scanLine = reinterpret_cast<float*>(destPtr);
+        pixelOffset += consumed;
+    }
 
-        if (inColor[0] == 2 && inColor[1] == 2 && inColor[2] < 128)
-        {
-            // Adaptive Run Length Encoding (RLE)
-            if (size_t((size_t(inColor[2]) << 8) + inColor[3]) != mdata.width)
-            {
-                image.Release();
-                return E_FAIL;
-            }
+    // Transform values
+    float scales[256];
+    for (int exponent = 0; exponent < 256; ++exponent)
+    {
+        scales[exponent] = ldexpf(1.f, exponent - (128 + 8));
+    }
 
-            for (int channel = 0; channel < 4; ++channel)
-            {
-                auto pixelLoc = scanLine + channel;
-                for (size_t pixelCount = 0; pixelCount < mdata.width;)
-                {
-                    if (pixelLen < 2)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
+    const float invExposure = 1.0f / exposure;
 
-                    assert(sourcePtr < (reinterpret_cast<const uint8_t*>(pSource) + size));
+    const size_t nBands = (mdata.height + c_HDRBandRows - 1) / c_HDRBandRows;
+    const size_t workers = (uint64_t(mdata.width) * mdata.height >= c_HDRParallelMinPixels) ? GetWorkerCount(nBands) : 1;
 
-                    uint8_t runLen = *sourcePtr;
-                    if (runLen > 128)
-                    {
-                        runLen &= 127;
-                        if (pixelCount + runLen > mdata.width)
-                        {
-                            image.Release();
-                            return E_FAIL;
-                        }
+    std::unique_ptr<uint8_t[]> planes(new (std::nothrow) uint8_t[mdata.width * 4 * workers]);
+    if (!planes)
+    {
+        image.Release();
+        return E_OUTOFMEMORY;
+    }
 
-                        auto val = static_cast<float>(sourcePtr[1]);
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        sourcePtr += 2;
-                        pixelLen -= 2;
-                    }
-                    else if ((size < size_t(runLen) + 1) || ((pixelCount + size_t(runLen)) > mdata.width))
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-                    else
-                    {
-                        ++sourcePtr;
-                        for (uint8_t j = 0; j < runLen; ++j)
-                        {
-                            auto val = static_cast<float>(*sourcePtr++);
-                            *pixelLoc = val;
-                            pixelLoc += 4;
-                        }
-                        pixelCount += runLen;
-                        pixelLen -= size_t(runLen) + 1;
-                    }
-                }
-            }
-        }
-        else
+    const bool ok = ParallelFor(nBands, workers, [&](size_t band, size_t worker) noexcept -> bool
         {
-            auto pixelLoc = scanLine;
+            auto rgbe = planes.get() + mdata.width * 4 * worker;
 
-            float prevColor[4];
-            prevColor[0] = inColor[0];
-            prevColor[1] = inColor[1];
-            prevColor[2] = inColor[2];
-            prevColor[3] = inColor[3];
-
-            int bitShift = 0;
-            for (size_t pixelCount = 0; pixelCount < mdata.width;)
+            const size_t end = std::min(mdata.height, (band + 1) * c_HDRBandRows);
+            for (size_t scan = band * c_HDRBandRows; scan < end; ++scan)
             {
-                if (inColor[0] == 1 && inColor[1] == 1 && inColor[2] == 1)
-                {
-                    if (bitShift > 24)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    // "Standard" Run Length Encoding
-                    const size_t spanLen = size_t(inColor[3]) << bitShift;
-                    if (spanLen + pixelCount > mdata.width)
-                    {
-                        image.Release();
-                        return E_FAIL;
-                    }
-
-                    for (size_t j = 0; j < spanLen; ++j)
-                    {
-                        pixelLoc[0] = prevColor[0];
-                        pixelLoc[1] = prevColor[1];
-                        pixelLoc[2] = prevColor[2];
-                        pixelLoc[3] = prevColor[3];
-                        pixelLoc += 4;
-                    }
-                    pixelCount += spanLen;
-                    bitShift += 8;
-                }
-                else
-                {
-                    // Uncompressed
-                    pixelLoc[0] = prevColor[0] = inColor[0];
-                    pixelLoc[1] = prevColor[1] = inColor[1];
-                    pixelLoc[2] = prevColor[2] = inColor[2];
-                    pixelLoc[3] = prevColor[3] = inColor[3];
-                    bitShift = 0;
-                    ++pixelCount;
-                    pixelLoc += 4;
-                }
-
-                if (pixelCount >= mdata.width)
-                    break;
-
-                if (pixelLen < 4)
-                {
-                    image.Release();
-                    return E_FAIL;
-                }
+                size_t consumed;
+                if (FAILED(DecodeScanline(sourcePtr + scanOffsets[scan], remaining - scanOffsets[scan], mdata.width, rgbe, consumed)))
+                    return false;
 
-                memcpy(inColor, sourcePtr, 4);
-                sourcePtr += 4;
-                pixelLen -= 4;
+                RGBEToFloat(reinterpret_cast<float*>(img->pixels + img->rowPitch * scan), rgbe, mdata.width, invExposure, scales);
             }
-        }
 
-        destPtr += img->rowPitch;
-    }
+            return true;
+        });
 
-    // Transform values
+    if (!ok)
     {
-        auto fdata = reinterpret_cast<float*>(image.GetPixels());
-
-        for (size_t j = 0; j < image.GetPixelsSize(); j += 16)
-        {
-            const auto exponent = static_cast<int>(fdata[3]);
-            fdata[0] = 1.0f / exposure*ldexpf((fdata[0] + 0.5f), exponent - (128 + 8));
-            fdata[1] = 1.0f / exposure*ldexpf((fdata[1] + 0.5f), exponent - (128 + 8));
-            fdata[2] = 1.0f / exposure*ldexpf((fdata[2] + 0.5f), exponent - (128 + 8));
-            fdata[3] = 1.f;
-
-            fdata += 4;
-        }
+        image.Release();
+        return E_FAIL;
     }
 
     if (metadata)
@@ -935,13 +1063,13 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid HDR file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
     {
         return HRESULT_E_FILE_TOO_LARGE;
     }
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -951,14 +1079,14 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    const size_t len = fileLen;
+    const auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the header to be a valid HDR
@@ -975,21 +1103,12 @@ HRESULT DirectX::LoadFromHDRFile(const wchar_t* szFile, TexMetadata* metadata, S
     }
 
 #ifdef _WIN32
-    DWORD bytesRead = 0;
-    if (!ReadFile(hFile.get(), temp.get(), fileInfo.EndOfFile.LowPart, &bytesRead, nullptr))
-    {
-        return HRESULT_FROM_WIN32(GetLastError());
-    }
-
-    if (bytesRead != fileInfo.EndOfFile.LowPart)
-    {
-        return E_FAIL;
-    }
+    HRESULT hr = ReadFileChunked(hFile.get(), temp.get(), len);
 #else
-    inFile.read(reinterpret_cast<char*>(temp.get()), len);
-    if (!inFile)
-        return E_FAIL;
+    HRESULT hr = ReadFileChunked(inFile, temp.get(), len);
 #endif
+    if (FAILED(hr))
+        return hr;
 
     return LoadFromHDRMemory(temp.get(), len, metadata, image);
 }
@@ -1056,41 +1175,15 @@ HRESULT DirectX::SaveToHDRMemory(const Image& image, Blob& blob) noexcept
         sPtr += image.rowPitch;
     }
 #else
-    std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * 2]);
-    if (!temp)
+    size_t encoded;
+    hr = EncodeScanlines(image, fpp, 0, image.height, dPtr, encoded);
+    if (FAILED(hr))
     {
         blob.Release();
-        return E_OUTOFMEMORY;
+        return hr;
     }
 
-    auto rgbe = temp.get();
-    auto enc = temp.get() + rowPitch;
-
-    const uint8_t* sPtr = image.pixels;
-    for (size_t scan = 0; scan < image.height; ++scan)
-    {
-        if (image.format == DXGI_FORMAT_R32G32B32A32_FLOAT || image.format == DXGI_FORMAT_R32G32B32_FLOAT)
-        {
-            FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-        }
-        else if (image.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
-        {
-            HalfToRGBE(rgbe, reinterpret_cast<const uint16_t*>(sPtr), image.width, fpp);
-        }
-        sPtr += image.rowPitch;
-
-        size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
-        if (encSize > 0)
-        {
-            memcpy(dPtr, enc, encSize);
-            dPtr += encSize;
-        }
-        else
-        {
-            memcpy(dPtr, rgbe, rowPitch);
-            dPtr += rowPitch;
-        }
-    }
+    dPtr += encoded;
 #endif
 
     hr = blob.Trim(size_t(dPtr - blob.GetConstBufferPointer()));
@@ -1195,8 +1288,10 @@ HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexce
     }
     else
     {
-        // Otherwise, write the image one scanline at a time...
-        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * 2]);
+        // Otherwise, write the image a batch of scanlines at a time...
+        const size_t batchRows = std::min(image.height, c_HDRWriteBatchRows);
+
+        std::unique_ptr<uint8_t[]> temp(new (std::nothrow) uint8_t[rowPitch * batchRows]);
         if (!temp)
             return E_OUTOFMEMORY;
 
@@ -1247,57 +1342,20 @@ HRESULT DirectX::SaveToHDRFile(const Image& image, const wchar_t* szFile) noexce
 
         }
     #else
-        auto enc = temp.get() + rowPitch;
-
-        const uint8_t* sPtr = image.pixels;
-        for (size_t scan = 0; scan < image.height; ++scan)
+        for (size_t scan = 0; scan < image.height; scan += batchRows)
         {
-            if (image.format == DXGI_FORMAT_R32G32B32A32_FLOAT || image.format == DXGI_FORMAT_R32G32B32_FLOAT)
-            {
-                FloatToRGBE(rgbe, reinterpret_cast<const float*>(sPtr), image.width, fpp);
-            }
-            else if (image.format == DXGI_FORMAT_R16G16B16A16_FLOAT)
-            {
-                HalfToRGBE(rgbe, reinterpret_cast<const uint16_t*>(sPtr), image.width, fpp);
-            }
-            sPtr += image.rowPitch;
-
-            const size_t encSize = EncodeRLE(enc, rgbe, rowPitch, image.width);
-            if (encSize > 0)
-            {
-                if (encSize > UINT32_MAX)
-                    return HRESULT_E_ARITHMETIC_OVERFLOW;
-
-            #ifdef _WIN32
-                if (!WriteFile(hFile.get(), enc, static_cast<DWORD>(encSize), &bytesWritten, nullptr))
-                {
-                    return HRESULT_FROM_WIN32(GetLastError());
-                }
-
-                if (bytesWritten != encSize)
-                    return E_FAIL;
-            #else
-                outFile.write(reinterpret_cast<char*>(enc), static_cast<std::streamsize>(encSize));
-                if (!outFile)
-                    return E_FAIL;
-            #endif
-            }
-            else
-            {
-            #ifdef _WIN32
-                if (!WriteFile(hFile.get(), rgbe, static_cast<DWORD>(rowPitch), &bytesWritten, nullptr))
-                {
-                    return HRESULT_FROM_WIN32(GetLastError());
-                }
+            size_t encSize;
+            HRESULT hr = EncodeScanlines(image, fpp, scan, std::min(image.height, scan + batchRows), rgbe, encSize);
+            if (FAILED(hr))
+                return hr;
 
-                if (bytesWritten != rowPitch)
-                    return E_FAIL;
-            #else
-                outFile.write(reinterpret_cast<char*>(rgbe), static_cast<std::streamsize>(rowPitch));
-                if (!outFile)
-                    return E_FAIL;
-            #endif
-            }
+        #ifdef _WIN32
+            hr = WriteFileChunked(hFile.get(), rgbe, encSize);
+        #else
+            hr = WriteFileChunked(outFile, rgbe, encSize);
+        #endif
+            if (FAILED(hr))
+                return hr;
         }
     #endif
     }
@@ -14,19 +14,6 @@
 using namespace DirectX;
 using namespace DirectX::Internal;
 
-#ifndef _WIN32
-namespace
-{
-    inline void * _aligned_malloc(size_t size, size_t alignment)
-    {
-        size = (size + alignment - 1) & ~(alignment - 1);
-        return std::aligned_alloc(alignment, size);
-    }
-
-#define _aligned_free free
-}
-#endif
-
 //-------------------------------------------------------------------------------------
 // Determines number of image array entries and pixel size
 //-------------------------------------------------------------------------------------
@@ -283,11 +270,13 @@ ScratchImage& ScratchImage::operator= (ScratchImage&& moveFrom) noexcept
         m_metadata = moveFrom.m_metadata;
         m_image = moveFrom.m_image;
         m_memory = moveFrom.m_memory;
+        m_allocator = moveFrom.m_allocator;
 
         moveFrom.m_nimages = 0;
         moveFrom.m_size = 0;
         moveFrom.m_image = nullptr;
         moveFrom.m_memory = nullptr;
+        moveFrom.m_allocator = nullptr;
     }
     return *this;
 }
@@ -367,7 +356,8 @@ HRESULT ScratchImage::Initialize(const TexMetadata& mdata, CP_FLAGS flags) noexc
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_allocator = GetMemoryAllocator();
+    m_memory = static_cast<uint8_t*>(AllocatePixelMemory(m_allocator, pixelSize));
     if (!m_memory)
     {
         Release();
@@ -437,7 +427,8 @@ HRESULT ScratchImage::Initialize2D(DXGI_FORMAT fmt, size_t width, size_t height,
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_allocator = GetMemoryAllocator();
+    m_memory = static_cast<uint8_t*>(AllocatePixelMemory(m_allocator, pixelSize));
     if (!m_memory)
     {
         Release();
@@ -496,7 +487,8 @@ HRESULT ScratchImage::Initialize3D(DXGI_FORMAT fmt, size_t width, size_t height,
     m_nimages = nimages;
     memset(m_image, 0, sizeof(Image) * nimages);
 
-    m_memory = static_cast<uint8_t*>(_aligned_malloc(pixelSize, 16));
+    m_allocator = GetMemoryAllocator();
+    m_memory = static_cast<uint8_t*>(AllocatePixelMemory(m_allocator, pixelSize));
     if (!m_memory)
     {
         Release();
@@ -719,10 +711,12 @@ void ScratchImage::Release() noexcept
 
     if (m_memory)
     {
-        _aligned_free(m_memory);
+        FreePixelMemory(m_allocator, m_memory);
         m_memory = nullptr;
     }
 
+    m_allocator = nullptr;
+
     memset(&m_metadata, 0, sizeof(m_metadata));
 }
 
@@ -850,3 +844,494 @@ bool ScratchImage::IsAlphaAllOpaque() const noexcept
 
     return true;
 }
+
+
+//=====================================================================================
+// MappedImage - Image container over a copy-on-write file mapping
+//=====================================================================================
+
+MappedImage& MappedImage::operator= (MappedImage&& moveFrom) noexcept
+{
+    if (this != &moveFrom)
+    {
+        Release();
+
+        m_nimages = moveFrom.m_nimages;
+        m_size = moveFrom.m_size;
+        m_metadata = moveFrom.m_metadata;
+        m_image = moveFrom.m_image;
+        m_pixels = moveFrom.m_pixels;
+        m_view = moveFrom.m_view;
+        m_viewSize = moveFrom.m_viewSize;
+        m_converted = std::move(moveFrom.m_converted);
+
+        moveFrom.m_nimages = 0;
+        moveFrom.m_size = 0;
+        moveFrom.m_image = nullptr;
+        moveFrom.m_pixels = nullptr;
+        moveFrom.m_view = nullptr;
+        moveFrom.m_viewSize = 0;
+    }
+    return *this;
+}
+
+void MappedImage::Release() noexcept
+{
+    m_nimages = 0;
+    m_size = 0;
+    m_pixels = nullptr;
+
+    if (m_image)
+    {
+        delete[] m_image;
+        m_image = nullptr;
+    }
+
+    if (m_view)
+    {
+        UnmapFile(m_view, m_viewSize);
+        m_view = nullptr;
+        m_viewSize = 0;
+    }
+
+    m_converted.Release();
+
+    memset(&m_metadata, 0, sizeof(m_metadata));
+}
+
+_Use_decl_annotations_
+const Image* MappedImage::GetImage(size_t mip, size_t item, size_t slice) const noexcept
+{
+    if (!m_view)
+        return m_converted.GetImage(mip, item, slice);
+
+    const size_t index = m_metadata.ComputeIndex(mip, item, slice);
+    if (index >= m_nimages)
+        return nullptr;
+
+    return &m_image[index];
+}
+
+const Image* MappedImage::GetImages() const noexcept
+{
+    return (m_view) ? m_image : m_converted.GetImages();
+}
+
+size_t MappedImage::GetImageCount() const noexcept
+{
+    return (m_view) ? m_nimages : m_converted.GetImageCount();
+}
+
+const uint8_t* MappedImage::GetPixels() const noexcept
+{
+    return (m_view) ? m_pixels : m_converted.GetPixels();
+}
+
+size_t MappedImage::GetPixelsSize() const noexcept
+{
+    return (m_view) ? m_size : m_converted.GetPixelsSize();
+}
+
+
+//-------------------------------------------------------------------------------------
+// File mapping helpers
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::Internal::MapFileCopyOnWrite(const wchar_t* szFile, void** ppView, size_t& size) noexcept
+{
+    if (!szFile || !ppView)
+        return E_INVALIDARG;
+
+    *ppView = nullptr;
+    size = 0;
+
+#ifdef _WIN32
+    ScopedHandle hFile(safe_handle(CreateFile2(
+        szFile,
+        GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING,
+        nullptr)));
+    if (!hFile)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    FILE_STANDARD_INFO fileInfo;
+    if (!GetFileInformationByHandleEx(hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo)))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
+        return HRESULT_E_FILE_TOO_LARGE;
+
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
+    if (!len)
+        return E_FAIL;
+
+    // The view keeps the mapping object alive, so both handles can be closed once it exists
+    ScopedHandle hMapping(CreateFileMappingW(hFile.get(), nullptr, PAGE_WRITECOPY, 0, 0, nullptr));
+    if (!hMapping)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    // Pages written through the images become private copies, so in-place processing works
+    void* pView = MapViewOfFile(hMapping.get(), FILE_MAP_COPY, 0, 0, 0);
+    if (!pView)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+#else // !WIN32
+    const int fd = open(std::filesystem::path(szFile).c_str(), O_RDONLY);
+    if (fd < 0)
+        return E_FAIL;
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return E_FAIL;
+    }
+
+    if (st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > SIZE_MAX)
+    {
+        close(fd);
+        return (st.st_size <= 0) ? E_FAIL : HRESULT_E_FILE_TOO_LARGE;
+    }
+
+    const auto len = static_cast<size_t>(st.st_size);
+
+    // The mapping stays valid after the descriptor is closed. MAP_PRIVATE with write access
+    // is copy-on-write: pages written through the images never reach the file
+    void* pView = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (pView == MAP_FAILED)
+        return E_FAIL;
+#endif
+
+    *ppView = pView;
+    size = len;
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::UnmapFile(void* pView, size_t size) noexcept
+{
+    if (!pView)
+        return;
+
+#ifdef _WIN32
+    std::ignore = size;
+    std::ignore = UnmapViewOfFile(pView);
+#else
+    std::ignore = munmap(pView, size);
+#endif
+}
+
+
+//-------------------------------------------------------------------------------------
+// File I/O helpers
+//-------------------------------------------------------------------------------------
+#ifdef _WIN32
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ReadFileChunked(HANDLE hFile, void* pBuffer, size_t size) noexcept
+{
+    auto ptr = static_cast<uint8_t*>(pBuffer);
+    while (size > 0)
+    {
+        const auto chunk = static_cast<DWORD>(std::min(size, FILE_IO_CHUNK_SIZE));
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(hFile, ptr, chunk, &bytesRead, nullptr))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (bytesRead != chunk)
+        {
+            return E_FAIL;
+        }
+
+        ptr += chunk;
+        size -= chunk;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::WriteFileChunked(HANDLE hFile, const void* pBuffer, size_t size) noexcept
+{
+    auto ptr = static_cast<const uint8_t*>(pBuffer);
+    while (size > 0)
+    {
+        const auto chunk = static_cast<DWORD>(std::min(size, FILE_IO_CHUNK_SIZE));
+
+        DWORD bytesWritten = 0;
+        if (!WriteFile(hFile, ptr, chunk, &bytesWritten, nullptr))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (bytesWritten != chunk)
+        {
+            return E_FAIL;
+        }
+
+        ptr += chunk;
+        size -= chunk;
+    }
+
+    return S_OK;
+}
+#else // !WIN32
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ReadFileChunked(std::ifstream& inFile, void* pBuffer, size_t size) noexcept
+{
+    auto ptr = static_cast<char*>(pBuffer);
+    while (size > 0)
+    {
+        const size_t chunk = std::min(size, FILE_IO_CHUNK_SIZE);
+
+        inFile.read(ptr, static_cast<std::streamsize>(chunk));
+        if (!inFile)
+            return E_FAIL;
+
+        ptr += chunk;
+        size -= chunk;
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::WriteFileChunked(std::ofstream& outFile, const void* pBuffer, size_t size) noexcept
+{
+    auto ptr = static_cast<const char*>(pBuffer);
+    while (size > 0)
+    {
+        const size_t chunk = std::min(size, FILE_IO_CHUNK_SIZE);
+
+        outFile.write(ptr, static_cast<std::streamsize>(chunk));
+        if (!outFile)
+            return E_FAIL;
+
+        ptr += chunk;
+        size -= chunk;
+    }
+
+    return S_OK;
+}
+#endif
+
+
+//-------------------------------------------------------------------------------------
+// Positional file I/O helpers
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::Internal::OpenFileForRead(const wchar_t* szFile, intptr_t& file, uint64_t& size) noexcept
+{
+    file = INVALID_FILE;
+    size = 0;
+
+    if (!szFile)
+        return E_INVALIDARG;
+
+#ifdef _WIN32
+    ScopedHandle hFile(safe_handle(CreateFile2(
+        szFile,
+        GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING,
+        nullptr)));
+    if (!hFile)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    FILE_STANDARD_INFO fileInfo;
+    if (!GetFileInformationByHandleEx(hFile.get(), FileStandardInfo, &fileInfo, sizeof(fileInfo)))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    size = static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart);
+    file = reinterpret_cast<intptr_t>(hFile.release());
+#else // !WIN32
+    const int fd = open(std::filesystem::path(szFile).c_str(), O_RDONLY);
+    if (fd < 0)
+        return E_FAIL;
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size < 0)
+    {
+        close(fd);
+        return E_FAIL;
+    }
+
+    size = static_cast<uint64_t>(st.st_size);
+    file = fd;
+#endif
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ReadFileAt(intptr_t file, uint64_t offset, void* pBuffer, size_t size) noexcept
+{
+    if (file == INVALID_FILE || !pBuffer)
+        return E_INVALIDARG;
+
+    auto ptr = static_cast<uint8_t*>(pBuffer);
+    while (size > 0)
+    {
+        const size_t chunk = std::min(size, FILE_IO_CHUNK_SIZE);
+
+    #ifdef _WIN32
+        OVERLAPPED ovl = {};
+        ovl.Offset = static_cast<DWORD>(offset);
+        ovl.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD bytesRead = 0;
+        if (!ReadFile(reinterpret_cast<HANDLE>(file), ptr, static_cast<DWORD>(chunk), &bytesRead, &ovl))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (bytesRead != chunk)
+        {
+            return HRESULT_E_HANDLE_EOF;
+        }
+    #else
+        const ssize_t bytesRead = pread(static_cast<int>(file), ptr, chunk, static_cast<off_t>(offset));
+        if (bytesRead < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return E_FAIL;
+        }
+
+        if (bytesRead == 0)
+        {
+            return HRESULT_E_HANDLE_EOF;
+        }
+    #endif
+
+        ptr += bytesRead;
+        offset += static_cast<uint64_t>(bytesRead);
+        size -= static_cast<size_t>(bytesRead);
+    }
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::OpenFileForWrite(const wchar_t* szFile, uint64_t size, intptr_t& file) noexcept
+{
+    file = INVALID_FILE;
+
+    if (!szFile)
+        return E_INVALIDARG;
+
+#ifdef _WIN32
+    ScopedHandle hFile(safe_handle(CreateFile2(
+        szFile,
+        GENERIC_WRITE | DELETE, 0, CREATE_ALWAYS, nullptr)));
+    if (!hFile)
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    FILE_END_OF_FILE_INFO eofInfo = {};
+    eofInfo.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFileInformationByHandle(hFile.get(), FileEndOfFileInfo, &eofInfo, sizeof(eofInfo)))
+    {
+        const DWORD err = GetLastError();
+
+        FILE_DISPOSITION_INFO info = {};
+        info.DeleteFile = TRUE;
+        std::ignore = SetFileInformationByHandle(hFile.get(), FileDispositionInfo, &info, sizeof(info));
+
+        return HRESULT_FROM_WIN32(err);
+    }
+
+    file = reinterpret_cast<intptr_t>(hFile.release());
+#else // !WIN32
+    const int fd = open(std::filesystem::path(szFile).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return E_FAIL;
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        return E_FAIL;
+    }
+
+    file = fd;
+#endif
+
+    return S_OK;
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::Internal::WriteFileAt(intptr_t file, uint64_t offset, const void* pBuffer, size_t size) noexcept
+{
+    if (file == INVALID_FILE || !pBuffer)
+        return E_INVALIDARG;
+
+    auto ptr = static_cast<const uint8_t*>(pBuffer);
+    while (size > 0)
+    {
+        const size_t chunk = std::min(size, FILE_IO_CHUNK_SIZE);
+
+    #ifdef _WIN32
+        OVERLAPPED ovl = {};
+        ovl.Offset = static_cast<DWORD>(offset);
+        ovl.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD bytesWritten = 0;
+        if (!WriteFile(reinterpret_cast<HANDLE>(file), ptr, static_cast<DWORD>(chunk), &bytesWritten, &ovl))
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        if (bytesWritten != chunk)
+        {
+            return E_FAIL;
+        }
+    #else
+        const ssize_t bytesWritten = pwrite(static_cast<int>(file), ptr, chunk, static_cast<off_t>(offset));
+        if (bytesWritten < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return E_FAIL;
+        }
+
+        if (bytesWritten == 0)
+        {
+            return E_FAIL;
+        }
+    #endif
+
+        ptr += bytesWritten;
+        offset += static_cast<uint64_t>(bytesWritten);
+        size -= static_cast<size_t>(bytesWritten);
+    }
+
+    return S_OK;
+}
+
+void DirectX::Internal::CloseFile(intptr_t file) noexcept
+{
+    if (file == INVALID_FILE)
+        return;
+
+#ifdef _WIN32
+    std::ignore = CloseHandle(reinterpret_cast<HANDLE>(file));
+#else
+    std::ignore = close(static_cast<int>(file));
+#endif
+}
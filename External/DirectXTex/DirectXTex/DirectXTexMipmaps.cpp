@@ -1083,6 +1083,172 @@ namespace
     }
 
 
+    //--- 2D Box Filter (fused) ---
+    constexpr size_t c_MipTileSize = 64;
+
+    bool CanFuseMips(_In_ DXGI_FORMAT format) noexcept
+    {
+        // Tiles address pixels by byte offset within a row
+        const size_t bpp = BitsPerPixel(format);
+        return (bpp > 0) && !(bpp & 7) && !IsPacked(format) && !IsPlanar(format) && !IsCompressed(format);
+    }
+
+    // Produces the same result as Generate2DMipsBoxFilter for every item, but works on tiles of the
+    // base level and emits as many levels per tile as the tile allows before moving on. Each level is
+    // still stored in the destination format and read back for the next level, which keeps the
+    // output identical, but that read hits the cache instead of a full image in memory. Tiles and
+    // array items are independent and run on all workers with TEX_FILTER_PARALLEL.
+    HRESULT Generate2DMipsBoxFilterFused(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
+
+        const TexMetadata& metadata = mipChain.GetMetadata();
+
+        if (!ispow2(metadata.width) || !ispow2(metadata.height))
+            return E_FAIL;
+
+        if (!CanFuseMips(metadata.format))
+            return E_UNEXPECTED;
+
+        const size_t bytesPerPixel = BitsPerPixel(metadata.format) / 8;
+        const size_t nitems = metadata.arraySize;
+
+        const size_t maxWorkers = (filter & TEX_FILTER_PARALLEL) ? GetWorkerCount(SIZE_MAX) : 1;
+
+        // Per worker: a tile of the level being read and a tile of the level being written
+        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(c_MipTileSize * c_MipTileSize) * 2 * maxWorkers);
+        if (!scanline)
+            return E_OUTOFMEMORY;
+
+        size_t width = metadata.width;
+        size_t height = metadata.height;
+
+        for (size_t base = 0; base + 1 < levels; )
+        {
+            const size_t tileWidth = std::min(width, c_MipTileSize);
+            const size_t tileHeight = std::min(height, c_MipTileSize);
+
+            // A tile can produce levels until it runs out of pixels in a dimension that the image still has
+            size_t fused = 0;
+            {
+                size_t w = width, h = height, tw = tileWidth, th = tileHeight;
+                while ((base + fused + 1) < levels
+                    && (tw > 1 || w == 1) && (th > 1 || h == 1))
+                {
+                    w = std::max<size_t>(w >> 1, 1);
+                    h = std::max<size_t>(h >> 1, 1);
+                    tw = std::max<size_t>(tw >> 1, 1);
+                    th = std::max<size_t>(th >> 1, 1);
+                    ++fused;
+                }
+            }
+            assert(fused > 0);
+
+            const size_t tilesX = width / tileWidth;
+            const size_t tilesY = height / tileHeight;
+            const size_t tilesPerItem = tilesX * tilesY;
+            const size_t count = tilesPerItem * nitems;
+
+            const bool ok = ParallelFor(count, std::min(maxWorkers, count), [&](size_t job, size_t worker) noexcept -> bool
+                {
+                    const size_t item = job / tilesPerItem;
+                    const size_t tile = job % tilesPerItem;
+
+                    XMVECTOR* current = scanline.get() + c_MipTileSize * c_MipTileSize * 2 * worker;
+                    XMVECTOR* target = current + c_MipTileSize * c_MipTileSize;
+
+                    size_t x0 = (tile % tilesX) * tileWidth;
+                    size_t y0 = (tile / tilesX) * tileHeight;
+                    size_t cw = tileWidth;
+                    size_t ch = tileHeight;
+                    size_t w = width;
+                    size_t h = height;
+
+                    // Load the tile of the first level
+                    const Image* src = mipChain.GetImage(base, item, 0);
+                    if (!src || !src->pixels)
+                        return false;
+
+                    for (size_t y = 0; y < ch; ++y)
+                    {
+                        const uint8_t* pSrc = src->pixels + src->rowPitch * (y0 + y) + bytesPerPixel * x0;
+                        if (!LoadScanlineLinear(current + y * cw, cw, pSrc, bytesPerPixel * cw, src->format, filter))
+                            return false;
+                    }
+
+                    for (size_t level = base + 1; level <= base + fused; ++level)
+                    {
+                        const Image* dest = mipChain.GetImage(level, item, 0);
+                        if (!dest || !dest->pixels)
+                            return false;
+
+                        const size_t nw = (cw > 1) ? (cw >> 1) : 1;
+                        const size_t nh = (ch > 1) ? (ch >> 1) : 1;
+
+                        // Same sample pattern and arithmetic as Generate2DMipsBoxFilter
+                        for (size_t y = 0; y < nh; ++y)
+                        {
+                            const XMVECTOR* urow0 = current + ((ch > 1) ? (y << 1) : 0) * cw;
+                            const XMVECTOR* urow1 = (ch > 1) ? (urow0 + cw) : urow0;
+                            const XMVECTOR* urow2 = (cw > 1) ? (urow0 + 1) : urow0;
+                            const XMVECTOR* urow3 = (cw > 1) ? (urow1 + 1) : urow1;
+
+                            XMVECTOR* row = target + y * nw;
+                            for (size_t x = 0; x < nw; ++x)
+                            {
+                                const size_t x2 = x << 1;
+
+                                AVERAGE4(row[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                            }
+                        }
+
+                        x0 = (w > 1) ? (x0 >> 1) : 0;
+                        y0 = (h > 1) ? (y0 >> 1) : 0;
+                        w = (w > 1) ? (w >> 1) : 1;
+                        h = (h > 1) ? (h >> 1) : 1;
+                        cw = nw;
+                        ch = nh;
+
+                        for (size_t y = 0; y < ch; ++y)
+                        {
+                            uint8_t* pDest = dest->pixels + dest->rowPitch * (y0 + y) + bytesPerPixel * x0;
+                            if (!StoreScanlineLinear(pDest, bytesPerPixel * cw, dest->format, target + y * cw, cw, filter))
+                                return false;
+
+                            if (level < base + fused)
+                            {
+                                // Read back the stored row so the next level sees the same quantized values
+                                if (!LoadScanlineLinear(current + y * cw, cw, pDest, bytesPerPixel * cw, dest->format, filter))
+                                    return false;
+                            }
+                        }
+                    }
+
+                    return true;
+                });
+
+            if (!ok)
+                return E_FAIL;
+
+            for (size_t j = 0; j < fused; ++j)
+            {
+                width = std::max<size_t>(width >> 1, 1);
+                height = std::max<size_t>(height >> 1, 1);
+            }
+            base += fused;
+        }
+
+        return S_OK;
+    }
+
+
     //--- 2D Linear Filter ---
     HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
     {
@@ -1391,8 +1557,6 @@ namespace
     //--- 2D Triangle Filter ---
     HRESULT Generate2DMipsTriangleFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
     {
-        using namespace DirectX::Filters;
-
         if (!mipChain.GetImages())
             return E_INVALIDARG;
 
@@ -1400,202 +1564,18 @@ namespace
 
         assert(levels > 1);
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
-
-        // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<TriangleRow[]> rowActive(new (std::nothrow) TriangleRow[height]);
-        if (!rowActive)
-            return E_OUTOFMEMORY;
-
-        TriangleRow * rowFree = nullptr;
-
-        std::unique_ptr<Filter> tfX, tfY;
-
-        XMVECTOR* row = scanline.get();
-
-        // Resize base image to each target mip level
+        // Resize each level from the previous one using the separable (CSR) form of the triangle filter
         for (size_t level = 1; level < levels; ++level)
         {
-            // 2D triangle filter
             const Image* src = mipChain.GetImage(level - 1, item, 0);
             const Image* dest = mipChain.GetImage(level, item, 0);
 
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            const size_t rowPitch = src->rowPitch;
-            const uint8_t* pEndSrc = pSrc + rowPitch * height;
-
-            uint8_t* pDest = dest->pixels;
-
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            HRESULT hr = CreateTriangleFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
+            const HRESULT hr = ResizeSeparableFilter(*src, filter, Filters::SK_TRIANGLE, *dest);
             if (FAILED(hr))
                 return hr;
-
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            hr = CreateTriangleFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-            if (FAILED(hr))
-                return hr;
-
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
-
-            auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-            auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
-
-            // Count times rows get written (and clear out any leftover accumulation rows from last miplevel)
-            for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-            {
-                for (size_t j = 0; j < yFrom->count; ++j)
-                {
-                    const size_t v = yFrom->to[j].u;
-                    assert(v < nheight);
-                    TriangleRow* rowAcc = &rowActive[v];
-
-                    ++rowAcc->remaining;
-
-                    if (rowAcc->scanline)
-                    {
-                        memset(rowAcc->scanline.get(), 0, sizeof(XMVECTOR) * nwidth);
-                    }
-                }
-
-                yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
-            }
-
-            // Filter image
-            for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-            {
-                // Create accumulation rows as needed
-                for (size_t j = 0; j < yFrom->count; ++j)
-                {
-                    const size_t v = yFrom->to[j].u;
-                    assert(v < nheight);
-                    TriangleRow* rowAcc = &rowActive[v];
-
-                    if (!rowAcc->scanline)
-                    {
-                        if (rowFree)
-                        {
-                            // Steal and reuse scanline from 'free row' list
-                            // (it will always be at least as wide as nwidth due to loop decending order)
-                            assert(rowFree->scanline != nullptr);
-                            rowAcc->scanline.reset(rowFree->scanline.release());
-                            rowFree = rowFree->next;
-                        }
-                        else
-                        {
-                            auto nscanline = make_AlignedArrayXMVECTOR(nwidth);
-                            if (!nscanline)
-                                return E_OUTOFMEMORY;
-                            rowAcc->scanline.swap(nscanline);
-                        }
-
-                        memset(rowAcc->scanline.get(), 0, sizeof(XMVECTOR) * nwidth);
-                    }
-                }
-
-                // Load source scanline
-                if ((pSrc + rowPitch) > pEndSrc)
-                    return E_FAIL;
-
-                if (!LoadScanlineLinear(row, width, pSrc, rowPitch, src->format, filter))
-                    return E_FAIL;
-
-                pSrc += rowPitch;
-
-                // Process row
-                size_t x = 0;
-                for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
-                {
-                    for (size_t j = 0; j < yFrom->count; ++j)
-                    {
-                        const size_t v = yFrom->to[j].u;
-                        assert(v < nheight);
-                        const float yweight = yFrom->to[j].weight;
-
-                        XMVECTOR* accPtr = rowActive[v].scanline.get();
-                        if (!accPtr)
-                            return E_POINTER;
-
-                        for (size_t k = 0; k < xFrom->count; ++k)
-                        {
-                            size_t u = xFrom->to[k].u;
-                            assert(u < nwidth);
-
-                            const XMVECTOR weight = XMVectorReplicate(yweight * xFrom->to[k].weight);
-
-                            assert(x < width);
-                            accPtr[u] = XMVectorMultiplyAdd(row[x], weight, accPtr[u]);
-                        }
-                    }
-
-                    xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
-                }
-
-                // Write completed accumulation rows
-                for (size_t j = 0; j < yFrom->count; ++j)
-                {
-                    size_t v = yFrom->to[j].u;
-                    assert(v < nheight);
-                    TriangleRow* rowAcc = &rowActive[v];
-
-                    assert(rowAcc->remaining > 0);
-                    --rowAcc->remaining;
-
-                    if (!rowAcc->remaining)
-                    {
-                        XMVECTOR* pAccSrc = rowAcc->scanline.get();
-                        if (!pAccSrc)
-                            return E_POINTER;
-
-                        switch (dest->format)
-                        {
-                        case DXGI_FORMAT_R10G10B10A2_UNORM:
-                        case DXGI_FORMAT_R10G10B10A2_UINT:
-                            {
-                                // Need to slightly bias results for floating-point error accumulation which can
-                                // be visible with harshly quantized values
-                                static const XMVECTORF32 Bias = { { { 0.f, 0.f, 0.f, 0.1f } } };
-
-                                XMVECTOR* ptr = pAccSrc;
-                                for (size_t i = 0; i < dest->width; ++i, ++ptr)
-                                {
-                                    *ptr = XMVectorAdd(*ptr, Bias);
-                                }
-                            }
-                            break;
-
-                        default:
-                            break;
-                        }
-
-                        // This performs any required clamping
-                        if (!StoreScanlineLinear(pDest + (dest->rowPitch * v), dest->rowPitch, dest->format, pAccSrc, dest->width, filter))
-                            return E_FAIL;
-
-                        // Put row on freelist to reuse it's allocated scanline
-                        rowAcc->next = rowFree;
-                        rowFree = rowAcc;
-                    }
-                }
-
-                yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
-            }
-
-            if (height > 1)
-                height >>= 1;
-
-            if (width > 1)
-                width >>= 1;
         }
 
         return S_OK;
@@ -2965,7 +2945,9 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
+            hr = CanFuseMips(mdata.format)
+                ? Generate2DMipsBoxFilterFused(levels, filter, mipChain)
+                : Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -3180,6 +3162,14 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
+            if (CanFuseMips(metadata.format))
+            {
+                hr = Generate2DMipsBoxFilterFused(levels, filter, mipChain);
+                if (FAILED(hr))
+                    mipChain.Release();
+                return hr;
+            }
+
             for (size_t item = 0; item < metadata.arraySize; ++item)
             {
                 hr = Generate2DMipsBoxFilter(levels, filter, mipChain, item);
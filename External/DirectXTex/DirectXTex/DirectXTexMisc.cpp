@@ -261,6 +261,78 @@ namespace
 
         return S_OK;
     }
+
+    //-------------------------------------------------------------------------------------
+    constexpr size_t c_TransformBandRows = 16;
+
+    // Applies pixelFunc in place to bands of rows from every image at once (TEX_FILTER_PARALLEL)
+    HRESULT TransformImages_Parallel(
+        _In_reads_(nimages) const Image* images,
+        size_t nimages,
+        const std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)>& pixelFunc)
+    {
+        if (!pixelFunc)
+            return E_INVALIDARG;
+
+        std::unique_ptr<size_t[]> firstBand(new (std::nothrow) size_t[nimages + 1]);
+        if (!firstBand)
+            return E_OUTOFMEMORY;
+
+        size_t maxWidth = 1;
+        firstBand[0] = 0;
+        for (size_t index = 0; index < nimages; ++index)
+        {
+            if (!images[index].pixels)
+                return E_POINTER;
+
+            firstBand[index + 1] = firstBand[index] + (images[index].height + c_TransformBandRows - 1) / c_TransformBandRows;
+            maxWidth = std::max(maxWidth, images[index].width);
+        }
+
+        const size_t totalBands = firstBand[nimages];
+        const size_t workers = GetWorkerCount(totalBands);
+
+        auto scanlines = make_AlignedArrayXMVECTOR(uint64_t(maxWidth) * 2 * workers);
+        if (!scanlines)
+            return E_OUTOFMEMORY;
+
+        const bool ok = ParallelFor(totalBands, workers, [&](size_t item, size_t worker) noexcept -> bool
+            {
+                const size_t index = static_cast<size_t>(std::upper_bound(firstBand.get(), firstBand.get() + nimages + 1, item) - firstBand.get()) - 1;
+                assert(index < nimages);
+
+                const Image& img = images[index];
+                const size_t y0 = (item - firstBand[index]) * c_TransformBandRows;
+                const size_t y1 = std::min(y0 + c_TransformBandRows, img.height);
+
+                XMVECTOR* sScanline = scanlines.get() + worker * maxWidth * 2;
+                XMVECTOR* dScanline = sScanline + maxWidth;
+
+                uint8_t* pRow = img.pixels + y0 * img.rowPitch;
+                for (size_t h = y0; h < y1; ++h, pRow += img.rowPitch)
+                {
+                    if (!LoadScanline(sScanline, img.width, pRow, img.rowPitch, img.format))
+                        return false;
+
+                    try
+                    {
+                        pixelFunc(dScanline, sScanline, img.width, h);
+                    }
+                    catch (...)
+                    {
+                        // Exceptions must not escape the worker thread
+                        return false;
+                    }
+
+                    if (!StoreScanline(pRow, img.rowPitch, img.format, dScanline, img.width))
+                        return false;
+                }
+
+                return true;
+            });
+
+        return (ok) ? S_OK : E_FAIL;
+    }
 };
 
 
@@ -765,3 +837,55 @@ HRESULT DirectX::TransformImage(
 
     return S_OK;
 }
+
+_Use_decl_annotations_
+HRESULT DirectX::TransformImage(
+    ScratchImage& image,
+    std::function<void __cdecl(_Out_writes_(width) XMVECTOR* outPixels, _In_reads_(width) const XMVECTOR* inPixels, size_t width, size_t y)> pixelFunc,
+    TEX_FILTER_FLAGS flags)
+{
+    const Image* images = image.GetImages();
+    const size_t nimages = image.GetImageCount();
+    if (!images || !nimages)
+        return E_INVALIDARG;
+
+    const TexMetadata& metadata = image.GetMetadata();
+
+    if (IsPlanar(metadata.format) || IsPalettized(metadata.format) || IsCompressed(metadata.format) || IsTypeless(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if (metadata.width > UINT32_MAX
+        || metadata.height > UINT32_MAX)
+        return E_INVALIDARG;
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        if (images[index].format != metadata.format)
+            return E_FAIL;
+    }
+
+    // Each scanline is loaded into its own buffer before the result is stored back over it
+    if (flags & TEX_FILTER_PARALLEL)
+    {
+        const HRESULT hr = TransformImages_Parallel(images, nimages, pixelFunc);
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+
+        return S_OK;
+    }
+
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const HRESULT hr = TransformImage_(images[index], pixelFunc, images[index]);
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+    }
+
+    return S_OK;
+}
@@ -141,6 +141,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
 #include <cstdlib>
@@ -148,13 +149,24 @@
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <thread>
 #include <tuple>
 
 #ifndef _WIN32
+#include <cerrno>
 #include <fstream>
 #include <filesystem>
-#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
 #endif
 
 #define _XM_NO_XMVECTOR_OVERLOADS_
@@ -336,6 +348,68 @@ namespace DirectX
             _In_ const TexMetadata& metadata, _In_ CP_FLAGS cpFlags,
             _Out_writes_(nImages) Image* images, _In_ size_t nImages) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Pixel memory helpers (see SetMemoryAllocator); always 16-byte aligned
+        _Ret_maybenull_ MemoryAllocator* __cdecl GetMemoryAllocator() noexcept;
+
+        _Ret_maybenull_ void* __cdecl AllocatePixelMemory(_In_opt_ MemoryAllocator* allocator, _In_ size_t size) noexcept;
+
+        void __cdecl FreePixelMemory(_In_opt_ MemoryAllocator* allocator, _In_opt_ void* ptr) noexcept;
+
+        //---------------------------------------------------------------------------------
+        // File mapping helpers (copy-on-write view of an entire file; writes never reach the file)
+        HRESULT __cdecl MapFileCopyOnWrite(
+            _In_z_ const wchar_t* szFile,
+            _Outptr_result_bytebuffer_(size) void** ppView, _Out_ size_t& size) noexcept;
+
+        void __cdecl UnmapFile(_In_opt_ void* pView, _In_ size_t size) noexcept;
+
+        //---------------------------------------------------------------------------------
+        // File I/O helpers (64-bit sizes, transferred in bounded chunks)
+        constexpr size_t FILE_IO_CHUNK_SIZE = 64 * 1024 * 1024;
+
+    #ifdef _WIN32
+        HRESULT __cdecl ReadFileChunked(
+            _In_ HANDLE hFile,
+            _Out_writes_bytes_(size) void* pBuffer, _In_ size_t size) noexcept;
+
+        HRESULT __cdecl WriteFileChunked(
+            _In_ HANDLE hFile,
+            _In_reads_bytes_(size) const void* pBuffer, _In_ size_t size) noexcept;
+    #else
+        HRESULT __cdecl ReadFileChunked(
+            std::ifstream& inFile,
+            _Out_writes_bytes_(size) void* pBuffer, _In_ size_t size) noexcept;
+
+        HRESULT __cdecl WriteFileChunked(
+            std::ofstream& outFile,
+            _In_reads_bytes_(size) const void* pBuffer, _In_ size_t size) noexcept;
+    #endif
+
+        //---------------------------------------------------------------------------------
+        // Positional file I/O helpers (file is a HANDLE on Windows, a descriptor otherwise)
+        //   Transfers never move a shared file position, so they are safe from multiple threads
+        constexpr intptr_t INVALID_FILE = -1;
+
+        HRESULT __cdecl OpenFileForRead(
+            _In_z_ const wchar_t* szFile,
+            _Out_ intptr_t& file, _Out_ uint64_t& size) noexcept;
+
+        HRESULT __cdecl ReadFileAt(
+            _In_ intptr_t file, _In_ uint64_t offset,
+            _Out_writes_bytes_(size) void* pBuffer, _In_ size_t size) noexcept;
+
+        HRESULT __cdecl OpenFileForWrite(
+            _In_z_ const wchar_t* szFile, _In_ uint64_t size,
+            _Out_ intptr_t& file) noexcept;
+            // Creates or truncates the file, then extends it to size bytes
+
+        HRESULT __cdecl WriteFileAt(
+            _In_ intptr_t file, _In_ uint64_t offset,
+            _In_reads_bytes_(size) const void* pBuffer, _In_ size_t size) noexcept;
+
+        void __cdecl CloseFile(_In_ intptr_t file) noexcept;
+
         //---------------------------------------------------------------------------------
         // Conversion helper functions
 
@@ -445,6 +519,84 @@ namespace DirectX
         bool __cdecl CalculateMipLevels3D(_In_ size_t width, _In_ size_t height, _In_ size_t depth,
             _Inout_ size_t& mipLevels) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // Work scheduling
+        inline size_t GetWorkerCount(_In_ size_t items) noexcept
+        {
+        #ifdef _OPENMP
+            const auto threads = static_cast<size_t>(std::max(1, omp_get_max_threads()));
+        #else
+            const auto threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        #endif
+            return std::max<size_t>(1, std::min(threads, items));
+        }
+
+        // Calls fn(item, worker) for every item in [0, count) from up to 'workers' threads.
+        // Items are handed out one at a time from a shared counter so uneven work balances out,
+        // and 'worker' is a stable index in [0, workers) for per-thread scratch memory.
+        // Returns false if any call returned false; no further items are started after that.
+        template<typename Fn>
+        bool ParallelFor(_In_ size_t count, _In_ size_t workers, Fn&& fn) noexcept
+        {
+            std::atomic<size_t> next(0);
+            std::atomic<bool> ok(true);
+
+            auto run = [&](size_t worker) noexcept
+                {
+                    while (ok.load(std::memory_order_relaxed))
+                    {
+                        const size_t item = next.fetch_add(1, std::memory_order_relaxed);
+                        if (item >= count)
+                            break;
+
+                        if (!fn(item, worker))
+                            ok = false;
+                    }
+                };
+
+            if (workers <= 1 || count <= 1)
+            {
+                run(0);
+                return ok;
+            }
+
+        #ifdef _OPENMP
+        #pragma omp parallel for num_threads(static_cast<int>(workers))
+            for (int w = 0; w < static_cast<int>(workers); ++w)
+            {
+                run(static_cast<size_t>(w));
+            }
+        #else
+            std::vector<std::thread> threads;
+            try
+            {
+                threads.reserve(workers - 1);
+                for (size_t w = 1; w < workers; ++w)
+                {
+                    threads.emplace_back(run, w);
+                }
+            }
+            catch (...)
+            {
+                // Continue with however many threads were started
+            }
+
+            run(0);
+
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+        #endif
+
+            return ok;
+        }
+
+        // Two-pass separable resize used by Resize and mipmap generation (kernel is a Filters::SEPARABLE_KERNEL)
+        HRESULT __cdecl ResizeSeparableFilter(
+            _In_ const Image& srcImage, _In_ TEX_FILTER_FLAGS filter, _In_ uint32_t kernel,
+            _In_ const Image& destImage) noexcept;
+
     #ifdef _WIN32
         HRESULT __cdecl ResizeSeparateColorAndAlpha(_In_ IWICImagingFactory* pWIC,
             _In_ bool iswic2,
@@ -342,3 +342,63 @@ HRESULT DirectX::PremultiplyAlpha(
 
     return S_OK;
 }
+
+
+//-------------------------------------------------------------------------------------
+// Converts to/from a premultiplied alpha version of the texture (in place)
+//-------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::PremultiplyAlpha(
+    ScratchImage& image,
+    TEX_PMALPHA_FLAGS flags) noexcept
+{
+    const Image* images = image.GetImages();
+    const size_t nimages = image.GetImageCount();
+    if (!images || !nimages)
+        return E_INVALIDARG;
+
+    const TexMetadata& metadata = image.GetMetadata();
+
+    if (IsCompressed(metadata.format)
+        || IsPlanar(metadata.format)
+        || IsPalettized(metadata.format)
+        || IsTypeless(metadata.format)
+        || !HasAlpha(metadata.format))
+        return HRESULT_E_NOT_SUPPORTED;
+
+    if ((metadata.width > UINT32_MAX) || (metadata.height > UINT32_MAX))
+        return E_INVALIDARG;
+
+    if (metadata.IsPMAlpha() != ((flags & TEX_PMALPHA_REVERSE) != 0))
+        return E_FAIL;
+
+    // Each scanline is fully loaded before it is stored, so source and destination can alias
+    for (size_t index = 0; index < nimages; ++index)
+    {
+        const Image& img = images[index];
+        if (img.format != metadata.format)
+            return E_FAIL;
+
+        if ((img.width > UINT32_MAX) || (img.height > UINT32_MAX))
+            return E_FAIL;
+
+        HRESULT hr;
+        if (flags & TEX_PMALPHA_REVERSE)
+        {
+            hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? DemultiplyAlpha(img, img) : DemultiplyAlphaLinear(img, flags, img);
+        }
+        else
+        {
+            hr = (flags & TEX_PMALPHA_IGNORE_SRGB) ? PremultiplyAlpha_(img, img) : PremultiplyAlphaLinear(img, flags, img);
+        }
+        if (FAILED(hr))
+        {
+            image.Release();
+            return hr;
+        }
+    }
+
+    image.OverrideAlphaMode((flags & TEX_PMALPHA_REVERSE) ? TEX_ALPHA_MODE_STRAIGHT : TEX_ALPHA_MODE_PREMULTIPLIED);
+
+    return S_OK;
+}
@@ -231,7 +231,9 @@ namespace
             break;
 
         case TEX_FILTER_TRIANGLE:
-            // WIC does not implement this filter
+        case TEX_FILTER_LANCZOS:
+        case TEX_FILTER_KAISER:
+            // WIC does not implement these filters
             return false;
 
         default:
@@ -371,475 +373,238 @@ namespace
     }
 
 
-    //--- Linear Filter ---
-    HRESULT ResizeLinearFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
-    {
-        using namespace DirectX::Filters;
-
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
-
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 2 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[destImage.width + destImage.height]);
-        if (!lf)
-            return E_OUTOFMEMORY;
-
-        LinearFilter* lfX = lf.get();
-        LinearFilter* lfY = lf.get() + destImage.width;
-
-        CreateLinearFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
-        CreateLinearFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
+    //--- Separable Filters (Linear, Cubic, Lanczos, Kaiser, Triangle) ---
+    constexpr size_t c_ResizeBandRows = 16;
 
-    #ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
-
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
-
-        const size_t rowPitch = srcImage.rowPitch;
-
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
-
-        for (size_t y = 0; y < destImage.height; ++y)
+    // Horizontal pass for one source row
+    void FilterRow(
+        _Out_writes_(sf.dest) XMVECTOR* pDest,
+        _In_reads_(sf.source) const XMVECTOR* pSource,
+        const Filters::SeparableFilter& sf) noexcept
+    {
+        for (size_t x = 0; x < sf.dest; ++x)
         {
-            const auto& toY = lfY[y];
-
-            if (toY.u0 != u0)
+            XMVECTOR v = XMVectorZero();
+            for (size_t j = sf.first[x]; j < sf.first[x + 1]; ++j)
             {
-                if (toY.u0 != u1)
-                {
-                    u0 = toY.u0;
-
-                    if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else
-                {
-                    u0 = u1;
-                    u1 = size_t(-1);
-
-                    std::swap(row0, row1);
-                }
+                v = XMVectorMultiplyAdd(pSource[sf.index[j]], XMVectorReplicate(sf.weight[j]), v);
             }
+            pDest[x] = v;
+        }
+    }
 
-            if (toY.u1 != u1)
-            {
-                u1 = toY.u1;
-
-                if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-            }
+    // Upper bound on the distinct source rows any band of destination rows reads. A band's taps
+    // cover at most its lowest through highest source index, and never more rows than it has taps.
+    size_t MaxBandRows(const Filters::SeparableFilter& sf) noexcept
+    {
+        size_t maxRows = 1;
+        for (size_t y0 = 0; y0 < sf.dest; y0 += c_ResizeBandRows)
+        {
+            const size_t y1 = std::min(y0 + c_ResizeBandRows, sf.dest);
+            const size_t taps = sf.first[y1] - sf.first[y0];
+            if (!taps)
+                continue;
 
-            for (size_t x = 0; x < destImage.width; ++x)
+            size_t lo = SIZE_MAX;
+            size_t hi = 0;
+            for (size_t j = sf.first[y0]; j < sf.first[y1]; ++j)
             {
-                const auto& toX = lfX[x];
-
-                BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                lo = std::min<size_t>(lo, sf.index[j]);
+                hi = std::max<size_t>(hi, sf.index[j]);
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
+            maxRows = std::max(maxRows, std::min(hi - lo + 1, taps));
         }
-
-        return S_OK;
+        return maxRows;
     }
 
 
-    //--- Cubic Filter ---
-#ifdef __clang__
-#pragma clang diagnostic ignored "-Wextra-semi-stmt"
-#endif
-
-    HRESULT ResizeCubicFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
+    //--- Custom filter resize ---
+    HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
     {
-        using namespace DirectX::Filters;
+        if (!srcImage.pixels || !destImage.pixels)
+            return E_POINTER;
 
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
+        static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
 
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(srcImage.width) * 4 + destImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        uint32_t filter_select = filter & TEX_FILTER_MODE_MASK;
+        if (!filter_select)
+        {
+            // Default filter choice
+            filter_select = (((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height))
+                ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
+        }
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[destImage.width + destImage.height]);
-        if (!cf)
-            return E_OUTOFMEMORY;
+        switch (filter_select)
+        {
+        case TEX_FILTER_POINT:
+            return ResizePointFilter(srcImage, destImage);
 
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + destImage.width;
+        case TEX_FILTER_BOX:
+            return ResizeBoxFilter(srcImage, filter, destImage);
 
-        CreateCubicFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
-        CreateCubicFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+        case TEX_FILTER_LINEAR:
+            return ResizeSeparableFilter(srcImage, filter, Filters::SK_LINEAR, destImage);
 
-        XMVECTOR* target = scanline.get();
+        case TEX_FILTER_CUBIC:
+            return ResizeSeparableFilter(srcImage, filter, Filters::SK_CUBIC, destImage);
 
-        XMVECTOR* row0 = target + destImage.width;
-        XMVECTOR* row1 = row0 + srcImage.width;
-        XMVECTOR* row2 = row0 + srcImage.width * 2;
-        XMVECTOR* row3 = row0 + srcImage.width * 3;
+        case TEX_FILTER_LANCZOS:
+            return ResizeSeparableFilter(srcImage, filter, Filters::SK_LANCZOS, destImage);
 
-    #ifdef _DEBUG
-        memset(row0, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row1, 0xDD, sizeof(XMVECTOR)*srcImage.width);
-        memset(row2, 0xED, sizeof(XMVECTOR)*srcImage.width);
-        memset(row3, 0xFD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
+        case TEX_FILTER_KAISER:
+            return ResizeSeparableFilter(srcImage, filter, Filters::SK_KAISER, destImage);
 
-        const uint8_t* pSrc = srcImage.pixels;
-        uint8_t* pDest = destImage.pixels;
+        case TEX_FILTER_TRIANGLE:
+            return ResizeSeparableFilter(srcImage, filter, Filters::SK_TRIANGLE, destImage);
 
-        const size_t rowPitch = srcImage.rowPitch;
+        default:
+            return HRESULT_E_NOT_SUPPORTED;
+        }
+    }
+}
 
-        size_t u0 = size_t(-1);
-        size_t u1 = size_t(-1);
-        size_t u2 = size_t(-1);
-        size_t u3 = size_t(-1);
 
-        for (size_t y = 0; y < destImage.height; ++y)
-        {
-            const auto& toY = cfY[y];
+//-------------------------------------------------------------------------------------
+// Separable resize engine
+//-------------------------------------------------------------------------------------
+// The destination is processed in bands of rows. Each band filters the source rows it needs
+// horizontally into a cache-sized tile of float4s, then runs the vertical pass a whole row at
+// a time. Bands are independent, so with TEX_FILTER_PARALLEL they are spread over all workers.
+_Use_decl_annotations_
+HRESULT DirectX::Internal::ResizeSeparableFilter(
+    const Image& srcImage,
+    TEX_FILTER_FLAGS filter,
+    uint32_t kernel,
+    const Image& destImage) noexcept
+{
+    using namespace DirectX::Filters;
 
-            // Scanline 1
-            if (toY.u0 != u0)
-            {
-                if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
-                {
-                    u0 = toY.u0;
+    assert(srcImage.format == destImage.format);
 
-                    if (!LoadScanlineLinear(row0, srcImage.width, pSrc + (rowPitch * u0), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else if (toY.u0 == u1)
-                {
-                    u0 = u1;
-                    u1 = size_t(-1);
+    if (!srcImage.pixels || !destImage.pixels)
+        return E_POINTER;
 
-                    std::swap(row0, row1);
-                }
-                else if (toY.u0 == u2)
-                {
-                    u0 = u2;
-                    u2 = size_t(-1);
+    const bool wrapU = (filter & TEX_FILTER_WRAP_U) != 0;
+    const bool wrapV = (filter & TEX_FILTER_WRAP_V) != 0;
 
-                    std::swap(row0, row2);
-                }
-                else if (toY.u0 == u3)
-                {
-                    u0 = u3;
-                    u3 = size_t(-1);
+    SeparableFilter sfX;
+    HRESULT hr = (kernel == SK_TRIANGLE)
+        ? CreateTriangleSeparableFilter(srcImage.width, destImage.width, wrapU, sfX)
+        : CreateSeparableFilter(srcImage.width, destImage.width, wrapU, (filter & TEX_FILTER_MIRROR_U) != 0, kernel, sfX);
+    if (FAILED(hr))
+        return hr;
 
-                    std::swap(row0, row3);
-                }
-            }
+    SeparableFilter sfY;
+    hr = (kernel == SK_TRIANGLE)
+        ? CreateTriangleSeparableFilter(srcImage.height, destImage.height, wrapV, sfY)
+        : CreateSeparableFilter(srcImage.height, destImage.height, wrapV, (filter & TEX_FILTER_MIRROR_V) != 0, kernel, sfY);
+    if (FAILED(hr))
+        return hr;
 
-            // Scanline 2
-            if (toY.u1 != u1)
-            {
-                if (toY.u1 != u2 && toY.u1 != u3)
-                {
-                    u1 = toY.u1;
+    // Need to slightly bias triangle filter results for floating-point error accumulation which can
+    // be visible with harshly quantized values
+    const bool bias = (kernel == SK_TRIANGLE)
+        && (destImage.format == DXGI_FORMAT_R10G10B10A2_UNORM || destImage.format == DXGI_FORMAT_R10G10B10A2_UINT);
 
-                    if (!LoadScanlineLinear(row1, srcImage.width, pSrc + (rowPitch * u1), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else if (toY.u1 == u2)
-                {
-                    u1 = u2;
-                    u2 = size_t(-1);
+    const size_t nBands = (destImage.height + c_ResizeBandRows - 1) / c_ResizeBandRows;
+    const size_t workers = (filter & TEX_FILTER_PARALLEL) ? GetWorkerCount(nBands) : 1;
 
-                    std::swap(row1, row2);
-                }
-                else if (toY.u1 == u3)
-                {
-                    u1 = u3;
-                    u3 = size_t(-1);
+    // Distinct source rows a band can touch
+    const size_t maxRows = MaxBandRows(sfY);
 
-                    std::swap(row1, row3);
-                }
-            }
+    // Per worker: source scanline, tile of horizontally filtered rows, and target scanline
+    const uint64_t perWorker = uint64_t(srcImage.width) + uint64_t(maxRows + 1) * uint64_t(destImage.width);
+    const uint64_t total = perWorker * workers;
+    if (total > (SIZE_MAX / sizeof(XMVECTOR)))
+        return HRESULT_E_ARITHMETIC_OVERFLOW;
 
-            // Scanline 3
-            if (toY.u2 != u2)
-            {
-                if (toY.u2 != u3)
-                {
-                    u2 = toY.u2;
+    auto scanline = make_AlignedArrayXMVECTOR(total);
+    if (!scanline)
+        return E_OUTOFMEMORY;
 
-                    if (!LoadScanlineLinear(row2, srcImage.width, pSrc + (rowPitch * u2), rowPitch, srcImage.format, filter))
-                        return E_FAIL;
-                }
-                else
-                {
-                    u2 = u3;
-                    u3 = size_t(-1);
+    std::unique_ptr<size_t[]> rowLists(new (std::nothrow) size_t[maxRows * workers]);
+    if (!rowLists)
+        return E_OUTOFMEMORY;
 
-                    std::swap(row2, row3);
-                }
-            }
+    const uint8_t* pSrc = srcImage.pixels;
+    const size_t rowPitch = srcImage.rowPitch;
+    const size_t destWidth = destImage.width;
 
-            // Scanline 4
-            if (toY.u3 != u3)
-            {
-                u3 = toY.u3;
+    const bool ok = ParallelFor(nBands, workers, [&](size_t band, size_t worker) noexcept -> bool
+        {
+            XMVECTOR* row = scanline.get() + static_cast<size_t>(perWorker) * worker;
+            XMVECTOR* tile = row + srcImage.width;
+            XMVECTOR* target = tile + maxRows * destWidth;
 
-                if (!LoadScanlineLinear(row3, srcImage.width, pSrc + (rowPitch * u3), rowPitch, srcImage.format, filter))
-                    return E_FAIL;
-            }
+            const size_t y0 = band * c_ResizeBandRows;
+            const size_t y1 = std::min(y0 + c_ResizeBandRows, destImage.height);
 
-            for (size_t x = 0; x < destImage.width; ++x)
+            // Gather the distinct source rows for this band, kept sorted. Taps mostly ascend, so
+            // nearly every new row lands at the end.
+            size_t* rows = rowLists.get() + maxRows * worker;
+            size_t nRows = 0;
+            for (size_t j = sfY.first[y0]; j < sfY.first[y1]; ++j)
             {
-                const auto& toX = cfX[x];
-
-                XMVECTOR C0, C1, C2, C3;
+                const size_t index = sfY.index[j];
+                size_t* it = std::lower_bound(rows, rows + nRows, index);
+                if (it != rows + nRows && *it == index)
+                    continue;
 
-                CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3]);
-                CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3]);
-                CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3]);
-                CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3]);
-
-                CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
+                assert(nRows < maxRows);
+                std::copy_backward(it, rows + nRows, rows + nRows + 1);
+                *it = index;
+                ++nRows;
             }
 
-            if (!StoreScanlineLinear(pDest, destImage.rowPitch, destImage.format, target, destImage.width, filter))
-                return E_FAIL;
-            pDest += destImage.rowPitch;
-        }
-
-        return S_OK;
-    }
-
-
-    //--- Triangle Filter ---
-    HRESULT ResizeTriangleFilter(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
-    {
-        using namespace DirectX::Filters;
-
-        assert(srcImage.pixels && destImage.pixels);
-        assert(srcImage.format == destImage.format);
-
-        // Allocate initial temporary space (1 scanline, accumulation rows, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(srcImage.width);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        std::unique_ptr<TriangleRow[]> rowActive(new (std::nothrow) TriangleRow[destImage.height]);
-        if (!rowActive)
-            return E_OUTOFMEMORY;
-
-        TriangleRow * rowFree = nullptr;
-
-        std::unique_ptr<Filter> tfX;
-        HRESULT hr = CreateTriangleFilter(srcImage.width, destImage.width, (filter & TEX_FILTER_WRAP_U) != 0, tfX);
-        if (FAILED(hr))
-            return hr;
-
-        std::unique_ptr<Filter> tfY;
-        hr = CreateTriangleFilter(srcImage.height, destImage.height, (filter & TEX_FILTER_WRAP_V) != 0, tfY);
-        if (FAILED(hr))
-            return hr;
-
-        XMVECTOR* row = scanline.get();
-
-    #ifdef _DEBUG
-        memset(row, 0xCD, sizeof(XMVECTOR)*srcImage.width);
-    #endif
-
-        auto xFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfX.get()) + tfX->sizeInBytes);
-        auto yFromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tfY.get()) + tfY->sizeInBytes);
-
-        // Count times rows get written
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-        {
-            for (size_t j = 0; j < yFrom->count; ++j)
+            // Horizontal pass
+            for (size_t r = 0; r < nRows; ++r)
             {
-                const size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                ++rowActive[v].remaining;
-            }
-
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
-        }
+                if (!LoadScanlineLinear(row, srcImage.width, pSrc + (rowPitch * rows[r]), rowPitch, srcImage.format, filter))
+                    return false;
 
-        // Filter image
-        const uint8_t* pSrc = srcImage.pixels;
-        const size_t rowPitch = srcImage.rowPitch;
-        const uint8_t* pEndSrc = pSrc + rowPitch * srcImage.height;
-
-        uint8_t* pDest = destImage.pixels;
+                FilterRow(tile + r * destWidth, row, sfX);
+            }
 
-        for (FilterFrom* yFrom = tfY->from; yFrom < yFromEnd; )
-        {
-            // Create accumulation rows as needed
-            for (size_t j = 0; j < yFrom->count; ++j)
+            // Vertical pass
+            for (size_t y = y0; y < y1; ++y)
             {
-                const size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
-
-                if (!rowAcc->scanline)
+                for (size_t x = 0; x < destWidth; ++x)
                 {
-                    if (rowFree)
-                    {
-                        // Steal and reuse scanline from 'free row' list
-                        assert(rowFree->scanline != nullptr);
-                        rowAcc->scanline.reset(rowFree->scanline.release());
-                        rowFree = rowFree->next;
-                    }
-                    else
-                    {
-                        auto nscanline = make_AlignedArrayXMVECTOR(destImage.width);
-                        if (!nscanline)
-                            return E_OUTOFMEMORY;
-                        rowAcc->scanline.swap(nscanline);
-                    }
-
-                    memset(rowAcc->scanline.get(), 0, sizeof(XMVECTOR) * destImage.width);
+                    target[x] = XMVectorZero();
                 }
-            }
-
-            // Load source scanline
-            if ((pSrc + rowPitch) > pEndSrc)
-                return E_FAIL;
-
-            if (!LoadScanlineLinear(row, srcImage.width, pSrc, rowPitch, srcImage.format, filter))
-                return E_FAIL;
-
-            pSrc += rowPitch;
 
-            // Process row
-            size_t x = 0;
-            for (FilterFrom* xFrom = tfX->from; xFrom < xFromEnd; ++x)
-            {
-                for (size_t j = 0; j < yFrom->count; ++j)
+                for (size_t j = sfY.first[y]; j < sfY.first[y + 1]; ++j)
                 {
-                    const size_t v = yFrom->to[j].u;
-                    assert(v < destImage.height);
-                    const float yweight = yFrom->to[j].weight;
-
-                    XMVECTOR* accPtr = rowActive[v].scanline.get();
-                    if (!accPtr)
-                        return E_POINTER;
+                    const size_t slot = static_cast<size_t>(std::lower_bound(rows, rows + nRows, size_t(sfY.index[j])) - rows);
+                    const XMVECTOR* src = tile + slot * destWidth;
+                    const XMVECTOR w = XMVectorReplicate(sfY.weight[j]);
 
-                    for (size_t k = 0; k < xFrom->count; ++k)
+                    for (size_t x = 0; x < destWidth; ++x)
                     {
-                        size_t u = xFrom->to[k].u;
-                        assert(u < destImage.width);
-
-                        const XMVECTOR weight = XMVectorReplicate(yweight * xFrom->to[k].weight);
-
-                        assert(x < srcImage.width);
-                        accPtr[u] = XMVectorMultiplyAdd(row[x], weight, accPtr[u]);
+                        target[x] = XMVectorMultiplyAdd(src[x], w, target[x]);
                     }
                 }
 
-                xFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(xFrom) + xFrom->sizeInBytes);
-            }
-
-            // Write completed accumulation rows
-            for (size_t j = 0; j < yFrom->count; ++j)
-            {
-                size_t v = yFrom->to[j].u;
-                assert(v < destImage.height);
-                TriangleRow* rowAcc = &rowActive[v];
-
-                assert(rowAcc->remaining > 0);
-                --rowAcc->remaining;
-
-                if (!rowAcc->remaining)
+                if (bias)
                 {
-                    XMVECTOR* pAccSrc = rowAcc->scanline.get();
-                    if (!pAccSrc)
-                        return E_POINTER;
+                    static const XMVECTORF32 Bias = { { { 0.f, 0.f, 0.f, 0.1f } } };
 
-                    switch (destImage.format)
+                    for (size_t x = 0; x < destWidth; ++x)
                     {
-                    case DXGI_FORMAT_R10G10B10A2_UNORM:
-                    case DXGI_FORMAT_R10G10B10A2_UINT:
-                        {
-                            // Need to slightly bias results for floating-point error accumulation which can
-                            // be visible with harshly quantized values
-                            static const XMVECTORF32 Bias = { { { 0.f, 0.f, 0.f, 0.1f } } };
-
-                            XMVECTOR* ptr = pAccSrc;
-                            for (size_t i = 0; i < destImage.width; ++i, ++ptr)
-                            {
-                                *ptr = XMVectorAdd(*ptr, Bias);
-                            }
-                        }
-                        break;
-
-                    default:
-                        break;
+                        target[x] = XMVectorAdd(target[x], Bias);
                     }
-
-                    // This performs any required clamping
-                    if (!StoreScanlineLinear(pDest + (destImage.rowPitch * v), destImage.rowPitch, destImage.format, pAccSrc, destImage.width, filter))
-                        return E_FAIL;
-
-                    // Put row on freelist to reuse it's allocated scanline
-                    rowAcc->next = rowFree;
-                    rowFree = rowAcc;
                 }
-            }
-
-            yFrom = reinterpret_cast<FilterFrom*>(reinterpret_cast<uint8_t*>(yFrom) + yFrom->sizeInBytes);
-        }
-
-        return S_OK;
-    }
-
-
-    //--- Custom filter resize ---
-    HRESULT PerformResizeUsingCustomFilters(const Image& srcImage, TEX_FILTER_FLAGS filter, const Image& destImage) noexcept
-    {
-        if (!srcImage.pixels || !destImage.pixels)
-            return E_POINTER;
-
-        static_assert(TEX_FILTER_POINT == 0x100000, "TEX_FILTER_ flag values don't match TEX_FILTER_MASK");
-
-        uint32_t filter_select = filter & TEX_FILTER_MODE_MASK;
-        if (!filter_select)
-        {
-            // Default filter choice
-            filter_select = (((destImage.width << 1) == srcImage.width) && ((destImage.height << 1) == srcImage.height))
-                ? TEX_FILTER_BOX : TEX_FILTER_LINEAR;
-        }
-
-        switch (filter_select)
-        {
-        case TEX_FILTER_POINT:
-            return ResizePointFilter(srcImage, destImage);
-
-        case TEX_FILTER_BOX:
-            return ResizeBoxFilter(srcImage, filter, destImage);
-
-        case TEX_FILTER_LINEAR:
-            return ResizeLinearFilter(srcImage, filter, destImage);
 
-        case TEX_FILTER_CUBIC:
-            return ResizeCubicFilter(srcImage, filter, destImage);
+                // This performs any required clamping
+                if (!StoreScanlineLinear(destImage.pixels + destImage.rowPitch * y, destImage.rowPitch, destImage.format, target, destWidth, filter))
+                    return false;
+            }
 
-        case TEX_FILTER_TRIANGLE:
-            return ResizeTriangleFilter(srcImage, filter, destImage);
+            return true;
+        });
 
-        default:
-            return HRESULT_E_NOT_SUPPORTED;
-        }
-    }
+    return (ok) ? S_OK : E_FAIL;
 }
 
 
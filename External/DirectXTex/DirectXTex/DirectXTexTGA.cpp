@@ -281,7 +281,8 @@ namespace
         }
 
         uint64_t sizeBytes = uint64_t(pHeader->wWidth) * uint64_t(pHeader->wHeight) * uint64_t(pHeader->bBitsPerPixel) / 8;
-        if (sizeBytes > UINT32_MAX)
+        // Only the address space limits the payload; file I/O is chunked and 64-bit
+        if (sizeBytes > SIZE_MAX)
         {
             return HRESULT_E_ARITHMETIC_OVERFLOW;
         }
@@ -391,529 +392,341 @@ namespace
 
 
     //-------------------------------------------------------------------------------------
-    // Uncompress pixel data from a TGA into the target image
+    // RLE scanline helpers
     //-------------------------------------------------------------------------------------
-    HRESULT UncompressPixels(
-        _In_reads_bytes_(size) const void* pSource,
-        size_t size,
-        TGA_FLAGS flags,
-        _In_ const Image* image,
-        _In_ uint32_t convFlags) noexcept
-    {
-        assert(pSource && size > 0);
 
-        if (!image || !image->pixels)
-            return E_POINTER;
+    // Rows per work item when decoding RLE scanlines in parallel
+    constexpr size_t c_RLEBandRows = 64;
 
-        // Compute TGA image data pitch
-        size_t rowPitch, slicePitch;
-        HRESULT hr = ComputePitch(image->format, image->width, image->height, rowPitch, slicePitch,
-            (convFlags & CONV_FLAGS_EXPAND) ? CP_FLAGS_24BPP : CP_FLAGS_NONE);
-        if (FAILED(hr))
-            return hr;
+    // Smaller images are decoded on the calling thread
+    constexpr size_t c_RLEParallelMinPixels = 512 * 512;
 
-        auto sPtr = static_cast<const uint8_t*>(pSource);
-        const uint8_t* endPtr = sPtr + size;
-
-        bool opaquealpha = false;
+    // Walks the packet headers once to find where each scanline starts in the source.
+    // Packets may not cross a scanline, so every row begins on a packet boundary.
+    HRESULT FindRLEScanlines(
+        _In_reads_bytes_(size) const uint8_t* pSource,
+        size_t size,
+        size_t width,
+        size_t height,
+        size_t bytesPerPixel,
+        _Out_writes_(height) size_t* rowStarts) noexcept
+    {
+        const uint8_t* sPtr = pSource;
+        const uint8_t* endPtr = pSource + size;
 
-        switch (image->format)
+        for (size_t y = 0; y < height; ++y)
         {
-        //--------------------------------------------------------------------------- 8-bit
-        case DXGI_FORMAT_R8_UNORM:
-            for (size_t y = 0; y < image->height; ++y)
-            {
-                size_t offset = ((convFlags & CONV_FLAGS_INVERTX) ? (image->width - 1) : 0);
-                assert(offset < rowPitch);
-
-                uint8_t* dPtr = image->pixels
-                    + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1)))
-                    + offset;
-
-                for (size_t x = 0; x < image->width; )
-                {
-                    if (sPtr >= endPtr)
-                        return E_FAIL;
+            rowStarts[y] = static_cast<size_t>(sPtr - pSource);
 
-                    if (*sPtr & 0x80)
-                    {
-                        // Repeat
-                        size_t j = size_t(*sPtr & 0x7F) + 1;
-                        if (++sPtr >= endPtr)
-                            return E_FAIL;
-
-                        for (; j > 0; --j, ++x)
-                        {
-                            if (x >= image->width)
-                                return E_FAIL;
-
-                            *dPtr = *sPtr;
-
-                            if (convFlags & CONV_FLAGS_INVERTX)
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
-
-                        ++sPtr;
-                    }
-                    else
-                    {
-                        // Literal
-                        size_t j = size_t(*sPtr & 0x7F) + 1;
-                        ++sPtr;
-
-                        if (sPtr + j > endPtr)
-                            return E_FAIL;
-
-                        for (; j > 0; --j, ++x)
-                        {
-                            if (x >= image->width)
-                                return E_FAIL;
-
-                            *dPtr = *(sPtr++);
-
-                            if (convFlags & CONV_FLAGS_INVERTX)
-                                --dPtr;
-                            else
-                                ++dPtr;
-                        }
-                    }
-                }
-            }
-            break;
-
-        //-------------------------------------------------------------------------- 16-bit
-        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            for (size_t x = 0; x < width; )
             {
-                uint32_t minalpha = 255;
-                uint32_t maxalpha = 0;
+                if (sPtr >= endPtr)
+                    return E_FAIL;
 
-                for (size_t y = 0; y < image->height; ++y)
-                {
-                    size_t offset = ((convFlags & CONV_FLAGS_INVERTX) ? (image->width - 1) : 0);
-                    assert(offset * 2 < rowPitch);
+                const size_t j = size_t(*sPtr & 0x7F) + 1;
+                const size_t bytes = (*sPtr & 0x80) ? bytesPerPixel : (j * bytesPerPixel);
+                ++sPtr;
 
-                    auto dPtr = reinterpret_cast<uint16_t*>(image->pixels
-                        + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1))))
-                        + offset;
+                if (bytes > static_cast<size_t>(endPtr - sPtr))
+                    return E_FAIL;
 
-                    for (size_t x = 0; x < image->width; )
-                    {
-                        if (sPtr >= endPtr)
-                            return E_FAIL;
+                sPtr += bytes;
+                x += j;
 
-                        if (*sPtr & 0x80)
-                        {
-                            // Repeat
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            if (sPtr + 1 >= endPtr)
-                                return E_FAIL;
-
-                            auto t = static_cast<uint16_t>(uint32_t(*sPtr) | uint32_t(*(sPtr + 1u) << 8));
-
-                            const uint32_t alpha = (t & 0x8000) ? 255 : 0;
-                            minalpha = std::min(minalpha, alpha);
-                            maxalpha = std::max(maxalpha, alpha);
-
-                            sPtr += 2;
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
-
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                        else
-                        {
-                            // Literal
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            if (sPtr + (j * 2) > endPtr)
-                                return E_FAIL;
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
+                if (x > width)
+                    return E_FAIL;
+            }
+        }
 
-                                auto t = static_cast<uint16_t>(uint32_t(*sPtr) | uint32_t(*(sPtr + 1u) << 8));
+        return S_OK;
+    }
 
-                                const uint32_t alpha = (t & 0x8000) ? 255 : 0;
-                                minalpha = std::min(minalpha, alpha);
-                                maxalpha = std::max(maxalpha, alpha);
+    // Expands one scanline that FindRLEScanlines has already validated. Repeat packets become
+    // a single fill, and literal packets become a memcpy when no conversion is needed.
+    template<typename T, size_t BytesPerPixel, bool Identity, typename LoadFn>
+    void ExpandRLEScanline(
+        _In_ const uint8_t* sPtr,
+        _Out_writes_(width) T* pDest,
+        size_t width,
+        bool invertX,
+        LoadFn load) noexcept
+    {
+        T* dPtr = invertX ? (pDest + width) : pDest;
+        const bool copyLiteral = Identity && !invertX;
 
-                                sPtr += 2;
-                                *dPtr = t;
+        for (size_t x = 0; x < width; )
+        {
+            const size_t j = size_t(*sPtr & 0x7F) + 1;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                    }
-                }
+            if (*sPtr++ & 0x80)
+            {
+                // Repeat
+                const T t = load(sPtr);
+                sPtr += BytesPerPixel;
 
-                // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-                if (maxalpha == 0 && !(flags & TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA))
+                if (invertX)
                 {
-                    opaquealpha = true;
-                    hr = SetAlphaChannelToOpaque(image);
-                    if (FAILED(hr))
-                        return hr;
+                    dPtr -= j;
+                    std::fill_n(dPtr, j, t);
                 }
-                else if (minalpha == 255)
+                else
                 {
-                    opaquealpha = true;
+                    std::fill_n(dPtr, j, t);
+                    dPtr += j;
                 }
             }
-            break;
-
-            //------------------------------------------------------ 24/32-bit (with swizzling)
-        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            else if (copyLiteral)
             {
-                uint32_t minalpha = 255;
-                uint32_t maxalpha = 0;
-
-                for (size_t y = 0; y < image->height; ++y)
+                // Literal
+                memcpy(dPtr, sPtr, j * sizeof(T));
+                sPtr += j * BytesPerPixel;
+                dPtr += j;
+            }
+            else
+            {
+                // Literal
+                for (size_t k = 0; k < j; ++k, sPtr += BytesPerPixel)
                 {
-                    size_t offset = ((convFlags & CONV_FLAGS_INVERTX) ? (image->width - 1) : 0);
-
-                    auto dPtr = reinterpret_cast<uint32_t*>(image->pixels
-                        + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1))))
-                        + offset;
-
-                    for (size_t x = 0; x < image->width; )
-                    {
-                        if (sPtr >= endPtr)
-                            return E_FAIL;
-
-                        if (*sPtr & 0x80)
-                        {
-                            // Repeat
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            uint32_t t;
-                            if (convFlags & CONV_FLAGS_EXPAND)
-                            {
-                                assert(offset * 3 < rowPitch);
-
-                                if (sPtr + 2 >= endPtr)
-                                    return E_FAIL;
-
-                                // BGR -> RGBA
-                                t = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | 0xFF000000;
-                                sPtr += 3;
-
-                                minalpha = maxalpha = 255;
-                            }
-                            else
-                            {
-                                assert(offset * 4 < rowPitch);
-
-                                if (sPtr + 3 >= endPtr)
-                                    return E_FAIL;
-
-                                // BGRA -> RGBA
-                                const uint32_t alpha = *(sPtr + 3);
-                                t = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | uint32_t(alpha << 24);
-
-                                minalpha = std::min(minalpha, alpha);
-                                maxalpha = std::max(maxalpha, alpha);
-
-                                sPtr += 4;
-                            }
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
-
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                        else
-                        {
-                            // Literal
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            if (convFlags & CONV_FLAGS_EXPAND)
-                            {
-                                if (sPtr + (j * 3) > endPtr)
-                                    return E_FAIL;
-                            }
-                            else
-                            {
-                                if (sPtr + (j * 4) > endPtr)
-                                    return E_FAIL;
-                            }
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                if (convFlags & CONV_FLAGS_EXPAND)
-                                {
-                                    assert(offset * 3 < rowPitch);
+                    if (invertX)
+                        *(--dPtr) = load(sPtr);
+                    else
+                        *(dPtr++) = load(sPtr);
+                }
+            }
 
-                                    if (sPtr + 2 >= endPtr)
-                                        return E_FAIL;
+            x += j;
+        }
+    }
 
-                                    // BGR -> RGBA
-                                    *dPtr = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | 0xFF000000;
-                                    sPtr += 3;
+    void DecodeRLEScanline(
+        _In_ const uint8_t* sPtr,
+        _Out_ uint8_t* pDest,
+        size_t width,
+        DXGI_FORMAT format,
+        uint32_t convFlags) noexcept
+    {
+        const bool invertX = (convFlags & CONV_FLAGS_INVERTX) != 0;
 
-                                    minalpha = maxalpha = 255;
-                                }
-                                else
-                                {
-                                    assert(offset * 4 < rowPitch);
+        switch (format)
+        {
+        case DXGI_FORMAT_R8_UNORM:
+            ExpandRLEScanline<uint8_t, 1, true>(sPtr, pDest, width, invertX,
+                [](const uint8_t* p) noexcept { return *p; });
+            break;
 
-                                    if (sPtr + 3 >= endPtr)
-                                        return E_FAIL;
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            ExpandRLEScanline<uint16_t, 2, true>(sPtr, reinterpret_cast<uint16_t*>(pDest), width, invertX,
+                [](const uint8_t* p) noexcept { return static_cast<uint16_t>(uint32_t(*p) | uint32_t(*(p + 1) << 8)); });
+            break;
 
-                                    // BGRA -> RGBA
-                                    uint32_t alpha = *(sPtr + 3);
-                                    *dPtr = uint32_t(*sPtr << 16) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2)) | uint32_t(alpha << 24);
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            if (convFlags & CONV_FLAGS_EXPAND)
+            {
+                // BGR -> RGBA
+                ExpandRLEScanline<uint32_t, 3, false>(sPtr, reinterpret_cast<uint32_t*>(pDest), width, invertX,
+                    [](const uint8_t* p) noexcept { return uint32_t(*p << 16) | uint32_t(*(p + 1) << 8) | uint32_t(*(p + 2)) | 0xFF000000; });
+            }
+            else
+            {
+                // BGRA -> RGBA
+                ExpandRLEScanline<uint32_t, 4, false>(sPtr, reinterpret_cast<uint32_t*>(pDest), width, invertX,
+                    [](const uint8_t* p) noexcept { return uint32_t(*p << 16) | uint32_t(*(p + 1) << 8) | uint32_t(*(p + 2)) | uint32_t(*(p + 3) << 24); });
+            }
+            break;
 
-                                    minalpha = std::min(minalpha, alpha);
-                                    maxalpha = std::max(maxalpha, alpha);
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            ExpandRLEScanline<uint32_t, 4, true>(sPtr, reinterpret_cast<uint32_t*>(pDest), width, invertX,
+                [](const uint8_t* p) noexcept { uint32_t t; memcpy(&t, p, sizeof(t)); return t; });
+            break;
 
-                                    sPtr += 4;
-                                }
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+            ExpandRLEScanline<uint32_t, 3, false>(sPtr, reinterpret_cast<uint32_t*>(pDest), width, invertX,
+                [](const uint8_t* p) noexcept { return uint32_t(*p) | uint32_t(*(p + 1) << 8) | uint32_t(*(p + 2) << 16); });
+            break;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                    }
-                }
+        default:
+            break;
+        }
+    }
 
-                // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-                if (maxalpha == 0 && !(flags & TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA))
-                {
-                    opaquealpha = true;
-                    hr = SetAlphaChannelToOpaque(image);
-                    if (FAILED(hr))
-                        return hr;
-                }
-                else if (minalpha == 255)
+    // Accumulates the alpha range of a decoded scanline; every source pixel lands in the row,
+    // so this matches tracking alpha while decoding.
+    void ScanlineAlphaRange(
+        _In_ const uint8_t* pPixels,
+        size_t width,
+        DXGI_FORMAT format,
+        _Inout_ uint32_t& minalpha,
+        _Inout_ uint32_t& maxalpha) noexcept
+    {
+        switch (format)
+        {
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            {
+                auto sPtr = reinterpret_cast<const uint16_t*>(pPixels);
+                uint32_t any = 0;
+                uint32_t all = 0x8000;
+                for (size_t x = 0; x < width; ++x)
                 {
-                    opaquealpha = true;
+                    any |= sPtr[x];
+                    all &= sPtr[x];
                 }
+                minalpha = std::min<uint32_t>(minalpha, (all & 0x8000) ? 255 : 0);
+                maxalpha = std::max<uint32_t>(maxalpha, (any & 0x8000) ? 255 : 0);
             }
             break;
 
-            //-------------------------------------------------------------------- 32-bit (BGR)
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
         case DXGI_FORMAT_B8G8R8A8_UNORM:
             {
-                assert((convFlags & CONV_FLAGS_EXPAND) == 0);
-
-                uint32_t minalpha = 255;
-                uint32_t maxalpha = 0;
-
-                for (size_t y = 0; y < image->height; ++y)
+                auto sPtr = reinterpret_cast<const uint32_t*>(pPixels);
+                uint32_t lo = minalpha;
+                uint32_t hi = maxalpha;
+                for (size_t x = 0; x < width; ++x)
                 {
-                    size_t offset = ((convFlags & CONV_FLAGS_INVERTX) ? (image->width - 1) : 0);
-
-                    auto dPtr = reinterpret_cast<uint32_t*>(image->pixels
-                        + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1))))
-                        + offset;
-
-                    for (size_t x = 0; x < image->width; )
-                    {
-                        if (sPtr >= endPtr)
-                            return E_FAIL;
-
-                        if (*sPtr & 0x80)
-                        {
-                            // Repeat
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
+                    const uint32_t alpha = sPtr[x] >> 24;
+                    lo = std::min(lo, alpha);
+                    hi = std::max(hi, alpha);
+                }
+                minalpha = lo;
+                maxalpha = hi;
+            }
+            break;
 
-                            assert(offset * 4 < rowPitch);
+        default:
+            break;
+        }
+    }
 
-                            if (sPtr + 3 >= endPtr)
-                                return E_FAIL;
 
-                            const uint32_t alpha = *(sPtr + 3);
+    //-------------------------------------------------------------------------------------
+    // Uncompress pixel data from a TGA into the target image
+    //-------------------------------------------------------------------------------------
+    HRESULT UncompressPixels(
+        _In_reads_bytes_(size) const void* pSource,
+        size_t size,
+        TGA_FLAGS flags,
+        _In_ const Image* image,
+        _In_ uint32_t convFlags) noexcept
+    {
+        assert(pSource && size > 0);
 
-                            auto t = *reinterpret_cast<const uint32_t*>(sPtr);
+        if (!image || !image->pixels)
+            return E_POINTER;
 
-                            minalpha = std::min(minalpha, alpha);
-                            maxalpha = std::max(maxalpha, alpha);
+        // Compute TGA image data pitch
+        size_t rowPitch, slicePitch;
+        HRESULT hr = ComputePitch(image->format, image->width, image->height, rowPitch, slicePitch,
+            (convFlags & CONV_FLAGS_EXPAND) ? CP_FLAGS_24BPP : CP_FLAGS_NONE);
+        if (FAILED(hr))
+            return hr;
 
-                            sPtr += 4;
+        bool hasAlpha = false;
+        size_t bytesPerPixel = 0;
+        switch (image->format)
+        {
+        case DXGI_FORMAT_R8_UNORM:
+            bytesPerPixel = 1;
+            break;
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            bytesPerPixel = 2;
+            hasAlpha = true;
+            break;
 
-                                *dPtr = t;
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+            bytesPerPixel = (convFlags & CONV_FLAGS_EXPAND) ? 3 : 4;
+            hasAlpha = true;
+            break;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                        else
-                        {
-                            // Literal
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+            assert((convFlags & CONV_FLAGS_EXPAND) == 0);
+            bytesPerPixel = 4;
+            hasAlpha = true;
+            break;
 
-                            if (sPtr + (j * 4) > endPtr)
-                                return E_FAIL;
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+            assert((convFlags & CONV_FLAGS_EXPAND) != 0);
+            bytesPerPixel = 3;
+            break;
 
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
+        default:
+            return E_FAIL;
+        }
 
-                                assert(offset * 4 < rowPitch);
+        assert(image->width * bytesPerPixel <= rowPitch);
 
-                                if (sPtr + 3 >= endPtr)
-                                    return E_FAIL;
+        const size_t height = image->height;
 
-                                const uint32_t alpha = *(sPtr + 3);
-                                *dPtr = *reinterpret_cast<const uint32_t*>(sPtr);
+        // Packets are variable-length, so a serial prepass finds each row before decoding
+        std::unique_ptr<size_t[]> rowStarts(new (std::nothrow) size_t[height]);
+        if (!rowStarts)
+            return E_OUTOFMEMORY;
 
-                                minalpha = std::min(minalpha, alpha);
-                                maxalpha = std::max(maxalpha, alpha);
+        hr = FindRLEScanlines(static_cast<const uint8_t*>(pSource), size, image->width, height, bytesPerPixel, rowStarts.get());
+        if (FAILED(hr))
+            return hr;
 
-                                sPtr += 4;
+        const size_t nBands = (height + c_RLEBandRows - 1) / c_RLEBandRows;
+        const size_t workers = (uint64_t(image->width) * height >= c_RLEParallelMinPixels) ? GetWorkerCount(nBands) : 1;
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                    }
-                }
+        std::unique_ptr<uint32_t[]> alphaRange(new (std::nothrow) uint32_t[workers * 2]);
+        if (!alphaRange)
+            return E_OUTOFMEMORY;
 
-                // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
-                if (maxalpha == 0 && !(flags & TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA))
-                {
-                    opaquealpha = true;
-                    hr = SetAlphaChannelToOpaque(image);
-                    if (FAILED(hr))
-                        return hr;
-                }
-                else if (minalpha == 255)
-                {
-                    opaquealpha = true;
-                }
-            }
-            break;
+        for (size_t w = 0; w < workers; ++w)
+        {
+            alphaRange[w * 2] = 255;
+            alphaRange[w * 2 + 1] = 0;
+        }
 
-            //-------------------------------------------------------------------- 24-bit (BGR)
-        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        ParallelFor(nBands, workers, [&](size_t band, size_t worker) noexcept -> bool
             {
-                assert((convFlags & CONV_FLAGS_EXPAND) != 0);
+                const size_t y0 = band * c_RLEBandRows;
+                const size_t y1 = std::min(y0 + c_RLEBandRows, height);
 
-                for (size_t y = 0; y < image->height; ++y)
+                uint32_t minalpha = alphaRange[worker * 2];
+                uint32_t maxalpha = alphaRange[worker * 2 + 1];
+
+                for (size_t y = y0; y < y1; ++y)
                 {
-                    size_t offset = ((convFlags & CONV_FLAGS_INVERTX) ? (image->width - 1) : 0);
+                    uint8_t* pDest = image->pixels
+                        + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (height - y - 1)));
 
-                    auto dPtr = reinterpret_cast<uint32_t*>(image->pixels
-                        + (image->rowPitch * ((convFlags & CONV_FLAGS_INVERTY) ? y : (image->height - y - 1))))
-                        + offset;
+                    DecodeRLEScanline(static_cast<const uint8_t*>(pSource) + rowStarts[y], pDest, image->width, image->format, convFlags);
 
-                    for (size_t x = 0; x < image->width; )
+                    if (hasAlpha)
                     {
-                        if (sPtr >= endPtr)
-                            return E_FAIL;
-
-                        if (*sPtr & 0x80)
-                        {
-                            // Repeat
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            assert(offset * 3 < rowPitch);
-
-                            if (sPtr + 2 >= endPtr)
-                                return E_FAIL;
-
-                            uint32_t t = uint32_t(*sPtr) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2) << 16);
-                            sPtr += 3;
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
-
-                                *dPtr = t;
-
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                        else
-                        {
-                            // Literal
-                            size_t j = size_t(*sPtr & 0x7F) + 1;
-                            ++sPtr;
-
-                            if (sPtr + (j * 3) > endPtr)
-                                return E_FAIL;
-
-                            for (; j > 0; --j, ++x)
-                            {
-                                if (x >= image->width)
-                                    return E_FAIL;
+                        ScanlineAlphaRange(pDest, image->width, image->format, minalpha, maxalpha);
+                    }
+                }
 
-                                assert(offset * 3 < rowPitch);
+                alphaRange[worker * 2] = minalpha;
+                alphaRange[worker * 2 + 1] = maxalpha;
+                return true;
+            });
 
-                                if (sPtr + 2 >= endPtr)
-                                    return E_FAIL;
+        if (!hasAlpha)
+            return S_OK;
 
-                                *dPtr = uint32_t(*sPtr) | uint32_t(*(sPtr + 1) << 8) | uint32_t(*(sPtr + 2) << 16);
-                                sPtr += 3;
+        uint32_t minalpha = 255;
+        uint32_t maxalpha = 0;
+        for (size_t w = 0; w < workers; ++w)
+        {
+            minalpha = std::min(minalpha, alphaRange[w * 2]);
+            maxalpha = std::max(maxalpha, alphaRange[w * 2 + 1]);
+        }
 
-                                if (convFlags & CONV_FLAGS_INVERTX)
-                                    --dPtr;
-                                else
-                                    ++dPtr;
-                            }
-                        }
-                    }
-                }
-            }
-            break;
+        // If there are no non-zero alpha channel entries, we'll assume alpha is not used and force it to opaque
+        if (maxalpha == 0 && !(flags & TGA_FLAGS_ALLOW_ALL_ZERO_ALPHA))
+        {
+            hr = SetAlphaChannelToOpaque(image);
+            if (FAILED(hr))
+                return hr;
 
-            //---------------------------------------------------------------------------------
-        default:
-            return E_FAIL;
+            return S_FALSE;
         }
 
-        return opaquealpha ? S_FALSE : S_OK;
+        return (minalpha == 255) ? S_FALSE : S_OK;
     }
 
 
@@ -1508,13 +1321,13 @@ HRESULT DirectX::GetMetadataFromTGAFile(const wchar_t* szFile, TGA_FLAGS flags,
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid TGA file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
     {
         return HRESULT_E_FILE_TOO_LARGE;
     }
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -1524,14 +1337,14 @@ HRESULT DirectX::GetMetadataFromTGAFile(const wchar_t* szFile, TGA_FLAGS flags,
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    size_t len = fileLen;
+    auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the standard header to be a valid TGA
@@ -1683,7 +1496,7 @@ HRESULT DirectX::LoadFromTGAMemory(
 
     const void* pPixels = static_cast<const uint8_t*>(pSource) + offset + paletteOffset;
 
-    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1, CP_FLAGS_LIMIT_4GB);
+    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1);
     if (FAILED(hr))
         return hr;
 
@@ -1772,13 +1585,13 @@ HRESULT DirectX::LoadFromTGAFile(
         return HRESULT_FROM_WIN32(GetLastError());
     }
 
-    // File is too big for 32-bit allocation, so reject read (4 GB should be plenty large enough for a valid TGA file)
-    if (fileInfo.EndOfFile.HighPart > 0)
+    // File is too big for the address space of this build
+    if (static_cast<uint64_t>(fileInfo.EndOfFile.QuadPart) > SIZE_MAX)
     {
         return HRESULT_E_FILE_TOO_LARGE;
     }
 
-    const size_t len = fileInfo.EndOfFile.LowPart;
+    const auto len = static_cast<size_t>(fileInfo.EndOfFile.QuadPart);
 #else // !WIN32
     std::ifstream inFile(std::filesystem::path(szFile), std::ios::in | std::ios::binary | std::ios::ate);
     if (!inFile)
@@ -1788,14 +1601,14 @@ HRESULT DirectX::LoadFromTGAFile(
     if (!inFile)
         return E_FAIL;
 
-    if (fileLen > UINT32_MAX)
+    if (static_cast<uint64_t>(fileLen) > SIZE_MAX)
         return HRESULT_E_FILE_TOO_LARGE;
 
     inFile.seekg(0, std::ios::beg);
     if (!inFile)
         return E_FAIL;
 
-    size_t len = fileLen;
+    auto len = static_cast<size_t>(fileLen);
 #endif
 
     // Need at least enough data to fill the header to be a valid TGA
@@ -1854,7 +1667,7 @@ HRESULT DirectX::LoadFromTGAFile(
     #endif
     }
 
-    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1, CP_FLAGS_LIMIT_4GB);
+    hr = image.Initialize2D(mdata.format, mdata.width, mdata.height, 1, 1);
     if (FAILED(hr))
         return hr;
 
@@ -1871,32 +1684,16 @@ HRESULT DirectX::LoadFromTGAFile(
             return HRESULT_E_HANDLE_EOF;
         }
 
-        if (image.GetPixelsSize() > UINT32_MAX)
-        {
-            image.Release();
-            return HRESULT_E_ARITHMETIC_OVERFLOW;
-        }
-
     #ifdef _WIN32
-        if (!ReadFile(hFile.get(), image.GetPixels(), static_cast<DWORD>(image.GetPixelsSize()), &bytesRead, nullptr))
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead != image.GetPixelsSize())
-        {
-            image.Release();
-            return E_FAIL;
-        }
+        hr = ReadFileChunked(hFile.get(), image.GetPixels(), image.GetPixelsSize());
     #else
-        inFile.read(reinterpret_cast<char*>(image.GetPixels()), image.GetPixelsSize());
-        if (!inFile)
+        hr = ReadFileChunked(inFile, image.GetPixels(), image.GetPixelsSize());
+    #endif
+        if (FAILED(hr))
         {
             image.Release();
-            return E_FAIL;
+            return hr;
         }
-    #endif
 
         switch (mdata.format)
         {
@@ -2097,25 +1894,15 @@ HRESULT DirectX::LoadFromTGAFile(
         }
 
     #ifdef _WIN32
-        if (!ReadFile(hFile.get(), temp.get(), static_cast<DWORD>(remaining), &bytesRead, nullptr))
-        {
-            image.Release();
-            return HRESULT_FROM_WIN32(GetLastError());
-        }
-
-        if (bytesRead != remaining)
-        {
-            image.Release();
-            return E_FAIL;
-        }
+        hr = ReadFileChunked(hFile.get(), temp.get(), remaining);
     #else
-        inFile.read(reinterpret_cast<char*>(temp.get()), remaining);
-        if (!inFile)
+        hr = ReadFileChunked(inFile, temp.get(), remaining);
+    #endif
+        if (FAILED(hr))
         {
             image.Release();
-            return E_FAIL;
+            return hr;
         }
-    #endif
 
         size_t paletteOffset = 0;
         uint8_t palette[256 * 4] = {};
@@ -11,6 +11,8 @@
 
 #include "DirectXTexP.h"
 
+#include <unordered_map>
+
 #if (defined(_XBOX_ONE) && defined(_TITLE)) || defined(_GAMING_XBOX)
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT == DXGI_FORMAT_R10G10B10_7E3_A2_FLOAT, "Xbox mismatch detected");
 static_assert(XBOX_DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT == DXGI_FORMAT_R10G10B10_6E4_A2_FLOAT, "Xbox mismatch detected");
@@ -32,6 +34,7 @@ static_assert(WIN11_DXGI_FORMAT_A4B4G4R4_UNORM == DXGI_FORMAT_A4B4G4R4_UNORM, "W
 #endif
 
 using namespace DirectX;
+using namespace DirectX::Internal;
 using Microsoft::WRL::ComPtr;
 
 namespace
@@ -1806,6 +1809,229 @@ uint32_t TexMetadata::CalculateSubresource(size_t mip, size_t item, size_t plane
 }
 
 
+//=====================================================================================
+// Pixel memory allocation
+//=====================================================================================
+
+namespace
+{
+    std::atomic<MemoryAllocator*> g_allocator(nullptr);
+
+    thread_local MemoryAllocator* t_allocator = nullptr;
+
+    constexpr size_t c_PoolMinClass = 4096;
+    constexpr size_t c_PoolDefaultRetained = 512 * 1024 * 1024;
+    constexpr size_t c_PoolPageSize = 4096;
+
+    // Each pooled block starts with its size class; the header keeps the returned pointer 16-byte aligned
+    constexpr size_t c_PoolHeaderSize = 16;
+
+    // Rounds up to one of four classes per power of two, which bounds the waste at 25%
+    inline size_t PoolSizeClass(size_t size) noexcept
+    {
+        if (size <= c_PoolMinClass)
+            return c_PoolMinClass;
+
+        const size_t n = size - 1;
+
+        size_t shift = 0;
+        for (size_t bits = n >> 3; bits > 0; bits >>= 1)
+            ++shift;
+
+        const size_t steps = (n >> shift) + 1;
+        if (steps > (SIZE_MAX >> shift))
+            return 0;
+
+        return steps << shift;
+    }
+}
+
+_Use_decl_annotations_
+MemoryAllocator* DirectX::SetMemoryAllocator(MemoryAllocator* allocator) noexcept
+{
+    return g_allocator.exchange(allocator);
+}
+
+_Use_decl_annotations_
+MemoryAllocator* DirectX::SetThreadMemoryAllocator(MemoryAllocator* allocator) noexcept
+{
+    MemoryAllocator* previous = t_allocator;
+    t_allocator = allocator;
+    return previous;
+}
+
+MemoryAllocator* DirectX::Internal::GetMemoryAllocator() noexcept
+{
+    return (t_allocator) ? t_allocator : g_allocator.load();
+}
+
+_Use_decl_annotations_
+void* DirectX::Internal::AllocatePixelMemory(MemoryAllocator* allocator, size_t size) noexcept
+{
+    void* ptr = (allocator) ? allocator->Allocate(size) : _aligned_malloc(size, 16);
+    assert((reinterpret_cast<uintptr_t>(ptr) & 0xF) == 0);
+    return ptr;
+}
+
+_Use_decl_annotations_
+void DirectX::Internal::FreePixelMemory(MemoryAllocator* allocator, void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+
+    if (allocator)
+    {
+        allocator->Free(ptr);
+    }
+    else
+    {
+        _aligned_free(ptr);
+    }
+}
+
+
+//-------------------------------------------------------------------------------------
+// PooledAllocator
+//-------------------------------------------------------------------------------------
+
+struct PooledAllocator::Impl
+{
+    std::mutex                                          mutex;
+    std::unordered_map<size_t, std::vector<uint8_t*>>   freeBlocks;     // keyed by size class
+    size_t                                              maxRetained;
+    PoolStats                                           stats;
+
+    explicit Impl(size_t retained) noexcept : maxRetained(retained), stats{} {}
+};
+
+_Use_decl_annotations_
+PooledAllocator::PooledAllocator(size_t maxRetained) noexcept :
+    m_impl(new (std::nothrow) Impl(maxRetained ? maxRetained : c_PoolDefaultRetained))
+{
+    // Without the pool state every request simply goes to the CRT heap
+}
+
+PooledAllocator::~PooledAllocator()
+{
+    Trim();
+
+    delete m_impl;
+}
+
+_Use_decl_annotations_
+void* PooledAllocator::Allocate(size_t size) noexcept
+{
+    if (!size)
+        return nullptr;
+
+    const size_t sizeClass = PoolSizeClass(size);
+    if (!sizeClass || sizeClass > (SIZE_MAX - c_PoolHeaderSize))
+        return nullptr;
+
+    uint8_t* block = nullptr;
+    if (m_impl)
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+
+        auto& stats = m_impl->stats;
+        ++stats.allocations;
+        stats.bytesAllocated += sizeClass;
+
+        auto it = m_impl->freeBlocks.find(sizeClass);
+        if (it != m_impl->freeBlocks.end() && !it->second.empty())
+        {
+            block = it->second.back();
+            it->second.pop_back();
+
+            ++stats.recycled;
+            stats.bytesRecycled += sizeClass;
+            stats.pagesReused += sizeClass / c_PoolPageSize;
+            stats.bytesRetained -= sizeClass;
+        }
+    }
+
+    if (!block)
+    {
+        block = static_cast<uint8_t*>(_aligned_malloc(sizeClass + c_PoolHeaderSize, 16));
+        if (!block)
+        {
+            if (m_impl)
+            {
+                std::lock_guard<std::mutex> lock(m_impl->mutex);
+                --m_impl->stats.allocations;
+                m_impl->stats.bytesAllocated -= sizeClass;
+            }
+            return nullptr;
+        }
+
+        *reinterpret_cast<size_t*>(block) = sizeClass;
+    }
+
+    return block + c_PoolHeaderSize;
+}
+
+_Use_decl_annotations_
+void PooledAllocator::Free(void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+
+    auto block = static_cast<uint8_t*>(ptr) - c_PoolHeaderSize;
+    const size_t sizeClass = *reinterpret_cast<const size_t*>(block);
+
+    if (m_impl)
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+
+        if (m_impl->stats.bytesRetained + sizeClass <= m_impl->maxRetained)
+        {
+            try
+            {
+                m_impl->freeBlocks[sizeClass].push_back(block);
+                m_impl->stats.bytesRetained += sizeClass;
+                return;
+            }
+            catch (...)
+            {
+                // Fall through and release the block
+            }
+        }
+    }
+
+    _aligned_free(block);
+}
+
+void PooledAllocator::Trim() noexcept
+{
+    if (!m_impl)
+        return;
+
+    std::unordered_map<size_t, std::vector<uint8_t*>> blocks;
+    {
+        std::lock_guard<std::mutex> lock(m_impl->mutex);
+        blocks.swap(m_impl->freeBlocks);
+        m_impl->stats.bytesRetained = 0;
+    }
+
+    for (auto& it : blocks)
+    {
+        for (auto block : it.second)
+        {
+            _aligned_free(block);
+        }
+    }
+}
+
+PoolStats PooledAllocator::GetStats() const noexcept
+{
+    if (!m_impl)
+        return PoolStats{};
+
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    return m_impl->stats;
+}
+
+
 //=====================================================================================
 // Blob - Bitmap image container
 //=====================================================================================
@@ -1818,9 +2044,11 @@ Blob& Blob::operator= (Blob&& moveFrom) noexcept
 
         m_buffer = moveFrom.m_buffer;
         m_size = moveFrom.m_size;
+        m_allocator = moveFrom.m_allocator;
 
         moveFrom.m_buffer = nullptr;
         moveFrom.m_size = 0;
+        moveFrom.m_allocator = nullptr;
     }
     return *this;
 }
@@ -1829,11 +2057,12 @@ void Blob::Release() noexcept
 {
     if (m_buffer)
     {
-        _aligned_free(m_buffer);
+        FreePixelMemory(m_allocator, m_buffer);
         m_buffer = nullptr;
     }
 
     m_size = 0;
+    m_allocator = nullptr;
 }
 
 _Use_decl_annotations_
@@ -1844,7 +2073,8 @@ HRESULT Blob::Initialize(size_t size) noexcept
 
     Release();
 
-    m_buffer = reinterpret_cast<uint8_t*>(_aligned_malloc(size, 16));
+    m_allocator = GetMemoryAllocator();
+    m_buffer = reinterpret_cast<uint8_t*>(AllocatePixelMemory(m_allocator, size));
     if (!m_buffer)
     {
         Release();
@@ -1880,7 +2110,8 @@ HRESULT Blob::Resize(size_t size) noexcept
     if (!m_buffer || !m_size)
         return E_UNEXPECTED;
 
-    auto tbuffer = reinterpret_cast<uint8_t*>(_aligned_malloc(size, 16));
+    auto allocator = GetMemoryAllocator();
+    auto tbuffer = reinterpret_cast<uint8_t*>(AllocatePixelMemory(allocator, size));
     if (!tbuffer)
         return E_OUTOFMEMORY;
 
@@ -1890,6 +2121,7 @@ HRESULT Blob::Resize(size_t size) noexcept
 
     m_buffer = tbuffer;
     m_size = size;
+    m_allocator = allocator;
 
     return S_OK;
 }
@@ -12,6 +12,7 @@
 #include <DirectXMath.h>
 #include <DirectXPackedVector.h>
 
+#include <cmath>
 #include <memory>
 
 #include "scoped.h"
@@ -207,6 +208,222 @@ namespace DirectX
 }
 
 
+        //-------------------------------------------------------------------------------------
+        // Separable filtering helpers
+        //-------------------------------------------------------------------------------------
+
+        enum SEPARABLE_KERNEL : uint32_t
+        {
+            SK_LINEAR = 0,
+            SK_CUBIC,
+            SK_LANCZOS,
+            SK_KAISER,
+            SK_TRIANGLE,
+        };
+
+        constexpr float SK_LANCZOS_RADIUS = 3.f;
+        constexpr float SK_KAISER_RADIUS = 3.f;
+        constexpr float SK_KAISER_ALPHA = 4.f;
+
+        // One dimension of a separable filter: destination sample u reads the source samples
+        // index[first[u]] .. index[first[u + 1] - 1] with the matching weights (compressed sparse rows).
+        struct SeparableFilter
+        {
+            size_t                      source;
+            size_t                      dest;
+            size_t                      maxTaps;
+            std::unique_ptr<size_t[]>   first;
+            std::unique_ptr<uint32_t[]> index;
+            std::unique_ptr<float[]>    weight;
+        };
+
+        inline float BesselI0(float x) noexcept
+        {
+            // Power series, converges quickly for the window arguments used here
+            float sum = 1.f;
+            float term = 1.f;
+            const float q = x * x * 0.25f;
+            for (int k = 1; k < 32; ++k)
+            {
+                term *= q / float(k * k);
+                sum += term;
+                if (term < sum * 1e-8f)
+                    break;
+            }
+            return sum;
+        }
+
+        inline float Sinc(float x) noexcept
+        {
+            if (fabsf(x) < 1e-6f)
+                return 1.f;
+
+            const float px = x * XM_PI;
+            return sinf(px) / px;
+        }
+
+        inline float SeparableKernel(uint32_t kernel, float x) noexcept
+        {
+            switch (kernel)
+            {
+            case SK_LANCZOS:
+                if (fabsf(x) >= SK_LANCZOS_RADIUS)
+                    return 0.f;
+                return Sinc(x) * Sinc(x / SK_LANCZOS_RADIUS);
+
+            case SK_KAISER:
+                {
+                    const float t = x / SK_KAISER_RADIUS;
+                    if (fabsf(t) >= 1.f)
+                        return 0.f;
+                    return Sinc(x) * BesselI0(SK_KAISER_ALPHA * sqrtf(1.f - t * t)) / BesselI0(SK_KAISER_ALPHA);
+                }
+
+            default:
+                return 0.f;
+            }
+        }
+
+        inline HRESULT CreateSeparableFilter(
+            _In_ size_t source, _In_ size_t dest, _In_ bool wrap, _In_ bool mirror, _In_ uint32_t kernel,
+            _Out_ SeparableFilter& sf) noexcept
+        {
+            assert(source > 0);
+            assert(dest > 0);
+
+            const float scale = float(source) / float(dest);
+
+            // Windowed sinc kernels widen with minification so they also act as the low-pass filter
+            const float filterScale = std::max(1.f, scale);
+
+            size_t maxTaps;
+            switch (kernel)
+            {
+            case SK_LINEAR:     maxTaps = 2; break;
+            case SK_CUBIC:      maxTaps = 4; break;
+            case SK_LANCZOS:    maxTaps = size_t(ceilf(SK_LANCZOS_RADIUS * filterScale)) * 2 + 1; break;
+            case SK_KAISER:     maxTaps = size_t(ceilf(SK_KAISER_RADIUS * filterScale)) * 2 + 1; break;
+            default:            return E_INVALIDARG;
+            }
+
+            const uint64_t totalTaps = uint64_t(dest) * uint64_t(maxTaps);
+            if (totalTaps > SIZE_MAX / sizeof(float))
+                return HRESULT_E_ARITHMETIC_OVERFLOW;
+
+            sf.source = source;
+            sf.dest = dest;
+            sf.maxTaps = maxTaps;
+            sf.first.reset(new (std::nothrow) size_t[dest + 1]);
+            sf.index.reset(new (std::nothrow) uint32_t[static_cast<size_t>(totalTaps)]);
+            sf.weight.reset(new (std::nothrow) float[static_cast<size_t>(totalTaps)]);
+            if (!sf.first || !sf.index || !sf.weight)
+                return E_OUTOFMEMORY;
+
+            const auto maxu = ptrdiff_t(source) - 1;
+
+            size_t count = 0;
+            for (size_t u = 0; u < dest; ++u)
+            {
+                sf.first[u] = count;
+
+                switch (kernel)
+                {
+                case SK_LINEAR:
+                    {
+                        // Same sample positions and weights as CreateLinearFilter (mirror is the same as clamp)
+                        const float srcB = (float(u) + 0.5f) * scale + 0.5f;
+
+                        ptrdiff_t isrcB = ptrdiff_t(srcB);
+                        ptrdiff_t isrcA = isrcB - 1;
+
+                        const float weight = 1.0f + float(isrcB) - srcB;
+
+                        if (isrcA < 0)
+                        {
+                            isrcA = (wrap) ? maxu : 0;
+                        }
+
+                        if (isrcB > maxu)
+                        {
+                            isrcB = (wrap) ? 0 : maxu;
+                        }
+
+                        sf.index[count] = static_cast<uint32_t>(isrcA);
+                        sf.weight[count++] = weight;
+                        sf.index[count] = static_cast<uint32_t>(isrcB);
+                        sf.weight[count++] = 1.0f - weight;
+                    }
+                    break;
+
+                case SK_CUBIC:
+                    {
+                        // Same sample positions as CreateCubicFilter, with CUBIC_INTERPOLATE expanded into weights
+                        const float srcB = (float(u) + 0.5f) * scale - 0.5f;
+
+                        const ptrdiff_t isrcB = bounduvw(ptrdiff_t(srcB), maxu, wrap, mirror);
+                        const float x = srcB - float(isrcB);
+                        const float x2 = x * x;
+                        const float x3 = x2 * x;
+
+                        const float w0 = -x / 3.f + x2 / 2.f - x3 / 6.f;
+                        const float w2 = x + x2 / 2.f - x3 / 2.f;
+                        const float w3 = -x / 6.f + x3 / 6.f;
+
+                        sf.index[count] = static_cast<uint32_t>(bounduvw(isrcB - 1, maxu, wrap, mirror));
+                        sf.weight[count++] = w0;
+                        sf.index[count] = static_cast<uint32_t>(isrcB);
+                        sf.weight[count++] = 1.f - w0 - w2 - w3;
+                        sf.index[count] = static_cast<uint32_t>(bounduvw(isrcB + 1, maxu, wrap, mirror));
+                        sf.weight[count++] = w2;
+                        sf.index[count] = static_cast<uint32_t>(bounduvw(isrcB + 2, maxu, wrap, mirror));
+                        sf.weight[count++] = w3;
+                    }
+                    break;
+
+                default:
+                    {
+                        const float center = (float(u) + 0.5f) * scale - 0.5f;
+                        const float radius = ((kernel == SK_LANCZOS) ? SK_LANCZOS_RADIUS : SK_KAISER_RADIUS) * filterScale;
+
+                        const auto i0 = static_cast<ptrdiff_t>(floorf(center - radius)) + 1;
+                        const auto i1 = static_cast<ptrdiff_t>(floorf(center + radius));
+
+                        const size_t start = count;
+                        float total = 0.f;
+                        for (ptrdiff_t i = i0; i <= i1 && (count - start) < maxTaps; ++i)
+                        {
+                            const float w = SeparableKernel(kernel, (float(i) - center) / filterScale);
+                            if (w == 0.f)
+                                continue;
+
+                            sf.index[count] = static_cast<uint32_t>(bounduvw(i, maxu, wrap, mirror));
+                            sf.weight[count++] = w;
+                            total += w;
+                        }
+
+                        if (count == start)
+                        {
+                            sf.index[count] = static_cast<uint32_t>(bounduvw(ptrdiff_t(center + 0.5f), maxu, wrap, mirror));
+                            sf.weight[count++] = 1.f;
+                        }
+                        else if (total != 0.f)
+                        {
+                            // Normalize so flat areas stay flat
+                            const float inv = 1.f / total;
+                            for (size_t j = start; j < count; ++j)
+                                sf.weight[j] *= inv;
+                        }
+                    }
+                    break;
+                }
+            }
+
+            sf.first[dest] = count;
+
+            return S_OK;
+        }
+
+
         //-------------------------------------------------------------------------------------
         // Triangle filtering helpers
         //-------------------------------------------------------------------------------------
@@ -418,5 +635,74 @@ namespace DirectX
             return S_OK;
         }
 
+        // Transposes the triangle filter (which maps each source sample to the destination samples it
+        // contributes to) into a SeparableFilter. Taps stay in ascending source order, so accumulation
+        // follows the same order as the scatter loops in the original triangle filter.
+        inline HRESULT CreateTriangleSeparableFilter(_In_ size_t source, _In_ size_t dest, _In_ bool wrap, _Out_ SeparableFilter& sf) noexcept
+        {
+            std::unique_ptr<Filter> tf;
+            HRESULT hr = CreateTriangleFilter(source, dest, wrap, tf);
+            if (FAILED(hr))
+                return hr;
+
+            auto fromEnd = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(tf.get()) + tf->sizeInBytes);
+
+            sf.source = source;
+            sf.dest = dest;
+            sf.maxTaps = 0;
+            sf.first.reset(new (std::nothrow) size_t[dest + 1]);
+            if (!sf.first)
+                return E_OUTOFMEMORY;
+
+            memset(sf.first.get(), 0, sizeof(size_t) * (dest + 1));
+
+            // Count taps per destination sample
+            size_t total = 0;
+            for (auto from = tf->from; from < fromEnd; )
+            {
+                for (size_t j = 0; j < from->count; ++j)
+                {
+                    const size_t u = from->to[j].u;
+                    if (u >= dest)
+                        return E_FAIL;
+
+                    ++sf.first[u + 1];
+                    ++total;
+                }
+
+                from = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(from) + from->sizeInBytes);
+            }
+
+            for (size_t u = 0; u < dest; ++u)
+            {
+                sf.maxTaps = std::max(sf.maxTaps, sf.first[u + 1]);
+                sf.first[u + 1] += sf.first[u];
+            }
+
+            sf.index.reset(new (std::nothrow) uint32_t[std::max<size_t>(total, 1)]);
+            sf.weight.reset(new (std::nothrow) float[std::max<size_t>(total, 1)]);
+            std::unique_ptr<size_t[]> fill(new (std::nothrow) size_t[dest]);
+            if (!sf.index || !sf.weight || !fill)
+                return E_OUTOFMEMORY;
+
+            memcpy(fill.get(), sf.first.get(), sizeof(size_t) * dest);
+
+            // Scatter in source order
+            size_t x = 0;
+            for (auto from = tf->from; from < fromEnd; ++x)
+            {
+                for (size_t j = 0; j < from->count; ++j)
+                {
+                    const size_t k = fill[from->to[j].u]++;
+                    sf.index[k] = static_cast<uint32_t>(x);
+                    sf.weight[k] = from->to[j].weight;
+                }
+
+                from = reinterpret_cast<const FilterFrom*>(reinterpret_cast<const uint8_t*>(from) + from->sizeInBytes);
+            }
+
+            return S_OK;
+        }
+
     } // namespace Filters
 } // namespace DirectX
@@ -30,6 +30,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -142,6 +143,7 @@ namespace
         OPT_RECONSTRUCT_Z,
         OPT_BCNONMULT4FIX,
         OPT_IGNORE_SRGB_METADATA,
+        OPT_MEMORY_STATS,
     #ifdef USE_XBOX_EXTS
         OPT_USE_XBOX,
         OPT_XGMODE,
@@ -164,6 +166,8 @@ namespace
         OPT_FEATURE_LEVEL,
         OPT_ALPHA_THRESHOLD,
         OPT_ALPHA_WEIGHT,
+        OPT_RDO_LAMBDA,
+        OPT_BLOCK_CACHE,
         OPT_NORMAL_MAP_AMPLITUDE,
         OPT_BC_COMPRESS,
         OPT_ROTATE_COLOR,
@@ -270,6 +274,7 @@ namespace
         { L"alpha-threshold",       OPT_ALPHA_THRESHOLD },
         { L"alpha-weight",          OPT_ALPHA_WEIGHT },
         { L"bad-tails",             OPT_DDS_BAD_DXTN_TAILS },
+        { L"block-cache",           OPT_BLOCK_CACHE },
         { L"block-compress",        OPT_BC_COMPRESS },
         { L"color-key",             OPT_COLORKEY },
         { L"dword-alignment",       OPT_DDS_DWORD_ALIGN },
@@ -288,6 +293,7 @@ namespace
         { L"image-filter",          OPT_FILTER },
         { L"invert-y",              OPT_INVERT_Y },
         { L"keep-coverage",         OPT_PRESERVE_ALPHA_COVERAGE },
+        { L"memory-stats",          OPT_MEMORY_STATS },
         { L"mip-levels",            OPT_MIPLEVELS },
         { L"normal-map-amplitude",  OPT_NORMAL_MAP_AMPLITUDE },
         { L"normal-map",            OPT_NORMAL_MAP },
@@ -296,6 +302,7 @@ namespace
         { L"permissive",            OPT_DDS_PERMISSIVE },
         { L"prefix",                OPT_PREFIX },
         { L"premultiplied-alpha",   OPT_PREMUL_ALPHA },
+        { L"rdo-lambda",            OPT_RDO_LAMBDA },
         { L"reconstruct-z",         OPT_RECONSTRUCT_Z },
         { L"rotate-color",          OPT_ROTATE_COLOR },
         { L"separate-alpha",        OPT_SEPALPHA },
@@ -658,6 +665,127 @@ namespace
         return ((x != 0) && !(x & (x - 1)));
     }
 
+    //--------------------------------------------------------------------------------------
+    // Tracks the pixel memory of every ScratchImage for --memory-stats. Each stage that
+    // produces a new image shows up as copied bytes; stages done in place copy nothing.
+    class MemoryStats final : public MemoryAllocator
+    {
+    public:
+        MemoryStats() noexcept : m_current(0), m_peak(0), m_allocated(0), m_stages{}, m_stageCount(0) {}
+
+        void* __cdecl Allocate(size_t size) noexcept override
+        {
+            auto block = static_cast<uint8_t*>(_aligned_malloc(size + c_HeaderSize, 16));
+            if (!block)
+                return nullptr;
+
+            *reinterpret_cast<size_t*>(block) = size;
+
+            m_allocated += size;
+            const size_t current = (m_current += size);
+            size_t peak = m_peak.load();
+            while (current > peak && !m_peak.compare_exchange_weak(peak, current)) {}
+
+            return block + c_HeaderSize;
+        }
+
+        void __cdecl Free(void* ptr) noexcept override
+        {
+            if (!ptr)
+                return;
+
+            auto block = static_cast<uint8_t*>(ptr) - c_HeaderSize;
+            m_current -= *reinterpret_cast<const size_t*>(block);
+            _aligned_free(block);
+        }
+
+        void Reset() noexcept
+        {
+            m_allocated = 0;
+            m_peak = m_current.load();
+            m_stageCount = 0;
+        }
+
+        void EndStage(const wchar_t* name) noexcept
+        {
+            if (m_stageCount < std::size(m_stages))
+            {
+                m_stages[m_stageCount++] = { name, m_allocated.load(), m_peak.load() };
+            }
+
+            m_allocated = 0;
+            m_peak = m_current.load();
+        }
+
+        void Print() const noexcept
+        {
+            constexpr double c_MB = 1024.0 * 1024.0;
+
+            size_t copied = 0;
+            size_t peak = 0;
+            for (size_t j = 0; j < m_stageCount; ++j)
+            {
+                const Stage& stage = m_stages[j];
+                wprintf(L"   %-14ls copied %9.2f MB, peak %9.2f MB\n", stage.name, double(stage.copied) / c_MB, double(stage.peak) / c_MB);
+                copied += stage.copied;
+                peak = std::max(peak, stage.peak);
+            }
+
+            wprintf(L"   %-14ls copied %9.2f MB, peak %9.2f MB\n", L"total", double(copied) / c_MB, double(peak) / c_MB);
+        }
+
+    private:
+        static constexpr size_t c_HeaderSize = 16;
+
+        struct Stage
+        {
+            const wchar_t* name;
+            size_t copied;
+            size_t peak;
+        };
+
+        std::atomic<size_t> m_current;
+        std::atomic<size_t> m_peak;
+        std::atomic<size_t> m_allocated;
+        Stage m_stages[16];
+        size_t m_stageCount;
+    };
+
+    //--------------------------------------------------------------------------------------
+    // Queues per-pixel operations so that consecutive options cost a single load/store of
+    // each scanline. Operations run in order on the same scanline, so each one may only
+    // read inPixels[j] before writing outPixels[j], and must be safe to call concurrently.
+    class PixelPipeline
+    {
+    public:
+        using PixelFunc = std::function<void __cdecl(XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t width, size_t y)>;
+
+        void Add(PixelFunc func) { m_ops.emplace_back(std::move(func)); }
+
+        HRESULT Apply(ScratchImage& image, TEX_FILTER_FLAGS flags)
+        {
+            if (m_ops.empty())
+                return S_OK;
+
+            const HRESULT hr = TransformImage(image,
+                [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
+                {
+                    m_ops[0](outPixels, inPixels, w, y);
+
+                    for (size_t j = 1; j < m_ops.size(); ++j)
+                    {
+                        m_ops[j](outPixels, outPixels, w, y);
+                    }
+                }, flags);
+
+            m_ops.clear();
+            return hr;
+        }
+
+    private:
+        std::vector<PixelFunc> m_ops;
+    };
+
     void PrintInfo(const TexMetadata& info, bool isXbox)
     {
         wprintf(L" (%zux%zu", info.width, info.height);
@@ -839,20 +967,25 @@ namespace
             L"\n"
             L"   -nologo             suppress copyright message\n"
             L"   --timing            display elapsed processing time\n"
+            L"   --memory-stats      display pixel memory copied and peak usage for each stage\n"
             L"\n"
-        #ifdef _OPENMP
-            L"   --single-proc       Do not use multi-threaded compression\n"
-        #endif
+            L"   --single-proc       Do not use multi-threading\n"
             L"   -gpu <adapter>      Select GPU for DirectCompute-based codecs (0 is default)\n"
             L"   -nogpu              Do not use DirectCompute-based codecs\n"
             L"\n"
             L"   -bc <options>, --block-compress <options>\n"
             L"                       Sets options for BC compression\n"
             L"                       options must be one or more of\n"
-            L"                          d, u, q, x\n"
+            L"                          d, u, q, x, h, f (BC6H fast)\n"
+            L"                       or a BC7 CPU quality level 0 (fastest) to 5 (full)\n"
             L"   -aw <weight>, --alpha-weight <weight>\n"
             L"                       BC7 GPU compressor weighting for alpha error metric\n"
             L"                       (defaults to 1.0)\n"
+            L"   --rdo-lambda <value>\n"
+            L"                       Rewrite BC1/3/4/5/7 CPU output for smaller zip/zstd size\n"
+            L"                       (0 disables; larger values trade quality for size)\n"
+            L"   --block-cache <file>\n"
+            L"                       Reuse BC CPU encoded blocks stored in file, then update it\n"
             L"\n"
             L"   -c <hex-RGB>, --color-key <hex-RGB>    colorkey (a.k.a. chromakey) transparency\n"
             L"   --rotate-color <rot>                   rotates color primaries and/or applies a curve\n"
@@ -1261,6 +1394,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     int adapter = -1;
     float alphaThreshold = TEX_THRESHOLD_DEFAULT;
     float alphaWeight = 1.f;
+    float rdoLambda = 0.f;
     CNMAP_FLAGS dwNormalMap = CNMAP_DEFAULT;
     float nmapAmplitude = 1.f;
     float wicQuality = -1.f;
@@ -1278,6 +1412,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     wchar_t szPrefix[MAX_PATH] = {};
     wchar_t szSuffix[MAX_PATH] = {};
     std::filesystem::path outputDir;
+    std::filesystem::path blockCacheFile;
 
     // Set locale for output since GetErrorDesc can get localized strings.
     std::locale::global(std::locale(""));
@@ -1368,6 +1503,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_FEATURE_LEVEL:
             case OPT_ALPHA_THRESHOLD:
             case OPT_ALPHA_WEIGHT:
+            case OPT_RDO_LAMBDA:
+            case OPT_BLOCK_CACHE:
             case OPT_NORMAL_MAP_AMPLITUDE:
             case OPT_BC_COMPRESS:
             case OPT_ROTATE_COLOR:
@@ -1411,6 +1548,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             case OPT_FEATURE_LEVEL:
             case OPT_ALPHA_THRESHOLD:
             case OPT_ALPHA_WEIGHT:
+            case OPT_RDO_LAMBDA:
+            case OPT_BLOCK_CACHE:
             case OPT_NORMAL_MAP:
             case OPT_NORMAL_MAP_AMPLITUDE:
             case OPT_WIC_QUALITY:
@@ -1552,6 +1691,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_BLOCK_CACHE:
+                {
+                    std::filesystem::path path(pValue);
+                    blockCacheFile = path.make_preferred();
+                }
+                break;
+
             case OPT_FILETYPE:
                 FileType = LookupByName(pValue, g_pSaveFileTypes);
                 if (!FileType)
@@ -1731,6 +1877,20 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 }
                 break;
 
+            case OPT_RDO_LAMBDA:
+                if (swscanf_s(pValue, L"%f", &rdoLambda) != 1)
+                {
+                    wprintf(L"Invalid value specified with --rdo-lambda (%ls)\n\n", pValue);
+                    PrintUsage();
+                    return 1;
+                }
+                else if (rdoLambda < 0.f)
+                {
+                    wprintf(L"--rdo-lambda (%ls) parameter must be positive\n\n", pValue);
+                    return 1;
+                }
+                break;
+
             case OPT_BC_COMPRESS:
                 {
                     dwCompress = TEX_COMPRESS_DEFAULT;
@@ -1760,6 +1920,24 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         found = true;
                     }
 
+                    if (wcschr(pValue, L'h'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC_HIGH;
+                        found = true;
+                    }
+
+                    if (wcschr(pValue, L'f'))
+                    {
+                        dwCompress |= TEX_COMPRESS_BC6H_FAST;
+                        found = true;
+                    }
+
+                    if (const wchar_t* pLevel = wcspbrk(pValue, L"012345"))
+                    {
+                        dwCompress |= static_cast<TEX_COMPRESS_FLAGS>(TEX_COMPRESS_BC7_QUALITY_0 * static_cast<uint32_t>(*pLevel - L'0' + 1));
+                        found = true;
+                    }
+
                     if ((dwCompress & (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS)) == (TEX_COMPRESS_BC7_QUICK | TEX_COMPRESS_BC7_USE_3SUBSETS))
                     {
                         wprintf(L"Can't use -bc x (max) and -bc q (quick) at same time\n\n");
@@ -1769,7 +1947,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                     if (!found)
                     {
-                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, or x\n\n", pValue);
+                        wprintf(L"Invalid value specified for -bc (%ls), missing d, u, q, x, h, f, or 0-5\n\n", pValue);
                         return 1;
                     }
                 }
@@ -1976,12 +2154,69 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         mipLevels = 1;
     }
 
+    if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
+    {
+        dwFilterOpts |= TEX_FILTER_PARALLEL;
+    }
+
     LARGE_INTEGER qpcFreq = {};
     std::ignore = QueryPerformanceFrequency(&qpcFreq);
 
     LARGE_INTEGER qpcStart = {};
     std::ignore = QueryPerformanceCounter(&qpcStart);
 
+    // Must outlive every image created below, since each one frees back through it
+    std::unique_ptr<MemoryStats> memStats;
+    if (dwOptions & (UINT64_C(1) << OPT_MEMORY_STATS))
+    {
+        memStats.reset(new (std::nothrow) MemoryStats);
+        if (!memStats)
+        {
+            wprintf(L"\nERROR: Memory allocation failed\n");
+            return 1;
+        }
+
+        SetMemoryAllocator(memStats.get());
+    }
+
+    // Loaded before any compression and saved once every file has been processed
+    std::unique_ptr<BlockCache> blockCache;
+    if (!blockCacheFile.empty())
+    {
+        blockCache.reset(new (std::nothrow) BlockCache);
+        if (!blockCache)
+        {
+            wprintf(L"\nERROR: Memory allocation failed\n");
+            return 1;
+        }
+
+        hr = blockCache->Initialize();
+        if (FAILED(hr))
+        {
+            wprintf(L"\nERROR: Failed to create block cache (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+            return 1;
+        }
+
+        std::error_code ec;
+        if (std::filesystem::exists(blockCacheFile, ec))
+        {
+            hr = blockCache->LoadFromFile(blockCacheFile.c_str());
+            if (FAILED(hr))
+            {
+                wprintf(L"\nWARNING: Ignoring unreadable block cache %ls (%08X%ls)\n",
+                    blockCacheFile.c_str(), static_cast<unsigned int>(hr), GetErrorDesc(hr));
+
+                // Start empty so nothing from the rejected file is written back
+                hr = blockCache->Initialize();
+                if (FAILED(hr))
+                {
+                    wprintf(L"\nERROR: Failed to create block cache (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return 1;
+                }
+            }
+        }
+    }
+
     // Convert images
     bool sizewarn = false;
     bool nonpow2warn = false;
@@ -1997,6 +2232,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             wprintf(L"\n");
 
         // --- Load source image -------------------------------------------------------
+        if (memStats)
+            memStats->Reset();
+
         wprintf(L"reading %ls", pConv->szSrc.c_str());
         fflush(stdout);
 
@@ -2226,6 +2464,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         wprintf(L" as");
         fflush(stdout);
 
+        if (memStats)
+            memStats->EndStage(L"load");
+
         // --- Planar ------------------------------------------------------------------
         if (IsPlanar(info.format))
         {
@@ -2376,6 +2617,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
         }
 
+        if (memStats)
+            memStats->EndStage(L"decompress");
+
         // --- Undo Premultiplied Alpha (if requested) ---------------------------------
         if ((dwOptions & (UINT64_C(1) << OPT_DEMUL_ALPHA))
             && HasAlpha(info.format)
@@ -2391,18 +2635,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
             else
             {
-                auto img = image->GetImage(0, 0, 0);
-                assert(img);
-                const size_t nimg = image->GetImageCount();
-
-                std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-                if (!timage)
-                {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
-                    return 1;
-                }
-
-                hr = PremultiplyAlpha(img, nimg, info, TEX_PMALPHA_REVERSE | dwSRGB, *timage);
+                hr = PremultiplyAlpha(*image, TEX_PMALPHA_REVERSE | dwSRGB);
                 if (FAILED(hr))
                 {
                     wprintf(L" FAILED [demultiply alpha] (%08X%ls)\n",
@@ -2411,32 +2644,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     continue;
                 }
 
-                auto& tinfo = timage->GetMetadata();
-                info.miscFlags2 = tinfo.miscFlags2;
-
-                assert(info.width == tinfo.width);
-                assert(info.height == tinfo.height);
-                assert(info.depth == tinfo.depth);
-                assert(info.arraySize == tinfo.arraySize);
-                assert(info.mipLevels == tinfo.mipLevels);
-                assert(info.miscFlags == tinfo.miscFlags);
-                assert(info.dimension == tinfo.dimension);
-
-                image.swap(timage);
+                info.miscFlags2 = image->GetMetadata().miscFlags2;
                 cimage.reset();
             }
         }
 
+        if (memStats)
+            memStats->EndStage(L"demultiply");
+
         // --- Flip/Rotate -------------------------------------------------------------
         if (dwOptions & ((UINT64_C(1) << OPT_HFLIP) | (UINT64_C(1) << OPT_VFLIP)))
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
             TEX_FR_FLAGS dwFlags = TEX_FR_ROTATE0;
 
             if (dwOptions & (UINT64_C(1) << OPT_HFLIP))
@@ -2447,14 +2665,29 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
             assert(dwFlags != 0);
 
-            hr = FlipRotate(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFlags, *timage);
+            hr = FlipRotate(*image, dwFlags);
+            if (hr == HRESULT_E_NOT_SUPPORTED)
+            {
+                std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+                if (!timage)
+                {
+                    wprintf(L"\nERROR: Memory allocation failed\n");
+                    return 1;
+                }
+
+                hr = FlipRotate(image->GetImages(), image->GetImageCount(), image->GetMetadata(), dwFlags, *timage);
+                if (SUCCEEDED(hr))
+                {
+                    image.swap(timage);
+                }
+            }
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [fliprotate] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
                 return 1;
             }
 
-            auto& tinfo = timage->GetMetadata();
+            auto& tinfo = image->GetMetadata();
 
             info.width = tinfo.width;
             info.height = tinfo.height;
@@ -2466,10 +2699,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             assert(info.format == tinfo.format);
             assert(info.dimension == tinfo.dimension);
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"fliprotate");
+
         // --- Resize ------------------------------------------------------------------
         size_t twidth = (!width) ? info.width : width;
         if (twidth > maxSize)
@@ -2539,22 +2774,32 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
         }
 
+        if (memStats)
+            memStats->EndStage(L"resize");
+
+        // Per-pixel options are queued and applied in one pass once a later stage needs the pixels
+        PixelPipeline pixelOps;
+        auto applyPixelOps = [&]() -> bool
+            {
+                hr = pixelOps.Apply(*image, dwFilterOpts);
+                if (FAILED(hr))
+                {
+                    wprintf(L" FAILED [pixel ops] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
+                    return false;
+                }
+
+                return true;
+            };
+
         // --- Swizzle (if requested) --------------------------------------------------
         if (swizzleElements[0] != 0 || swizzleElements[1] != 1 || swizzleElements[2] != 2 || swizzleElements[3] != 3
             || zeroElements[0] != 0 || zeroElements[1] != 0 || zeroElements[2] != 0 || zeroElements[3] != 0
             || oneElements[0] != 0 || oneElements[1] != 0 || oneElements[2] != 0 || oneElements[3] != 0)
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
             const XMVECTOR zc = XMVectorSelectControl(zeroElements[0], zeroElements[1], zeroElements[2], zeroElements[3]);
             const XMVECTOR oc = XMVectorSelectControl(oneElements[0], oneElements[1], oneElements[2], oneElements[3]);
 
-            hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+            pixelOps.Add(
                 [&, zc, oc](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                 {
                     UNREFERENCED_PARAMETER(y);
@@ -2566,35 +2811,22 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                         pixel = XMVectorSelect(pixel, g_XMZero, zc);
                         outPixels[j] = XMVectorSelect(pixel, g_XMOne, oc);
                     }
-                }, *timage);
-            if (FAILED(hr))
-            {
-                wprintf(L" FAILED [swizzle] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
-            }
-
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
-
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
+                });
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"swizzle");
+
         // --- Color rotation (if requested) -------------------------------------------
         if (dwRotateColor)
         {
             if (dwRotateColor == ROTATE_HDR10_TO_709 || dwRotateColor == ROTATE_P3D65_TO_709)
             {
+                if (!applyPixelOps())
+                    return 1;
+
                 std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
                 if (!timage)
                 {
@@ -2629,17 +2861,10 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 cimage.reset();
             }
 
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
             switch (dwRotateColor)
             {
             case ROTATE_709_TO_HDR10:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2668,11 +2893,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_709_TO_2020:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2687,11 +2912,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_HDR10_TO_709:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2720,11 +2945,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_2020_TO_709:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2739,11 +2964,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_P3D65_TO_HDR10:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2772,11 +2997,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_P3D65_TO_2020:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2791,11 +3016,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_709_TO_P3D65:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2810,11 +3035,11 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             case ROTATE_P3D65_TO_709:
-                hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+                pixelOps.Add(
                     [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                     {
                         UNREFERENCED_PARAMETER(y);
@@ -2829,7 +3054,7 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                             outPixels[j] = value;
                         }
-                    }, *timage);
+                    });
                 break;
 
             default:
@@ -2843,32 +3068,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                 return 1;
             }
 
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
-
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
-
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"rotatecolor");
+
         // --- Tonemap (if requested) --------------------------------------------------
         if (dwOptions & UINT64_C(1) << OPT_TONEMAP)
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
+            if (!applyPixelOps())
                 return 1;
-            }
 
             // Compute max luminosity across all images
             XMVECTOR maxLum = XMVectorZero();
@@ -2898,8 +3108,8 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             // http://www.cs.utah.edu/~reinhard/cdrom/
             maxLum = XMVectorMultiply(maxLum, maxLum);
 
-            hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
-                [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
+            pixelOps.Add(
+                [&, maxLum](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                 {
                     UNREFERENCED_PARAMETER(y);
 
@@ -2916,33 +3126,20 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = value;
                     }
-                }, *timage);
-            if (FAILED(hr))
-            {
-                wprintf(L" FAILED [tonemap apply] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
-            }
-
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
-
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
+                });
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"tonemap");
+
         // --- Convert -----------------------------------------------------------------
         if (dwOptions & (UINT64_C(1) << OPT_NORMAL_MAP))
         {
+            if (!applyPixelOps())
+                return 1;
+
             std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
             if (!timage)
             {
@@ -2996,22 +3193,34 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
         }
         else if (info.format != tformat && !IsCompressed(tformat))
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
+            if (!applyPixelOps())
                 return 1;
-            }
 
-            hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
-                dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
+            // Formats with the same pitch (e.g. RGBA8 <-> BGRA8, R32 <-> RGBA8) convert in place
+            hr = Convert(*image, tformat, dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold);
+            if (hr == HRESULT_E_NOT_SUPPORTED)
+            {
+                std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
+                if (!timage)
+                {
+                    wprintf(L"\nERROR: Memory allocation failed\n");
+                    return 1;
+                }
+
+                hr = Convert(image->GetImages(), image->GetImageCount(), image->GetMetadata(), tformat,
+                    dwFilter | dwFilterOpts | dwSRGB | dwConvert, alphaThreshold, *timage);
+                if (SUCCEEDED(hr))
+                {
+                    image.swap(timage);
+                }
+            }
             if (FAILED(hr))
             {
                 wprintf(L" FAILED [convert] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
                 return 1;
             }
 
-            auto& tinfo = timage->GetMetadata();
+            auto& tinfo = image->GetMetadata();
 
             assert(tinfo.format == tformat);
             info.format = tinfo.format;
@@ -3024,25 +3233,20 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             assert(info.miscFlags == tinfo.miscFlags);
             assert(info.dimension == tinfo.dimension);
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"convert");
+
         // --- ColorKey/ChromaKey ------------------------------------------------------
         if ((dwOptions & (UINT64_C(1) << OPT_COLORKEY))
             && HasAlpha(info.format))
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
             XMVECTOR colorKeyValue = XMLoadColor(reinterpret_cast<const XMCOLOR*>(&colorKey));
 
-            hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
-                [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
+            pixelOps.Add(
+                [&, colorKeyValue](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                 {
                     static const XMVECTORF32 s_tolerance = { { { 0.2f, 0.2f, 0.2f, 0.f } } };
 
@@ -3063,41 +3267,18 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = value;
                     }
-                }, *timage);
-            if (FAILED(hr))
-            {
-                wprintf(L" FAILED [colorkey] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
-            }
-
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
-
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
+                });
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"colorkey");
+
         // --- Invert Y Channel --------------------------------------------------------
         if (dwOptions & (UINT64_C(1) << OPT_INVERT_Y))
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
-            hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
+            pixelOps.Add(
                 [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                 {
                     static const XMVECTORU32 s_selecty = { { { XM_SELECT_0, XM_SELECT_1, XM_SELECT_0, XM_SELECT_0 } } };
@@ -3112,44 +3293,21 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = XMVectorSelect(value, inverty, s_selecty);
                     }
-                }, *timage);
-            if (FAILED(hr))
-            {
-                wprintf(L" FAILED [inverty] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
-            }
-
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
-
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
+                });
 
-            image.swap(timage);
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"inverty");
+
         // --- Reconstruct Z Channel ---------------------------------------------------
         if (dwOptions & (UINT64_C(1) << OPT_RECONSTRUCT_Z))
         {
-            std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-            if (!timage)
-            {
-                wprintf(L"\nERROR: Memory allocation failed\n");
-                return 1;
-            }
-
             bool isunorm = (FormatDataType(info.format) == FORMAT_TYPE_UNORM) != 0;
 
-            hr = TransformImage(image->GetImages(), image->GetImageCount(), image->GetMetadata(),
-                [&](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
+            pixelOps.Add(
+                [&, isunorm](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
                 {
                     static const XMVECTORU32 s_selectz = { { { XM_SELECT_0, XM_SELECT_0, XM_SELECT_1, XM_SELECT_0 } } };
 
@@ -3173,28 +3331,19 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
                         outPixels[j] = XMVectorSelect(value, z, s_selectz);
                     }
-                }, *timage);
-            if (FAILED(hr))
-            {
-                wprintf(L" FAILED [reconstructz] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
-                return 1;
-            }
+                });
 
-        #ifndef NDEBUG
-            auto& tinfo = timage->GetMetadata();
-        #endif
+            cimage.reset();
+        }
 
-            assert(info.width == tinfo.width);
-            assert(info.height == tinfo.height);
-            assert(info.depth == tinfo.depth);
-            assert(info.arraySize == tinfo.arraySize);
-            assert(info.mipLevels == tinfo.mipLevels);
-            assert(info.miscFlags == tinfo.miscFlags);
-            assert(info.format == tinfo.format);
-            assert(info.dimension == tinfo.dimension);
+        if (memStats)
+            memStats->EndStage(L"reconstructz");
 
-            image.swap(timage);
-            cimage.reset();
+        // Mip generation and the alpha coverage test read the pixels, so apply the queued operations first
+        if (preserveAlphaCoverageRef > 0.0f || preserveAlphaCoverage || !tMips || info.mipLevels != tMips)
+        {
+            if (!applyPixelOps())
+                return 1;
         }
 
         // --- Determine whether preserve alpha coverage is required (if requested) ----
@@ -3398,6 +3547,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             cimage.reset();
         }
 
+        if (memStats)
+            memStats->EndStage(L"mips");
+
         // --- Premultiplied alpha (if requested) --------------------------------------
         if ((dwOptions & (UINT64_C(1) << OPT_PREMUL_ALPHA))
             && HasAlpha(info.format)
@@ -3407,20 +3559,32 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             {
                 printf("\nWARNING: Image is already using premultiplied alpha\n");
             }
-            else
+            else if (!IsSRGB(info.format) && !(dwSRGB & TEX_FILTER_SRGB))
             {
-                auto img = image->GetImage(0, 0, 0);
-                assert(img);
-                const size_t nimg = image->GetImageCount();
+                // Without sRGB conversion this is a plain per-pixel multiply, so it joins the queue
+                pixelOps.Add(
+                    [](XMVECTOR* outPixels, const XMVECTOR* inPixels, size_t w, size_t y)
+                    {
+                        UNREFERENCED_PARAMETER(y);
 
-                std::unique_ptr<ScratchImage> timage(new (std::nothrow) ScratchImage);
-                if (!timage)
-                {
-                    wprintf(L"\nERROR: Memory allocation failed\n");
+                        for (size_t j = 0; j < w; ++j)
+                        {
+                            const XMVECTOR value = inPixels[j];
+                            const XMVECTOR alpha = XMVectorMultiply(value, XMVectorSplatW(value));
+                            outPixels[j] = XMVectorSelect(value, alpha, g_XMSelect1110);
+                        }
+                    });
+
+                image->OverrideAlphaMode(TEX_ALPHA_MODE_PREMULTIPLIED);
+                info.miscFlags2 = image->GetMetadata().miscFlags2;
+                cimage.reset();
+            }
+            else
+            {
+                if (!applyPixelOps())
                     return 1;
-                }
 
-                hr = PremultiplyAlpha(img, nimg, info, TEX_PMALPHA_DEFAULT | dwSRGB, *timage);
+                hr = PremultiplyAlpha(*image, TEX_PMALPHA_DEFAULT | dwSRGB);
                 if (FAILED(hr))
                 {
                     wprintf(L" FAILED [premultiply alpha] (%08X%ls)\n", static_cast<unsigned int>(hr), GetErrorDesc(hr));
@@ -3428,22 +3592,17 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     continue;
                 }
 
-                auto& tinfo = timage->GetMetadata();
-                info.miscFlags2 = tinfo.miscFlags2;
-
-                assert(info.width == tinfo.width);
-                assert(info.height == tinfo.height);
-                assert(info.depth == tinfo.depth);
-                assert(info.arraySize == tinfo.arraySize);
-                assert(info.mipLevels == tinfo.mipLevels);
-                assert(info.miscFlags == tinfo.miscFlags);
-                assert(info.dimension == tinfo.dimension);
-
-                image.swap(timage);
+                info.miscFlags2 = image->GetMetadata().miscFlags2;
                 cimage.reset();
             }
         }
 
+        if (!applyPixelOps())
+            return 1;
+
+        if (memStats)
+            memStats->EndStage(L"premultiply");
+
         // --- Compress ----------------------------------------------------------------
         if (FileType == CODEC_DDS)
         {
@@ -3587,12 +3746,10 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     }
 
                     TEX_COMPRESS_FLAGS cflags = dwCompress;
-                #ifdef _OPENMP
                     if (!(dwOptions & (UINT64_C(1) << OPT_FORCE_SINGLEPROC)))
                     {
                         cflags |= TEX_COMPRESS_PARALLEL;
                     }
-                #endif
 
                     if ((img->width % 4) != 0 || (img->height % 4) != 0)
                     {
@@ -3605,7 +3762,13 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
                     }
                     else
                     {
-                        hr = Compress(img, nimg, info, tformat, cflags | dwSRGB, alphaThreshold, *timage);
+                        CompressOptions options = {};
+                        options.flags = cflags | dwSRGB;
+                        options.threshold = alphaThreshold;
+                        options.rdoLambda = rdoLambda;
+                        options.blockCache = blockCache.get();
+
+                        hr = CompressEx(img, nimg, info, tformat, options, *timage);
                     }
                     if (FAILED(hr))
                     {
@@ -3632,6 +3795,9 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
 
         cimage.reset();
 
+        if (memStats)
+            memStats->EndStage(L"compress");
+
         // --- Set alpha mode ----------------------------------------------------------
         if (HasAlpha(info.format)
             && info.format != DXGI_FORMAT_A8_UNORM)
@@ -3911,6 +4077,12 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
             }
             wprintf(L"\n");
         }
+
+        if (memStats)
+        {
+            memStats->EndStage(L"save");
+            memStats->Print();
+        }
     }
 
     if (sizewarn)
@@ -3927,6 +4099,24 @@ int __cdecl wmain(_In_ int argc, _In_z_count_(argc) wchar_t* argv[])
     if (non4bc)
         wprintf(L"\nWARNING: Direct3D requires BC image to be multiple of 4 in width & height\n");
 
+    if (blockCache)
+    {
+        const BlockCacheStats stats = blockCache->GetStats();
+        const uint64_t lookups = stats.hits + stats.misses;
+        wprintf(L"\n Block cache: %llu of %llu blocks reused (%.1f%%), %zu cached\n",
+            static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(lookups),
+            lookups ? 100.0 * double(stats.hits) / double(lookups) : 0.0,
+            blockCache->GetBlockCount());
+
+        hr = blockCache->SaveToFile(blockCacheFile.c_str());
+        if (FAILED(hr))
+        {
+            wprintf(L"\nERROR: Failed to write block cache %ls (%08X%ls)\n",
+                blockCacheFile.c_str(), static_cast<unsigned int>(hr), GetErrorDesc(hr));
+            retVal = 1;
+        }
+    }
+
     if (dwOptions & (UINT64_C(1) << OPT_TIMING))
     {
         LARGE_INTEGER qpcEnd = {};
@@ -11,6 +11,22 @@ const UINT indexCount = 36;
 MVP mvpData[objectCount];
 
 bool Renderer::initialize(HWND hwnd) {
+    // 텍스처 파일 읽기/디코딩을 디바이스 생성과 겹치도록 먼저 시작
+    if (SUCCEEDED(textureLoader.Initialize())) {
+        const HRESULT hr = textureLoader.Submit(L"textures/texture.png", 0,
+            [this](size_t, HRESULT hr, DirectX::ScratchImage& image) {
+                textureLoadResult = hr;
+                if (SUCCEEDED(hr))
+                    textureImage = std::move(image);
+            });
+        // 제출 실패 시 콜백이 호출되지 않으므로 결과를 직접 기록
+        if (FAILED(hr))
+            textureLoadResult = hr;
+    }
+    else {
+        textureLoadResult = DirectX::LoadFromWICFile(L"textures/texture.png", DirectX::WIC_FLAGS_NONE, nullptr, textureImage);
+    }
+
 #if defined(_DEBUG)
     {
         Microsoft::WRL::ComPtr<ID3D12Debug> debugController;
@@ -132,10 +148,12 @@ bool Renderer::initialize(HWND hwnd) {
 bool Renderer::createTexture() {
     using namespace DirectX;
 
-    // 1. 텍스처 로딩
-    ScratchImage image;
-    HRESULT hr = LoadFromWICFile(L"textures/texture.png", WIC_FLAGS_NONE, nullptr, image);
-    if (FAILED(hr)) {
+    // 1. 텍스처 로딩 (initialize에서 시작한 비동기 로딩 완료 대기)
+    textureLoader.Wait();
+    textureLoader.Release();
+
+    ScratchImage image = std::move(textureImage);
+    if (FAILED(textureLoadResult)) {
         MessageBox(nullptr, L"텍스처 로드 실패", L"Error", MB_OK);
         return false;
     }
@@ -5,6 +5,7 @@
 #include <dxgi1_6.h>
 #include <wrl.h>
 #include <DirectXMath.h>
+#include <DirectXTex.h>
 
 using namespace DirectX;
 
@@ -77,6 +78,11 @@ private:
     // 텍스처
     Microsoft::WRL::ComPtr<ID3D12Resource> texture;
 
+    // 텍스처 비동기 로딩 (initialize 시작 시 요청, createTexture에서 대기)
+    DirectX::ScratchImage textureImage;
+    HRESULT textureLoadResult = E_PENDING;
+    DirectX::BatchLoader textureLoader;
+
     // 샘플러
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> samplerHeap;
     D3D12_GPU_DESCRIPTOR_HANDLE samplerGpuHandle = {};